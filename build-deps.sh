@@ -46,6 +46,7 @@ else
                 --disable-static --enable-shared \
                 --enable-avcodec --enable-avformat --enable-avutil --enable-swresample \
                 --enable-decoder=adpcm_adx --enable-parser=adx --enable-muxer=adx \
+                --enable-encoder=ffv1 --enable-muxer=matroska --enable-protocol=file \
                 --enable-pic \
                 --extra-cflags="-fPIC" \
                 --extra-ldflags="-Wl,-rpath,@loader_path/../Frameworks" \
@@ -58,6 +59,7 @@ else
                 --disable-static --enable-shared \
                 --enable-avcodec --enable-avformat --enable-avutil --enable-swresample \
                 --enable-decoder=adpcm_adx --enable-parser=adx --enable-muxer=adx \
+                --enable-encoder=ffv1 --enable-muxer=matroska --enable-protocol=file \
                 --enable-pic \
                 --extra-cflags="-fPIC" \
                 --extra-ldflags="-Wl,-rpath,\$ORIGIN/../lib" \
@@ -70,6 +72,7 @@ else
                 --disable-static --enable-shared \
                 --enable-avcodec --enable-avformat --enable-avutil --enable-swresample \
                 --enable-decoder=adpcm_adx --enable-parser=adx --enable-muxer=adx \
+                --enable-encoder=ffv1 --enable-muxer=matroska --enable-protocol=file \
                 --extra-cflags="-I/mingw64/include" \
                 --extra-ldflags="-L/mingw64/lib"
             ;;
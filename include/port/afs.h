@@ -0,0 +1,45 @@
+#ifndef PORT_AFS_H
+#define PORT_AFS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Access to SF33RD.AFS in the resources folder. Kept free of SDL types so game code can use it.
+
+/// @brief Map the archive read-only and shared. Reads are served from the mapping afterwards, and
+/// processes forked from this one share it. Not available on Windows.
+/// @return `false` if the archive couldn't be mapped. Reads still work, from the file.
+bool AFS_Map();
+
+/// @brief Unmap the archive and close the file.
+void AFS_Close();
+
+/// @brief Read `size` bytes of the archive starting at `offset`.
+/// @return Number of bytes read, less than `size` at the end of the archive or on error.
+size_t AFS_Read(size_t offset, void* buffer, size_t size);
+
+/// @brief Read the table of contents from the archive header and check it against `appFileSizes`.
+/// @return `false` if the header can't be read or doesn't describe the archive the game expects.
+bool AFS_LoadIndex();
+
+/// @brief Read the table of contents and then the given files on a thread, in order. Index lookups
+/// wait for the table of contents, and reads of a listed file wait for that file and are copied from
+/// memory. Does nothing if the archive is mapped.
+void AFS_StartPrefetch(const int* file_ids, int count);
+
+/// @brief Wait for the prefetch thread, log how much of its time the caller didn't have to wait for
+/// and free the prefetched files. Reads go to the archive again afterwards.
+void AFS_FinishPrefetch();
+
+/// @brief Get a hash of the table of contents, 0 if it isn't loaded. Changes with the archive.
+uint64_t AFS_GetIndexHash();
+
+/// @brief Get the size of a file in the archive, 0 if there is no such file.
+size_t AFS_GetFileSize(int file_id);
+
+/// @brief Read `size` bytes of a file in the archive starting at `offset` within that file.
+/// @return Number of bytes read, less than `size` at the end of the file or on error.
+size_t AFS_ReadFile(int file_id, size_t offset, void* buffer, size_t size);
+
+#endif
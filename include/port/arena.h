@@ -0,0 +1,25 @@
+#ifndef PORT_ARENA_H
+#define PORT_ARENA_H
+
+#include <stddef.h>
+
+// Sizes of the game's fixed memory arenas. Each is an `arena_<name>_kb` setting and defaults to
+// the size the PS2 version uses. RAMCNT gets whatever the heap has left after the others. Kept free
+// of SDL types so game code can use it.
+
+typedef enum ArenaId {
+    ARENA_HEAP,   // Everything below comes out of this one allocation
+    ARENA_SYSMEM, // AcrSDK system memory: textures, palettes, DMA queues
+    ARENA_SEQS,   // Sprite chips of a frame, see MTRANS.c
+    ARENA_PPG,    // PPG texture and palette work memory
+    ARENA_ZLIB,   // zlib decompression state
+    ARENA_COUNT,
+} ArenaId;
+
+/// @brief Size of `arena` in bytes, from the settings.
+size_t Arena_GetSize(ArenaId arena);
+
+/// @brief Name of `arena` as used in settings and reports.
+const char* Arena_GetName(ArenaId arena);
+
+#endif
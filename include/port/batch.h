@@ -0,0 +1,21 @@
+#ifndef PORT_BATCH_H
+#define PORT_BATCH_H
+
+#include <stdbool.h>
+
+// Multi-process batch runner, used by the `3sx_batch` target. See batch.c.
+
+/// @brief Parse the command line and map the AFS. Call before `SDLApp_Init`.
+/// @return `false` if the batch can't run.
+bool Batch_Init(int argc, char* argv[]);
+
+bool Batch_IsRunning();
+
+/// @brief Fork the workers from the initialized game. Call right after `game_init`.
+/// Returns in the workers only. The runner waits for all jobs, prints the report and exits.
+void Batch_RunWorkers();
+
+/// @brief Send the result of the finished job to the runner and end the worker. Doesn't return.
+void Batch_Quit();
+
+#endif
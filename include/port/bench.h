@@ -0,0 +1,59 @@
+#ifndef PORT_BENCH_H
+#define PORT_BENCH_H
+
+#include "port/state_hash.h"
+
+#include <stdbool.h>
+
+// Headless replay benchmark, used by the `3sx_bench` target.
+
+typedef enum BenchPhase {
+    BENCH_PHASE_EVENTS,  // Event polling and frame setup
+    BENCH_PHASE_INPUT,   // Pad reading and conversion
+    BENCH_PHASE_GAME,    // njUserMain
+    BENCH_PHASE_DRAW,    // Sprite, BG and text submission
+    BENCH_PHASE_AHEAD,   // Frames run ahead, see run_ahead.h
+    BENCH_PHASE_PRESENT, // Sound, CRI interrupts and rendering
+    BENCH_PHASE_VBLANK,  // game_step_1
+    BENCH_PHASE_HASH,    // State checksum, not counted as simulation time
+    BENCH_PHASE_COUNT,
+} BenchPhase;
+
+typedef struct BenchResult {
+    Uint32 frames;
+    Uint64 chain;
+    StateHash final;
+} BenchResult;
+
+/// @brief Parse the command line and load the input log. Call before `SDLApp_Init`.
+/// @return `false` if the benchmark can't run.
+bool Bench_Init(int argc, char* argv[]);
+
+/// @brief Make SDL run without a visible window or audio output. Call before `SDLApp_Init`.
+void Bench_SetHeadless();
+
+/// @brief `true` once `Bench_SetHeadless` was called. Headless runs are uncapped and never go online.
+bool Bench_IsHeadless();
+
+/// @brief Start playing the input log at `log_path` uncapped, hashing every frame.
+bool Bench_Start(const char* log_path);
+
+/// @brief Get the frame count and checksums of the run so far.
+void Bench_GetResult(BenchResult* res);
+
+/// @brief Print the report and check the golden values.
+/// @return Process exit code.
+int Bench_Quit();
+
+bool Bench_IsRunning();
+
+void Bench_BeginFrame();
+
+/// @brief Attribute the time since the previous mark to `phase`.
+void Bench_Mark(BenchPhase phase);
+
+/// @brief Hash the state of the finished frame.
+/// @return `true` if there are frames left to run.
+bool Bench_EndFrame();
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef PORT_CHARSET_CACHE_H
+#define PORT_CHARSET_CACHE_H
+
+#include "structs.h"
+
+#include <stdbool.h>
+
+/// @brief Whether character scripts run through the pre-decoded cache (config `charset_predecode`).
+bool CharsetCache_IsEnabled();
+
+/// @brief Run the character script of `wk` from `wk->cg_ix` up to the next pattern or
+/// a command that stops it. Same effect as the loop in `check_cm_extended_code`.
+void CharsetCache_Run(WORK* wk);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef PORT_CONFIG_H
+#define PORT_CONFIG_H
+
+#include <stdbool.h>
+
+// Port settings are read from `config.ini` in the pref directory (one `key = value` per line,
+// `#` starts a comment). Every key can be overridden with an environment variable named
+// `SF3SX_<KEY>`, where `<KEY>` is the key in upper case.
+
+/// @brief Get a string setting.
+/// @return Value of the setting, or `default_value` if it's not set. The returned string is owned by the config.
+const char* Config_GetString(const char* key, const char* default_value);
+
+int Config_GetInt(const char* key, int default_value);
+double Config_GetFloat(const char* key, double default_value);
+
+/// @brief Get a boolean setting. `1`, `true`, `yes` and `on` are treated as `true`.
+bool Config_GetBool(const char* key, bool default_value);
+
+/// @brief Get a file path setting. Bare file names are resolved against the pref directory.
+/// @return Path to be freed with `SDL_free`, or `NULL` if the setting is not set or empty.
+char* Config_GetPath(const char* key);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef PORT_GYM_H
+#define PORT_GYM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Training and evaluation environment for the CPU AI, built as the `3sx_gym` shared library.
+// The game is process-global, so a process runs one environment. See gym.c.
+
+/// @brief Step input that lets the game's CPU AI play that side for the frame.
+#define GYM_INPUT_CPU 0xFFFF
+
+// Step input bits. Same layout as the game's switch words (`p1sw_0`)
+#define GYM_INPUT_UP 0x0001
+#define GYM_INPUT_DOWN 0x0002
+#define GYM_INPUT_LEFT 0x0004
+#define GYM_INPUT_RIGHT 0x0008
+#define GYM_INPUT_LP 0x0010
+#define GYM_INPUT_MP 0x0020
+#define GYM_INPUT_HP 0x0040
+#define GYM_INPUT_LK 0x0100
+#define GYM_INPUT_MK 0x0200
+#define GYM_INPUT_HK 0x0400
+
+typedef struct GymPlayer {
+    int16_t x;
+    int16_t y;
+    int16_t vitality;
+    int16_t stun;
+    int16_t stun_max;
+    int16_t super_gauge;
+    int16_t super_stocks;
+    int16_t routine[4];   // `routine_no` of the character, its current action
+    uint16_t pattern;     // Animation pattern (`cg_number`)
+    uint8_t kind_of_waza; // Kind of the current move
+    int8_t facing;        // `rl_flag`
+    bool is_cpu;
+} GymPlayer;
+
+typedef struct GymObservation {
+    uint32_t frame; // Frames since the round started
+    int16_t timer;  // Round timer
+    int8_t winner;  // Winning side once the round is over, -1 before
+    bool done;
+    GymPlayer players[2];
+} GymObservation;
+
+/// @brief Start a round. Initializes the game on the first call, which takes a few seconds.
+/// @param char1 Character of player 1, 0-19.
+/// @param char2 Character of player 2, 0-19.
+/// @param stage Stage, 0-21.
+/// @param seed Seed of the game's random numbers. The same seed and inputs replay the same round.
+/// @return `false` if the arguments are invalid or the game couldn't start.
+bool Gym_Reset(int char1, int char2, int stage, uint32_t seed, GymObservation* obs);
+
+/// @brief Run one frame. Once the round is over `obs->done` is set and the state no longer changes.
+/// @param p1_input `GYM_INPUT_*` bits for player 1, or `GYM_INPUT_CPU`.
+/// @param p2_input `GYM_INPUT_*` bits for player 2, or `GYM_INPUT_CPU`.
+/// @return `false` if no round was started.
+bool Gym_Step(uint16_t p1_input, uint16_t p2_input, GymObservation* obs);
+
+/// @brief Shut the game down. The environment can't be used again in this process.
+void Gym_Close();
+
+/// @brief Replace the pad switches read for this frame with the step inputs. Called by main.c.
+void Gym_ProcessSwitches();
+
+#endif
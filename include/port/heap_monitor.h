@@ -0,0 +1,26 @@
+#ifndef PORT_HEAP_MONITOR_H
+#define PORT_HEAP_MONITOR_H
+
+#include <stdbool.h>
+
+// Telemetry for the game's fixed memory arenas, an incremental compactor for system memory and a
+// footprint profile that suggests arena sizes. Kept free of SDL types so AcrSDK code can use it.
+// See heap_monitor.c.
+
+/// @brief Read the compactor and footprint profile settings. Call before `SDL_Init`.
+void HeapMonitor_Init();
+
+/// @brief Log the report and write it if `heap_report` is set.
+void HeapMonitor_Quit();
+
+/// @brief Call once per frame after the frame's DMA was sent. Updates the high-water marks, writes a
+/// requested report and, between rounds, compacts system memory for a bounded time.
+void HeapMonitor_EndFrame();
+
+/// @brief Write the report at the end of the frame.
+void HeapMonitor_RequestReport();
+
+/// @brief Write the report of all arenas as JSON, with arena sizes that fit the peaks so far.
+bool HeapMonitor_WriteReport(const char* path);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef PORT_INPUT_LOG_H
+#define PORT_INPUT_LOG_H
+
+#include "structs.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+// Log of the raw pad state read every frame, from boot on. Played back into the same build with the
+// same settings, it drives the game through exactly the same frames (menus, loading and matches alike).
+
+/// @brief Start recording to `input_record` if it's set and nothing is being played back.
+void InputLog_Init();
+
+/// @brief Flush and close the recording.
+void InputLog_Quit();
+
+/// @brief Replace live pad input with the log at `path`.
+/// @return `true` if the log was loaded.
+bool InputLog_StartPlayback(const char* path);
+
+/// @brief Record or replace the pad state of this frame. Call right after the pads were read.
+void InputLog_Process(TARPAD pads[2]);
+
+/// @brief Whether the pad state is being recorded to `input_record`.
+bool InputLog_IsRecording();
+
+/// @brief Whether a played back log has run out of frames.
+bool InputLog_IsPlaybackFinished();
+
+/// @brief Number of frames in the log being played back.
+Uint32 InputLog_GetPlaybackLength();
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef PORT_MEMCARD_H
+#define PORT_MEMCARD_H
+
+#include <stdbool.h>
+
+// Memory card in port 1, see sdk_libmc.c. Kept free of SDL types so game code can use it.
+
+/// @brief Whether there is a card in port 1. There is unless the `memcard` setting is off, the run is
+/// headless, an input log is being recorded or a netplay session is active.
+bool Memcard_IsInserted();
+
+/// @brief Whether a card command has been started and its result not yet collected with `sceMcSync`.
+bool Memcard_IsBusy();
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef PORT_NETPLAY_GAME_STATE_H
+#define PORT_NETPLAY_GAME_STATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Snapshot of the simulation state, for rolling back to an earlier frame. This header is included
+// by game code that can't see SDL types, hence the plain ones.
+
+/// @brief Size of a snapshot in bytes.
+size_t GameState_GetSize();
+
+/// @brief Copy the current state to `buffer`, which must hold `GameState_GetSize()` bytes.
+void GameState_Save(void* buffer);
+
+/// @brief Restore a state saved with `GameState_Save`.
+void GameState_Load(const void* buffer);
+
+/// @brief Mark the frames being run as speculative. They are thrown away by a later `GameState_Load`,
+/// so they must not be heard, consume logged input or be recorded.
+void GameState_SetSpeculative(bool speculative);
+
+bool GameState_IsSpeculative();
+
+/// @brief Tell that frames may be rolled back, which happens during netplay.
+void GameState_SetRollbackEnabled(bool enabled);
+
+/// @brief Whether the load queue has to wait instead of running this step. Loading isn't part of a
+/// snapshot, so the queue only runs on frames that won't be thrown away.
+/// @param has_new_request A request was made since the queue last ran.
+bool GameState_IsLoadQueueHeld(bool has_new_request);
+
+/// @brief Whether requests are waiting in the load queue. Frames that may be thrown away only run
+/// while there are none, or they would have to wait for them.
+bool GameState_IsLoading();
+
+/// @brief Whether a save screen is open or a card command is running. Like loading, neither is part of
+/// a snapshot, so frames that may be thrown away only run while this is false.
+bool GameState_IsSaving();
+
+/// @brief Hash of the current state, leaving out regions that hold pointers. Equal states give equal
+/// hashes in any process.
+uint64_t GameState_HashPlain();
+
+/// @brief Name of the global at `offset` in a snapshot, or `NULL` past its end.
+const char* GameState_GetRegionName(size_t offset);
+
+#endif
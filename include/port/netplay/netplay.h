@@ -0,0 +1,32 @@
+#ifndef PORT_NETPLAY_NETPLAY_H
+#define PORT_NETPLAY_NETPLAY_H
+
+#include "structs.h"
+
+#include <stdbool.h>
+
+// Rollback netplay session between two instances of the game.
+
+/// @brief Runs one frame of the simulation without presenting it.
+typedef void (*NetplaySimulateFrame)();
+
+/// @brief Start a session if `netplay_remote` is set.
+void Netplay_Init();
+
+/// @brief End the session and log its statistics.
+void Netplay_Quit();
+
+bool Netplay_IsActive();
+
+/// @brief Whether frames are being simulated again after a misprediction.
+bool Netplay_IsResimulating();
+
+/// @brief Exchange inputs with the peer, roll back and resimulate with `simulate` if a prediction was wrong.
+/// @return `true` if the next frame should run now, `false` if the session is waiting for the peer.
+bool Netplay_BeginFrame(NetplaySimulateFrame simulate);
+
+/// @brief Replace the pad state with the session inputs of the frame being simulated. Call right after the
+/// pads were read. The local player always uses the first pad.
+void Netplay_ProcessPads(TARPAD pads[2]);
+
+#endif
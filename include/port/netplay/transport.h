@@ -0,0 +1,31 @@
+#ifndef PORT_NETPLAY_TRANSPORT_H
+#define PORT_NETPLAY_TRANSPORT_H
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+// Connectionless datagram link to one peer, with optional simulated network conditions.
+
+#define TRANSPORT_PACKET_SIZE_MAX 1400
+
+typedef struct TransportConditions {
+    int latency_ms; // Added to every packet
+    int jitter_ms;  // Random extra delay of up to this much. Reorders packets
+    int loss;       // Percentage of packets dropped
+} TransportConditions;
+
+/// @brief Bind `local_port` and resolve `remote`, given as `host:port`.
+/// @return `false` if the socket couldn't be set up.
+bool Transport_Open(Uint16 local_port, const char* remote, const TransportConditions* conditions);
+
+void Transport_Close();
+
+/// @brief Send a packet, or queue it if there is simulated latency.
+void Transport_Send(const void* data, size_t size);
+
+/// @brief Read the next packet from the peer without blocking.
+/// @return Size of the packet, 0 if none is waiting.
+size_t Transport_Receive(void* buffer, size_t size);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef PORT_RUN_AHEAD_H
+#define PORT_RUN_AHEAD_H
+
+#include "structs.h"
+
+#include <stdbool.h>
+
+// Run-ahead hides the input lag that the game has built in. Every frame is run as usual but not
+// shown; the game then runs `run_ahead_frames` further with the same input, the last of these
+// frames is shown, and the state is put back to where the real frame left it.
+
+typedef void (*RunAheadStep)();
+
+/// @brief Read `run_ahead_frames`. Call after `Netplay_Init`, run-ahead is off during netplay.
+void RunAhead_Init();
+
+/// @brief Change the number of frames run ahead, clamped to what `run_ahead_frames` allows. Used by
+/// the run-ahead check of 3sx_bench.
+void RunAhead_SetFrames(int frames);
+
+int RunAhead_GetFrames();
+
+/// @brief Free the snapshot and log timing statistics.
+void RunAhead_Quit();
+
+/// @brief Hide the draws of the frame that is about to run. Call before `step_0`.
+void RunAhead_BeginFrame();
+
+/// @brief Run ahead from the middle of the current frame and restore the state afterwards.
+/// @param step_1 Finishes a frame (the vblank part).
+/// @param step_0 Runs the game part of the next frame and draws it.
+void RunAhead_EndFrame(RunAheadStep step_1, RunAheadStep step_0);
+
+/// @brief Give frames that run ahead the pad state of the real frame. Call right after the pads were read.
+void RunAhead_ProcessPads(TARPAD pads[2]);
+
+#endif
@@ -12,6 +12,11 @@ bool SDLApp_PollEvents();
 
 void SDLApp_BeginFrame();
 void SDLApp_EndFrame();
+
+/// @brief End a frame that was run with drawing turned off, without rendering or presenting it.
+/// Replaces both `SDLApp_BeginFrame` and `SDLApp_EndFrame`.
+void SDLApp_EndUndrawnFrame();
+
 void SDLApp_Exit();
 
 #endif
@@ -0,0 +1,22 @@
+#ifndef SDL_CAPTURE_H
+#define SDL_CAPTURE_H
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+void SDLCapture_Init(SDL_Renderer* renderer, int width, int height);
+void SDLCapture_Quit();
+
+/// @brief Save the next captured frame as a PNG.
+void SDLCapture_RequestScreenshot();
+
+void SDLCapture_ToggleRecording();
+bool SDLCapture_IsRecording();
+
+/// @brief Capture the contents of `canvas` if a screenshot or recording is in progress. Call once per
+/// frame right after `SDL_RenderPresent`. A captured frame waits for the GPU to finish it and is
+/// copied back, encoding happens on another thread.
+void SDLCapture_CaptureFrame(SDL_Texture* canvas);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef SDL_FRAME_PACER_H
+#define SDL_FRAME_PACER_H
+
+#include <SDL3/SDL.h>
+
+typedef struct SDLFramePacer_Stats {
+    Uint64 frames;
+    Uint64 late_frames;
+    double mean_ms;
+    double stddev_ms;
+    double min_ms;
+    double max_ms;
+    double p99_ms;
+
+    /// @brief How far the audio clock is ahead of the video clock, in ms.
+    double audio_drift_ms;
+
+    /// @brief Current pacing correction. Positive values speed the game up.
+    double rate_adjustment;
+} SDLFramePacer_Stats;
+
+void SDLFramePacer_Init(SDL_Renderer* renderer, double target_fps);
+
+/// @brief Wait until the next frame should start. Call this once per frame, after presenting.
+void SDLFramePacer_WaitForNextFrame();
+
+/// @brief Drop accumulated clock drift, e.g. after a long stall.
+void SDLFramePacer_Resync();
+
+void SDLFramePacer_GetStats(SDLFramePacer_Stats* stats);
+void SDLFramePacer_LogStats();
+
+#endif
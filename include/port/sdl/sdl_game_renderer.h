@@ -3,6 +3,8 @@
 
 #include <SDL3/SDL.h>
 
+#define SDL_GAME_RENDERER_LAYER_COUNT 3
+
 typedef struct SDLGameRenderer_Vec3 {
     float x;
     float y;
@@ -52,10 +54,32 @@ void SDLGameRenderer_UnlockTexture(unsigned int th);
 void SDLGameRenderer_CreatePalette(unsigned int ph);
 void SDLGameRenderer_DestroyPalette(unsigned int palette_handle);
 void SDLGameRenderer_UnlockPalette(unsigned int ph);
+
+/// @brief Point texture surfaces at their pixels again after system memory was compacted.
+void SDLGameRenderer_RelocateTextures();
+
+/// @brief Drop texture binds and draws while `false`, for frames that are simulated but not shown.
+void SDLGameRenderer_SetDrawEnabled(bool enabled);
+
 void SDLGameRenderer_SetTexture(unsigned int th);
 void SDLGameRenderer_DrawTexturedQuad(const SDLGameRenderer_Vertex* vertices);
 void SDLGameRenderer_DrawSolidQuad(const SDLGameRenderer_Vertex* vertices);
 void SDLGameRenderer_DrawSprite(const SDLGameRenderer_Sprite* sprite, unsigned int color);
 void SDLGameRenderer_DrawSprite2(const SDLGameRenderer_Sprite2* sprite2);
 
+// Background layers are persistent 1024x1024 render targets, one per BG plane, split into
+// 128x128 cells. Each cell is only redrawn when its contents change.
+
+bool SDLGameRenderer_IsLayerCacheEnabled();
+
+/// @brief Start drawing a cell of a background layer.
+/// @param key Identifies what is drawn in the cell. A different key forces a redraw.
+/// @return `true` if the cell has to be redrawn. Quads drawn until `SDLGameRenderer_EndLayerCell`
+/// then go to the cell, in coordinates relative to its top left corner. `false` if the cell is current.
+bool SDLGameRenderer_BeginLayerCell(int layer_index, int cell_x, int cell_y, Uint64 key);
+void SDLGameRenderer_EndLayerCell();
+
+/// @brief Draw a part of a background layer. Texture coordinates are relative to the whole layer.
+void SDLGameRenderer_DrawLayer(int layer_index, const SDLGameRenderer_Sprite* sprite);
+
 #endif
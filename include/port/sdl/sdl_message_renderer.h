@@ -8,7 +8,22 @@ extern SDL_Texture* message_canvas;
 void SDLMessageRenderer_Initialize(SDL_Renderer* renderer);
 void SDLMessageRenderer_BeginFrame();
 
-void SDLMessageRenderer_CreateTexture(int width, int height, void* pixels, int format);
+/// @brief Draw all glyphs queued this frame to `message_canvas`.
+void SDLMessageRenderer_Flush();
+
+/// @brief Forget all cached glyphs. Call when the font changes.
+void SDLMessageRenderer_ResetGlyphs();
+
+/// @brief Select the glyph that the next upload and draws refer to.
+/// @param key Font index of the glyph, unique within the current font.
+void SDLMessageRenderer_SetGlyph(unsigned int key);
+
+/// @brief Provide the 4bpp image of the current glyph. Ignored if the glyph is already cached.
+void SDLMessageRenderer_UploadGlyph(int width, int height, void* pixels);
+
+/// @brief Drop glyph draws while `false`, for frames that are simulated but not shown.
+void SDLMessageRenderer_SetDrawEnabled(bool enabled);
+
 void SDLMessageRenderer_DrawTexture(int x0, int y0, int x1, int y1, int u0, int v0, int u1, int v1, unsigned int color);
 
 #endif
@@ -25,12 +25,23 @@ typedef struct SDLPad_ButtonState {
 } SDLPad_ButtonState;
 
 void SDLPad_Init();
+void SDLPad_Quit();
 void SDLPad_HandleGamepadDeviceEvent(SDL_GamepadDeviceEvent* event);
 void SDLPad_HandleGamepadButtonEvent(SDL_GamepadButtonEvent* event);
 void SDLPad_HandleGamepadAxisMotionEvent(SDL_GamepadAxisEvent* event);
 void SDLPad_HandleKeyboardEvent(SDL_KeyboardEvent* event);
 bool SDLPad_IsGamepadConnected(int id);
+
+/// @brief Apply the input events that happened up to `deadline` to the state the game sees.
+void SDLPad_SampleFrame(Uint64 deadline);
+
+/// @brief Get the state as of the last sampling deadline.
 void SDLPad_GetButtonState(int id, SDLPad_ButtonState* state);
+
+/// @brief Record the press to present latency of the presses simulated this frame. Call after presenting.
+void SDLPad_NotePresented();
+
+void SDLPad_LogLatency();
 void SDLPad_RumblePad(int id, bool low_freq_enabled, Uint8 high_freq_rumble);
 
 #endif
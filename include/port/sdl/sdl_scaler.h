@@ -0,0 +1,36 @@
+#ifndef SDL_SCALER_H
+#define SDL_SCALER_H
+
+#include <SDL3/SDL.h>
+
+typedef enum SDLScaler_Mode {
+    /// @brief Bilinear filtering to the letterbox rect. Fills the window, but softer than the other
+    /// modes and the old 2x supersampled path.
+    SDL_SCALER_MODE_LINEAR,
+
+    /// @brief Largest whole multiple of the game height that fits, nearest filtering.
+    SDL_SCALER_MODE_INTEGER,
+
+    /// @brief Nearest prescale by a whole factor, then bilinear to the letterbox rect.
+    /// Crisp pixels without the uneven widths of plain nearest scaling. The default, as it looks closest
+    /// to the old 2x supersampled path.
+    SDL_SCALER_MODE_SHARP_BILINEAR,
+
+    SDL_SCALER_MODE_COUNT,
+} SDLScaler_Mode;
+
+void SDLScaler_Init(SDL_Renderer* renderer, float display_ratio);
+void SDLScaler_Quit();
+
+void SDLScaler_SetMode(SDLScaler_Mode mode);
+SDLScaler_Mode SDLScaler_GetMode();
+void SDLScaler_CycleMode();
+
+/// @brief Draw the game and message canvases to the backbuffer, letterboxed.
+void SDLScaler_Present(SDL_Texture* game_canvas, SDL_Texture* message_canvas);
+
+/// @brief Time every scaling mode, and the old 2x supersampled path, over `frames` frames
+/// and log GPU memory and pixels filled per frame for each.
+void SDLScaler_RunBenchmark(SDL_Texture* game_canvas, SDL_Texture* message_canvas, int frames);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef MIXER_H_
+#define MIXER_H_
+
+#include "common.h"
+
+#include <SDL3/SDL_audio.h>
+
+#include <stdbool.h>
+
+// The single audio output of the port. SE voices rendered by the SPU emulator and BGM decoded
+// from ADX are mixed into one buffer and written to one device stream.
+
+#define MIXER_SAMPLE_RATE 48000
+#define MIXER_CHANNELS 2
+
+typedef enum MixerBus {
+    MIXER_BUS_SE,
+    MIXER_BUS_BGM,
+    MIXER_BUS_COUNT,
+} MixerBus;
+
+void Mixer_Init();
+void Mixer_Exit();
+
+/// @brief Get the stream that feeds a bus. Producers put interleaved S16 stereo data into it.
+/// The SE bus has no stream, it is rendered by the SPU on demand.
+SDL_AudioStream* Mixer_GetBusStream(MixerBus bus);
+
+void Mixer_SetBusGain(MixerBus bus, float gain);
+void Mixer_SetBusPaused(MixerBus bus, bool paused);
+bool Mixer_IsBusPaused(MixerBus bus);
+
+/// @brief Get the number of sample frames handed to the audio device so far.
+/// The counter advances with the device clock and wraps around.
+u32 Mixer_GetPlayedSamples();
+
+/// @brief Stretch the output by `ratio` (1.0 = no change). Used for small pacing corrections.
+void Mixer_SetRateRatio(float ratio);
+
+/// @brief Stop or restart the audio device. While it is stopped the mixer callback doesn't run,
+/// so no audio lock is held, which is what the batch runner needs before it forks.
+void Mixer_PauseDevice(bool paused);
+
+#endif // MIXER_H_
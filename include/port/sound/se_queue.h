@@ -0,0 +1,22 @@
+#ifndef SE_QUEUE_H_
+#define SE_QUEUE_H_
+
+#include "common.h"
+
+// Sound effect requests made during a frame are queued and run together by `cseExecServer`,
+// with the audio thread held off once for the whole batch instead of once per voice. Identical
+// requests in one batch can be merged (`se_coalesce` setting), and every request of a frame range
+// can be written to a trace (`se_trace`, `se_trace_first`, `se_trace_last`).
+
+/// @brief Queue a TSB request. `rtpc` holds the 10 request arguments and is copied.
+void SEQueue_Push(u16 bank, u16 code, const s32* rtpc);
+
+/// @brief Run every queued request in the order they were made.
+void SEQueue_Flush();
+
+/// @brief Drop the queued requests. Used when all sounds are stopped, which would cut them anyway.
+void SEQueue_Clear();
+
+void SEQueue_Quit();
+
+#endif // SE_QUEUE_H_
@@ -15,6 +15,10 @@ extern SDL_Mutex* soundLock;
 void SPU_Init(void (*cb)());
 void SPU_Upload(u32 dst, void* src, u32 size);
 void SPU_Tick(s16* output);
+
+/// @brief Render `frames` interleaved stereo sample frames, running the sound driver timer as we go.
+void SPU_Render(s16* output, int frames);
+
 void SPU_VoiceStart(int vnum, u32 start_addr);
 void SPU_VoiceGetConf(int vnum, struct SPUVConf* conf);
 void SPU_VoiceSetConf(int vnum, struct SPUVConf* conf);
@@ -0,0 +1,23 @@
+#ifndef PORT_STARTUP_H
+#define PORT_STARTUP_H
+
+#include <stddef.h>
+
+// Timing report for game_init. Kept free of SDL types so game code can use it.
+
+/// @brief Start the clock. Call at the top of game_init.
+void Startup_Begin();
+
+/// @brief Start timing a part of game_init on the main thread. Ends the previous part.
+void Startup_BeginPhase(const char* name);
+
+/// @brief End the last part and log the timing report.
+void Startup_Finish();
+
+/// @brief Count bytes read from disk during the current part.
+void Startup_CountRead(size_t size);
+
+/// @brief Count bytes decompressed during the current part.
+void Startup_CountDecoded(size_t size);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef PORT_STATE_HASH_H
+#define PORT_STATE_HASH_H
+
+#include <SDL3/SDL.h>
+
+typedef enum StateHashRegion {
+    STATE_HASH_PLAYERS,
+    STATE_HASH_EFFECTS,
+    STATE_HASH_RANDOM,
+    STATE_HASH_HIT,
+    STATE_HASH_TIMERS,
+    STATE_HASH_BG,
+    STATE_HASH_GLOBALS, // Every snapshot region without pointers
+    STATE_HASH_WORK,    // Tasks, gauges, BG rewrites and command work
+    STATE_HASH_REGION_COUNT,
+} StateHashRegion;
+
+typedef struct StateHash {
+    Uint64 total;
+    Uint64 regions[STATE_HASH_REGION_COUNT];
+} StateHash;
+
+/// @brief Open the per-frame log if `state_hash_log` is set.
+void StateHash_Init();
+void StateHash_Quit();
+
+/// @brief Hash the simulation state as it is now.
+void StateHash_Compute(StateHash* hash);
+
+/// @brief Fold `hash` into a running hash of many frames.
+Uint64 StateHash_Chain(Uint64 chain, const StateHash* hash);
+
+/// @brief Call once per game frame. Logs the hash of the frame if logging is on.
+void StateHash_EndFrame();
+
+/// @brief Number of frames passed to `StateHash_EndFrame` so far.
+Uint32 StateHash_GetFrame();
+
+/// @return First region that differs between `a` and `b`, or `-1` if they are equal.
+int StateHash_FindDivergence(const StateHash* a, const StateHash* b);
+
+const char* StateHash_GetRegionName(StateHashRegion region);
+
+/// @brief xxHash64 of any buffer, for content keys outside the simulation state.
+Uint64 StateHash_HashBytes(const void* data, size_t size, Uint64 seed);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef PORT_TEXTURE_CACHE_H
+#define PORT_TEXTURE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// On-disk cache of decoded texture, palette and sprite data. Kept free of SDL types so game code
+// can use it.
+
+/// @brief Map and index the cache file. Happens on first use otherwise.
+void TextureCache_Open();
+
+/// @brief Make the key for data decoded from `src`.
+/// @param dst_size Size of the decoded data.
+/// @param variant Anything else the decoded data depends on, such as the pixel format.
+uint64_t TextureCache_MakeKey(const void* src, size_t src_size, size_t dst_size, uint32_t variant);
+
+/// @brief Find decoded data stored by an earlier run.
+/// @return Pointer to `size` bytes that stay valid until `TextureCache_Quit`, or `NULL`.
+const void* TextureCache_Find(uint64_t key, size_t size);
+
+/// @brief Store decoded data for later runs.
+void TextureCache_Store(uint64_t key, const void* data, size_t size);
+
+void TextureCache_Quit();
+
+#endif
@@ -6,6 +6,8 @@
 #include "types.h"
 
 extern MEM_BLOCK sysmemblock[4096];
+extern MEM_MGR sysmemmgr;
+extern s32 mflTemporaryUseMax;
 
 void mflInit(void* mem_ptr, s32 memsize, s32 memalign);
 u32 mflGetSpace();
@@ -16,5 +18,6 @@ void* mflTemporaryUse(s32 len);
 void* mflRetrieve(u32 handle);
 s32 mflRelease(u32 handle);
 void* mflCompact();
+u32 mflCompactStep();
 
 #endif
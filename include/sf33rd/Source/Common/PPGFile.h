@@ -7,6 +7,7 @@
 extern s16* dctex_linear; // size: 0x4, address: 0x57A950
 
 void ppg_Initialize(void* lcmAdrs, s32 lcmSize);
+_MEMMAN_OBJ* ppg_GetHeap();
 void ppgSourceDataReleased(PPGDataList* dlist);
 void ppgSetupCurrentDataList(PPGDataList* dlist);
 void ppgSetupCurrentPaletteNumber(Palette* pal, s32 num);
@@ -1,9 +1,11 @@
 #ifndef ZLIBAPP_H
 #define ZLIBAPP_H
 
+#include "structs.h"
 #include "types.h"
 
 void zlib_Initialize(void* tempAdrs, s32 tempSize);
+_MEMMAN_OBJ* zlib_GetHeap();
 ssize_t zlib_Decompress(void* srcBuff, s32 srcSize, void* dstBuff, s32 dstSize);
 
 #endif
@@ -4,6 +4,7 @@
 #include "structs.h"
 
 extern const u16 acatkoa_table[];
+extern u16 att_req;
 
 void setupCharTableData(WORK* wk, s32 clr, s32 info);
 void char_move_cmhs(PLW* wk);
@@ -4,6 +4,9 @@
 #include "structs.h"
 #include "types.h"
 
+extern s8 Lv;
+extern s8 Rnd;
+
 void End_Pattern(PLW* wk);
 void Next_Be_Passive(PLW* wk, s32);
 void Turn_Over_On(PLW* wk);
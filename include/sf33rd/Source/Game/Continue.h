@@ -3,6 +3,8 @@
 
 #include "types.h"
 
+extern u8 CONTINUE_X;
+
 s32 Continue_Scene();
 
 #endif
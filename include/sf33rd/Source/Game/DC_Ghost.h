@@ -13,6 +13,12 @@ void njSetBackColor(u32 c0, u32 c1, u32 c2);
 void njColorBlendingMode(s32 target, s32 mode);
 void njCalcPoint(MTX* mtx, Vec3* ps, Vec3* pd);
 void njCalcPoints(MTX* mtx, Vec3* ps, Vec3* pd, s32 num);
+
+#if !defined(TARGET_PS2)
+/// @brief Transform `num` points on the z = 0 plane, four at a time.
+/// Points are passed as separate x and y arrays. Only x and y of the result are computed.
+void njCalcPointsXY(MTX* mtx, const f32* xs, const f32* ys, f32* xd, f32* yd, s32 num);
+#endif
 void njRotateZ(s32 /* unused */, s32 /* unused */);
 void njDrawTexture(Polygon* polygon, s32 /* unused */, s32 tex, s32 /* unused */);
 void njDrawSprite(Polygon* polygon, s32 /* unused */, s32 tex, s32 /* unused */);
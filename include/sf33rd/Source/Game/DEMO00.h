@@ -3,6 +3,9 @@
 
 #include "types.h"
 
+extern s16 picon_no;
+extern f32 picon_level;
+
 s32 Warning();
 void Warning_Init();
 void Put_Warning(s16 type);
@@ -4,6 +4,8 @@
 #include "structs.h"
 #include "types.h"
 
+extern s16 chk77_flag;
+
 void effect_77_move(WORK_Other* ewk);
 s32 effect_77_init(u8 /* unused */, u8 data);
 
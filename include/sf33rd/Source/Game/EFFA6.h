@@ -4,6 +4,13 @@
 #include "structs.h"
 #include "types.h"
 
+extern s16 effa6_pos_x_1p;
+extern s16 effa6_pos_y_1p;
+extern s16 effa6_pos_z_1p;
+extern s16 effa6_pos_x_2p;
+extern s16 effa6_pos_y_2p;
+extern s16 mmes_already;
+
 void effect_A6_move(WORK_Other_CONN* ewk);
 s32 effect_A6_init(WORK_Other* mwk);
 
@@ -4,6 +4,14 @@
 #include "structs.h"
 #include "types.h"
 
+extern s32* efff9_txt_no_adrs;
+extern u16* efff9_txt_scene_adrs;
+extern s16 efff9_suicide;
+extern s16 efff9_PL_NO;
+extern s16 efff9_txt_point;
+extern s16 efff9_message;
+extern s16 keep_mes_no;
+
 void effect_F9_move(WORK_Other* ewk);
 void effect_F9_init(s16 END_PL_NO);
 s32 Rewrite_End_Message(u16 mes_no);
@@ -4,6 +4,9 @@
 #include "structs.h"
 #include "types.h"
 
+extern s16 roll_rate_t;
+extern s16 roll_rate;
+
 void effect_H6_move(WORK_Other* ewk);
 s32 effect_H6_init(s16 timer, s8* str, s16 X, s16 Y, s16 Original_Color, s32 /* unused */);
 
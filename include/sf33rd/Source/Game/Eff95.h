@@ -4,6 +4,9 @@
 #include "structs.h"
 #include "types.h"
 
+extern s16 RND_95;
+extern s16 END_OF_95;
+
 void effect_95_move(WORK_Other* ewk);
 s32 effect_95_init(s16 vital_new);
 
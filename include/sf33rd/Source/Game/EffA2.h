@@ -4,6 +4,11 @@
 #include "structs.h"
 #include "types.h"
 
+extern const u8* hnc_pointer;
+extern u8 hnc_timer;
+extern u8 hnc_end_timer;
+extern u8 hnc_col;
+
 void effect_A2_move(WORK_Other* ewk);
 s32 effect_A2_init();
 
@@ -5,6 +5,9 @@
 #include "types.h"
 
 extern const u8 Coin_Message_Data[7][2];
+extern u8 letter_stack[40];
+extern u8 letter_counter;
+extern u8* letter_ptr;
 
 void Entry_Task(struct _TASK*);
 s32 Ck_Break_Into(u16 Sw_0, u16 Sw_1, s16 PL_id);
@@ -5,6 +5,10 @@
 #include "types.h"
 
 extern s16 plt_req[2];
+extern REQ q_ldreq[16];
+extern u8 ldreq_result[294];
+extern u8 ldreq_break;
+extern u8 ldreq_pushed;
 extern const u8 lpr_wrdata[3];
 extern const u8 lpt_seldat[4];
 
@@ -9,5 +9,7 @@ void Before_Select_Sub();
 void Game_Task(struct _TASK* task_ptr);
 void Game01_Sub();
 void Next_Title_Sub();
+void Next_Demo_Loop();
+void Loop_Demo_Sub();
 
 #endif
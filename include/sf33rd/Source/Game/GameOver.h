@@ -3,6 +3,8 @@
 
 #include "types.h"
 
+extern u8 GAME_OVER_X;
+
 s16 Game_Over();
 
 #endif
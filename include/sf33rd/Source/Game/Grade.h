@@ -9,6 +9,8 @@ extern JudgeCom judge_com[2];
 
 extern GradeFinalData judge_final[2][2]; // size: 0x2B0, address: 0x5E3070
 extern GradeData judge_item[2][2];       // size: 0x130, address: 0x5E3320
+extern s16 last_judge_dada[2][5];
+extern u8 ji_sat[2][384];
 
 void grade_check_work_1st_init(s16 ix, s16 ix2);
 void grade_check_work_stage_init(s16 ix);
@@ -30,6 +30,11 @@ extern HS hs[32];
 
 extern WORK* q_hit_push[32];
 extern s8 ca_check_flag; // size: 0x1, address: 0x5790F4
+extern s16 grdb[2][2][2];
+extern s16 grdb2[2][2];
+extern s16* dmdat_adrs[16];
+extern s16 mkm_wk[32];
+extern s16 hpq_in;
 
 void make_red_blocking_time(s16 id, s16 ix, s16 num);
 void hit_check_main_process();
@@ -5,6 +5,7 @@
 #include "types.h"
 
 extern f32 PrioBase[128]; // size: 0x200, address: 0x5E3F50
+extern SpriteChipSet seqs_w;
 
 void appSetupBasePriority();
 void appSetupTempPriority();
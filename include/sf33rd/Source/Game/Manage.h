@@ -4,6 +4,7 @@
 #include "types.h"
 
 extern u8 Disp_Bonus_Contents;
+extern s8 MANAGE_X;
 
 s32 Game_Management();
 s32 Wait_Seek_Time();
@@ -3,6 +3,9 @@
 
 #include "types.h"
 
+extern u8 SEL_CPU_X;
+extern s16 Start_X;
+
 s8 Check_Bonus_Stage();
 s16 Next_CPU();
 s32 After_Bonus();
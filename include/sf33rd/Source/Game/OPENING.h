@@ -9,6 +9,14 @@ extern s8 op_scrn_end;
 extern s16 title_tex_flag; // size: 0x2, address: 0x579464
 extern s16 op_timer0;      // size: 0x2, address: 0x579468
 extern OP_W op_w;
+extern s16 music_scene;
+extern s16 music_time;
+extern s16 op_plmove_timer;
+extern OPBW* opw_ptr;
+extern s16 op_end_flag;
+extern s16 op_demo_index;
+extern s16 op_sound_status;
+extern MVXY op_bg_mvxy[3];
 
 void TITLE_Init();
 s16 TITLE_Move(u16 type);
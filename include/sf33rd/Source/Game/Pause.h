@@ -7,5 +7,8 @@
 void dispControllerWasRemovedMessage(s32 x, s32 y, s32 step);
 
 extern void Pause_Task(struct _TASK*);
+extern u8 PAUSE_X;
+extern u8 Stock_Turbo_Timer;
+extern u8 Stock_Process_Counter;
 
 #endif
@@ -10,6 +10,7 @@
 extern s16 vib_req[2][2];
 extern u8 pulpul_scene;
 extern PPWORK ppwork[2]; // size: 0x68, address: 0x579610
+extern PUL pul[2];
 extern PULREQ pulreq[];
 extern PULPARA pulpara[];
 
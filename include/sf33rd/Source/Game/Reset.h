@@ -5,6 +5,7 @@
 #include "types.h"
 
 extern u8 Reset_Status[2];
+extern u8 RESET_X;
 
 void Reset_Task(struct _TASK* task_ptr);
 u8 nowSoftReset();
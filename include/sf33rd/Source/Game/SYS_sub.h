@@ -5,6 +5,7 @@
 #include "types.h"
 
 extern const struct _SAVE_W Game_Default_Data; // size: 0x208, address: 0x5544C0
+extern u8 Candidate_Buff[16];
 
 void Switch_Screen_Init(s32 /* unused */);         // Range: 0x3A1C50 -> 0x3A1C98
 s32 Switch_Screen(u8 Wipe_Type);                   // Range: 0x3A1CA0 -> 0x3A1D08
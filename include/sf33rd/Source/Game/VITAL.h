@@ -4,6 +4,8 @@
 #include "structs.h"
 #include "types.h"
 
+extern VIT vit[2];
+
 void vital_cont_init();
 void vital_cont_main();
 void vital_control(u8 pl);
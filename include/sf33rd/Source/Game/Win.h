@@ -3,6 +3,8 @@
 
 #include "types.h"
 
+extern u8 WIN_X;
+
 s32 Winner_Scene();
 s32 Loser_Scene();
 
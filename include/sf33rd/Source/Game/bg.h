@@ -10,6 +10,21 @@ extern u16 Screen_Switch;        // size: 0x2, address: 0x578B64
 
 extern BG bg_w; // size: 0x428, address: 0x595830
 extern u8 bg_disp_off;
+extern u8 bg_priority[4];
+extern u8 rw_num;
+extern u8 rw_bg_flag[4];
+extern u8 tokusyu_stage;
+extern s32 rw_gbix[13];
+extern s8 stage_flash;
+extern s8 stage_ftimer;
+extern s32 yang_ix_plus;
+extern s8 yang_ix;
+extern s8 yang_timer;
+extern u8 ending_flag;
+extern BackgroundParameters end_prm[8];
+extern u8 gouki_end_gbix[16];
+extern const u32* rw3col_ptr;
+extern RW_DATA rw_dat[20];
 
 void Bg_TexInit();
 void Bg_Kakikae_Set();
@@ -1,6 +1,7 @@
 #ifndef CMB_WIN_H
 #define CMB_WIN_H
 
+#include "structs.h"
 #include "types.h"
 
 extern const u8 cmb_pos_tbl[2][21];
@@ -25,6 +26,7 @@ extern s8 rever_attack[2];
 extern s8 first_attack;
 extern s8 cmb_stock[2];
 extern s16 old_cmb_flag[2];
+extern CMST_BUFF cmst_buff[2][5];
 
 void combo_cont_init();
 void combo_cont_main();
@@ -5,6 +5,14 @@
 #include "types.h"
 
 extern Round_Timer round_timer;
+extern s8 flash_timer;
+extern s8 flash_r_num;
+extern s8 flash_col;
+extern s8 math_counter_hi;
+extern s8 math_counter_low;
+extern u8 counter_color;
+extern s8 mugen_flag;
+extern s8 hoji_counter;
 
 void count_cont_init(u8 type);
 void count_cont_main();
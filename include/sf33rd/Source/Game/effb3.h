@@ -4,6 +4,8 @@
 #include "structs.h"
 #include "types.h"
 
+extern WORK_Other* oya_adrs;
+
 void effect_B3_move(WORK_Other* ewk);
 s32 effect_B3_init(WORK_Other* oya);
 
@@ -4,6 +4,8 @@
 #include "structs.h"
 #include "types.h"
 
+extern WORK_Other* oya_p;
+
 void effect_B9_move(WORK_Other* ewk);
 s32 effect_B9_init(WORK_Other* oya);
 
@@ -4,6 +4,8 @@
 #include "structs.h"
 #include "types.h"
 
+extern u32 spmv_ng_save[2];
+
 void effect_L8_move(WORK_Other* ewk);
 s32 effect_L8_init(PLW* wk);
 void check_new_color_data_L8(WORK* wk);
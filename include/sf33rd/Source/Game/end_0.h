@@ -7,6 +7,8 @@ extern s16 gill_quake_flag2;
 extern s16 end_0_1_time[];
 
 extern const s16 gill_time[];
+extern u8 fade_prio;
+extern s16 gill_quake_flag;
 
 void end_00000(s16 pl_num);
 
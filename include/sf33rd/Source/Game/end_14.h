@@ -4,6 +4,8 @@
 #include "structs.h"
 #include "types.h"
 
+extern END14_XY gxy;
+
 void end_14000(s16 pl_num);
 
 #endif
@@ -3,6 +3,10 @@
 
 #include "types.h"
 
+extern s8 bdl_index;
+extern s8 wr5_index;
+extern s16 end_5_flag;
+
 void end_05000(s16 pl_num);
 
 #endif
@@ -4,6 +4,9 @@
 #include "structs.h"
 #include "types.h"
 
+extern f32 Keep_Zoom_X;
+extern s8 Test_Cursor;
+
 void Init_Task(struct _TASK* task_ptr);
 
 #endif
@@ -20,6 +20,11 @@ extern s32 system_init_level;
 
 bool get_game_initialized();
 
+#if defined(SF3SX_GYM)
+/// @brief Run one frame of the main loop without drawing it. The gym library has no `main`, see port/gym.c.
+void main_run_gym_frame();
+#endif
+
 void cpInitTask();
 void cpReadyTask(u16 num, void* func_adrs);
 void cpExitTask(u16 num);
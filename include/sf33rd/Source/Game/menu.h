@@ -4,8 +4,13 @@
 #include "structs.h"
 #include "types.h"
 
+extern u8 r_no_plus;
+extern u8 control_player;
+extern u8 control_pl_rno;
+
 void Menu_Task(struct _TASK* task_ptr);
 void Menu_Init(struct _TASK* task_ptr);
+void Setup_VS_Mode(struct _TASK* task_ptr);
 void Setup_Pad_or_Stick();
 u16 Check_Menu_Lever(u8 PL_id, s16 type);
 void Menu_Common_Init();
@@ -7,6 +7,17 @@
 extern RANK_NAME_W rank_name_w[2]; // size: 0x8, address: 0x5792E8
 extern s16 Name_00[2];             // size: 0x4, address: 0x579374
 extern NAME_WK name_wk[2];         // size: 0x64, address: 0x579390
+extern NAME_WK* name_ptr;
+extern s16 Name_Input_f;
+extern s16 naming_cnt[2];
+extern s16 n_disp_flag;
+extern s16 name_limit_timer[2];
+extern u8 ne_flash_flag;
+extern const u8* ne_pointer;
+extern u8 ne_col;
+extern u8 ne_timer;
+extern SC_NAME_WK sc_name_wk[2][4];
+extern SC_NAME_WK* nsc_ptr;
 
 s16 Name_Input(s16 pl_id);
 
@@ -4,6 +4,8 @@
 #include "structs.h"
 #include "types.h"
 
+extern s8 stop_count[2];
+
 void pl14_extra_attack(PLW* wk);
 
 #endif
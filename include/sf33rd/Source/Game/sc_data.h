@@ -37,6 +37,6 @@ extern const u32 bigger_col_tbl[][4];
 extern const u16 Training_combo_pos_tbl[];
 extern const u16 Training_combo_prio_tbl[];
 
-extern TrainingData2 tr_data[];
+extern TrainingData2 tr_data[2];
 
 #endif
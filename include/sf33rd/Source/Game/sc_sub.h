@@ -1,8 +1,14 @@
 #ifndef SC_SUB_H
 #define SC_SUB_H
 
+#include "structs.h"
 #include "types.h"
 
+extern u8 WipeLimit;
+extern u8 FadeLimit;
+extern s16 Hnc_Num;
+extern FadeData fd_dat;
+
 void Scrscreen_Init();
 void Sa_frame_Clear();
 void Sa_frame_Clear2(u8 pl);
@@ -4,6 +4,11 @@
 #include "types.h"
 
 extern s16 Play_Type_1st;
+extern u8 SEL_PL_X;
+extern u16 Color7[2];
+extern u8 Decide_Stage;
+extern u8 hc3alpha;
+extern u8 hc3alphaadd;
 
 s16 Select_Player();
 
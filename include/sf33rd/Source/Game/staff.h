@@ -5,6 +5,10 @@
 
 extern s16 roll_rate2;
 extern s16 roll_rate_t2;
+extern s16 roll_stop;
+extern s16 name_timer;
+extern s32 staffroll_end;
+extern s16 staff_name_ptr;
 
 s32 staff_credits(u32 /* unused */);
 
@@ -1,8 +1,11 @@
 #ifndef STUN_H
 #define STUN_H
 
+#include "structs.h"
 #include "types.h"
 
+extern SDAT sdat[2];
+
 void stngauge_cont_init();
 void stngauge_cont_main();
 void stngauge_control(u8 pl);
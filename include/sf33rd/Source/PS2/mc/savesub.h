@@ -117,5 +117,6 @@ typedef struct _replay_data {
 
 void SaveInit(s32 file_type, s32 save_mode);
 s32 SaveMove();
+s32 SaveIsOpen();
 
 #endif
@@ -2959,4 +2959,48 @@ typedef struct {
     s16 chix; // offset 0x6, size 0x2
 } GillEffData;
 
+typedef struct {
+    // total size: 0x34
+    const u16* spgtbl_ptr;  // offset 0x0, size 0x4
+    const u16* spgptbl_ptr; // offset 0x4, size 0x4
+    s16 current_spg;        // offset 0x8, size 0x2
+    s16 old_spg;            // offset 0xA, size 0x2
+    s16 spgcol_number;      // offset 0xC, size 0x2
+    s16 spg_level;          // offset 0xE, size 0x2
+    s16 spg_maxlevel;       // offset 0x10, size 0x2
+    s16 spg_len;            // offset 0x12, size 0x2
+    s16 spg_dotlen;         // offset 0x14, size 0x2
+    s16 flag;               // offset 0x16, size 0x2
+    s16 flag2;              // offset 0x18, size 0x2
+    s16 level_flag;         // offset 0x1A, size 0x2
+    s16 timer;              // offset 0x1C, size 0x2
+    s16 timer2;             // offset 0x1E, size 0x2
+    s8 kind;                // offset 0x20, size 0x1
+    s8 max;                 // offset 0x21, size 0x1
+    s8 max_old;             // offset 0x22, size 0x1
+    s8 max_rno;             // offset 0x23, size 0x1
+    s8 time;                // offset 0x24, size 0x1
+    s8 time_rno;            // offset 0x25, size 0x1
+    s16 gauge_flash_time;   // offset 0x26, size 0x2
+    s16 gauge_flash_col;    // offset 0x28, size 0x2
+    u16 mchar;              // offset 0x2A, size 0x2
+    u16 mass_len;           // offset 0x2C, size 0x2
+    s8 sa_flag;             // offset 0x2E, size 0x1
+    s8 ex_flag;             // offset 0x2F, size 0x1
+    s8 no_chgcol;           // offset 0x30, size 0x1
+    s8 time_no_clear;       // offset 0x31, size 0x1
+    s8 sa_mukou;            // offset 0x32, size 0x1
+} SPG_DAT;
+
+typedef struct {
+    // total size: 0x6
+    s16 fade;      // offset 0x0, size 0x2
+    s16 fade_kind; // offset 0x2, size 0x2
+    u8 fade_prio;  // offset 0x4, size 0x1
+} FadeData;
+
+typedef struct {
+    XY xy[2];
+} END14_XY;
+
 #endif
@@ -0,0 +1,485 @@
+// pread and mmap need a newer POSIX level than the rest of the port
+#undef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "port/afs.h"
+#include "port/resources.h"
+#include "port/startup.h"
+#include "port/state_hash.h"
+#include "sf33rd/Source/Common/FileSizeAFS.h"
+
+#include <SDL3/SDL.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// SF33RD.AFS access.
+//
+// An AFS archive starts with "AFS\0", a file count and an (offset, size) pair per file. The pairs
+// are read once into `toc`, so a file read is a single positional read at a known offset instead
+// of a trip through the ADXF partition, CVFS and sector emulation layers.
+//
+// The file stays open for the whole run and is read with pread, which doesn't share a file
+// position, so processes forked by the batch runner can read it at the same time. The batch
+// runner maps it instead: the mapping is shared and read-only, so every worker reads the same
+// page cache pages and nothing of the archive is copied per process. Windows has neither and
+// reads through an SDL stream.
+//
+// At startup the table of contents and the files game_init and the first frame load are read
+// ahead on a thread (`AFS_StartPrefetch`), in the order the game asks for them. The game only
+// waits for the part it asks for, so the reads overlap game_init's work that doesn't touch the
+// archive, and a prefetched file is copied from memory. The batch runner maps the archive and
+// skips this, it has no reads to hide and forks right after game_init.
+
+#define AFS_MAGIC "AFS"
+#define AFS_HEADER_SIZE 8
+#define AFS_ENTRY_SIZE 8
+#define PREFETCH_FILES_MAX 16
+
+typedef struct AFSEntry {
+    Uint32 offset;
+    Uint32 size;
+} AFSEntry;
+
+typedef struct PrefetchedFile {
+    int file_id;
+    Uint8* data;
+    size_t size;
+} PrefetchedFile;
+
+static AFSEntry toc[AFS_FILE_COUNT];
+static Uint64 toc_hash = 0;
+static bool is_toc_loaded = false;
+
+static const Uint8* mapping = NULL;
+static size_t mapping_size = 0;
+
+// The prefetch thread reads the archive while the main thread may too
+static SDL_SpinLock file_lock = 0;
+
+static SDL_Thread* prefetch_thread = NULL;
+static SDL_Mutex* prefetch_mutex = NULL;
+static SDL_Condition* prefetch_condition = NULL;
+static PrefetchedFile prefetched[PREFETCH_FILES_MAX];
+static int prefetched_count = 0;
+static int prefetch_done = 0; // The table of contents counts as the first one
+static Uint64 prefetch_start = 0;
+static Uint64 prefetch_end = 0;
+static Uint64 prefetch_wait_ns = 0;
+static size_t prefetch_bytes = 0;
+
+#if defined(_WIN32)
+static SDL_IOStream* afs_io = NULL;
+#else
+static int afs_fd = -1;
+#endif
+
+bool AFS_Map() {
+#if defined(_WIN32)
+    return false;
+#else
+    AFS_FinishPrefetch();
+
+    if (mapping != NULL) {
+        return true;
+    }
+
+    char* path = Resources_GetPath("SF33RD.AFS");
+    const int fd = open(path, O_RDONLY);
+    struct stat info;
+
+    if ((fd < 0) || (fstat(fd, &info) != 0) || (info.st_size <= 0)) {
+        SDL_Log("Couldn't open %s for mapping", path);
+
+        if (fd >= 0) {
+            close(fd);
+        }
+
+        SDL_free(path);
+        return false;
+    }
+
+    void* address = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+
+    if (address == MAP_FAILED) {
+        SDL_Log("Couldn't map %s", path);
+        SDL_free(path);
+        return false;
+    }
+
+    SDL_free(path);
+    mapping = address;
+    mapping_size = info.st_size;
+    return true;
+#endif
+}
+
+void AFS_Close() {
+    AFS_FinishPrefetch();
+
+#if defined(_WIN32)
+    if (afs_io != NULL) {
+        SDL_CloseIO(afs_io);
+        afs_io = NULL;
+    }
+#else
+    if (mapping != NULL) {
+        munmap((void*)mapping, mapping_size);
+        mapping = NULL;
+        mapping_size = 0;
+    }
+
+    if (afs_fd >= 0) {
+        close(afs_fd);
+        afs_fd = -1;
+    }
+#endif
+
+    is_toc_loaded = false;
+}
+
+static size_t read_mapped(size_t offset, void* buffer, size_t size) {
+    if (offset >= mapping_size) {
+        return 0;
+    }
+
+    size = SDL_min(size, mapping_size - offset);
+    SDL_memcpy(buffer, mapping + offset, size);
+    return size;
+}
+
+static bool open_file() {
+#if defined(_WIN32)
+    if (afs_io != NULL) {
+        return true;
+    }
+
+    char* path = Resources_GetPath("SF33RD.AFS");
+    afs_io = SDL_IOFromFile(path, "rb");
+
+    if (afs_io == NULL) {
+        SDL_Log("Couldn't open %s: %s", path, SDL_GetError());
+    }
+
+    SDL_free(path);
+    return afs_io != NULL;
+#else
+    if (afs_fd >= 0) {
+        return true;
+    }
+
+    char* path = Resources_GetPath("SF33RD.AFS");
+    afs_fd = open(path, O_RDONLY);
+
+    if (afs_fd < 0) {
+        SDL_Log("Couldn't open %s", path);
+    }
+
+    SDL_free(path);
+    return afs_fd >= 0;
+#endif
+}
+
+static size_t read_file(size_t offset, void* buffer, size_t size) {
+#if defined(_WIN32)
+    // One stream with one position, so reads take turns
+    size_t done = 0;
+    SDL_LockSpinlock(&file_lock);
+
+    if (open_file() && (SDL_SeekIO(afs_io, offset, SDL_IO_SEEK_SET) >= 0)) {
+        done = SDL_ReadIO(afs_io, buffer, size);
+    }
+
+    SDL_UnlockSpinlock(&file_lock);
+    return done;
+#else
+    SDL_LockSpinlock(&file_lock);
+    const bool is_open = open_file();
+    SDL_UnlockSpinlock(&file_lock);
+
+    if (!is_open) {
+        return 0;
+    }
+
+    size_t done = 0;
+
+    while (done < size) {
+        const ssize_t result = pread(afs_fd, (Uint8*)buffer + done, size - done, offset + done);
+
+        if (result <= 0) {
+            break;
+        }
+
+        done += result;
+    }
+
+    return done;
+#endif
+}
+
+size_t AFS_Read(size_t offset, void* buffer, size_t size) {
+    const size_t read = (mapping != NULL) ? read_mapped(offset, buffer, size) : read_file(offset, buffer, size);
+    Startup_CountRead(read);
+    return read;
+}
+
+// Index
+
+static Uint32 read_u32(const Uint8* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((Uint32)data[3] << 24);
+}
+
+typedef size_t (*ReadFunc)(size_t offset, void* buffer, size_t size);
+
+static bool load_index(ReadFunc read) {
+    Uint8 header[AFS_HEADER_SIZE];
+
+    if ((read(0, header, sizeof(header)) != sizeof(header)) || (SDL_memcmp(header, AFS_MAGIC, 4) != 0)) {
+        SDL_Log("SF33RD.AFS is not an AFS archive");
+        return false;
+    }
+
+    const Uint32 file_count = read_u32(&header[4]);
+
+    if (file_count < AFS_FILE_COUNT) {
+        SDL_Log("SF33RD.AFS has %u files, expected %d", file_count, AFS_FILE_COUNT);
+        return false;
+    }
+
+    const size_t entries_size = AFS_FILE_COUNT * AFS_ENTRY_SIZE;
+    Uint8* entries = SDL_malloc(entries_size);
+
+    if (read(AFS_HEADER_SIZE, entries, entries_size) != entries_size) {
+        SDL_Log("SF33RD.AFS table of contents is truncated");
+        SDL_free(entries);
+        return false;
+    }
+
+    int mismatches = 0;
+
+    for (int i = 0; i < AFS_FILE_COUNT; i++) {
+        toc[i].offset = read_u32(&entries[i * AFS_ENTRY_SIZE]);
+        toc[i].size = read_u32(&entries[i * AFS_ENTRY_SIZE + 4]);
+
+        // Files the game never loads have no size in the table
+        if ((appFileSizes[i] != 0) && (toc[i].size != (Uint32)appFileSizes[i])) {
+            if (mismatches == 0) {
+                SDL_Log("SF33RD.AFS file %d is %u bytes, expected %d", i, toc[i].size, appFileSizes[i]);
+            }
+
+            mismatches += 1;
+        }
+    }
+
+    toc_hash = StateHash_HashBytes(entries, entries_size, file_count);
+    SDL_free(entries);
+
+    if (mismatches > 0) {
+        SDL_Log("SF33RD.AFS doesn't match the game (%d files differ)", mismatches);
+        return false;
+    }
+
+    is_toc_loaded = true;
+    return true;
+}
+
+// Prefetch
+
+/// @brief Block until the prefetch thread has read `count` items, the table of contents being the
+/// first one.
+static void wait_for_prefetch(int count) {
+    if (prefetch_thread == NULL) {
+        return;
+    }
+
+    const Uint64 start = SDL_GetTicksNS();
+    SDL_LockMutex(prefetch_mutex);
+
+    while (prefetch_done < count) {
+        SDL_WaitCondition(prefetch_condition, prefetch_mutex);
+    }
+
+    SDL_UnlockMutex(prefetch_mutex);
+    prefetch_wait_ns += SDL_GetTicksNS() - start;
+}
+
+static void finish_prefetch_item() {
+    SDL_LockMutex(prefetch_mutex);
+    prefetch_done += 1;
+    SDL_BroadcastCondition(prefetch_condition);
+    SDL_UnlockMutex(prefetch_mutex);
+}
+
+static int prefetch_main(void* /* unused */) {
+    // A failure is reported when the main thread loads the index again
+    const bool has_index = load_index(read_file);
+    finish_prefetch_item();
+
+    for (int i = 0; i < prefetched_count; i++) {
+        PrefetchedFile* file = &prefetched[i];
+
+        if (has_index && (file->file_id >= 0) && (file->file_id < AFS_FILE_COUNT)) {
+            const AFSEntry* entry = &toc[file->file_id];
+            file->data = SDL_malloc(SDL_max(entry->size, 1));
+
+            if ((file->data != NULL) && (read_file(entry->offset, file->data, entry->size) == entry->size)) {
+                file->size = entry->size;
+                prefetch_bytes += entry->size;
+            } else {
+                // The game reads it from the archive itself then
+                SDL_free(file->data);
+                file->data = NULL;
+            }
+        }
+
+        finish_prefetch_item();
+    }
+
+    prefetch_end = SDL_GetTicksNS();
+    return 0;
+}
+
+/// @return Index of `file_id` in `prefetched`, or -1 if it isn't prefetched.
+static int find_prefetched(int file_id) {
+    if (prefetch_thread == NULL) {
+        return -1;
+    }
+
+    for (int i = 0; i < prefetched_count; i++) {
+        if (prefetched[i].file_id == file_id) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void AFS_StartPrefetch(const int* file_ids, int count) {
+    if ((mapping != NULL) || (prefetch_thread != NULL) || is_toc_loaded) {
+        return;
+    }
+
+    prefetched_count = SDL_min(count, PREFETCH_FILES_MAX);
+
+    for (int i = 0; i < prefetched_count; i++) {
+        prefetched[i].file_id = file_ids[i];
+        prefetched[i].data = NULL;
+        prefetched[i].size = 0;
+    }
+
+    prefetch_done = 0;
+    prefetch_wait_ns = 0;
+    prefetch_bytes = 0;
+    prefetch_mutex = SDL_CreateMutex();
+    prefetch_condition = SDL_CreateCondition();
+    prefetch_start = SDL_GetTicksNS();
+
+    if ((prefetch_mutex != NULL) && (prefetch_condition != NULL)) {
+        prefetch_thread = SDL_CreateThread(prefetch_main, "afs prefetch", NULL);
+    }
+
+    if (prefetch_thread == NULL) {
+        SDL_Log("Couldn't start the AFS prefetch, reading on demand: %s", SDL_GetError());
+        SDL_DestroyCondition(prefetch_condition);
+        SDL_DestroyMutex(prefetch_mutex);
+        prefetch_condition = NULL;
+        prefetch_mutex = NULL;
+        prefetched_count = 0;
+    }
+}
+
+void AFS_FinishPrefetch() {
+    if (prefetch_thread == NULL) {
+        return;
+    }
+
+    const Uint64 start = SDL_GetTicksNS();
+    SDL_WaitThread(prefetch_thread, NULL);
+    prefetch_thread = NULL;
+    prefetch_wait_ns += SDL_GetTicksNS() - start;
+
+    // Whatever the main thread didn't wait for ran next to it
+    const Uint64 run_ns = prefetch_end - prefetch_start;
+    const Uint64 saved_ns = (run_ns > prefetch_wait_ns) ? (run_ns - prefetch_wait_ns) : 0;
+
+    SDL_Log("Startup: prefetched the AFS index and %d files (%.1f KB) in %.1f ms, waited %.1f ms for them, "
+            "%.1f ms saved",
+            prefetched_count,
+            (double)prefetch_bytes / 1024,
+            (double)run_ns / SDL_NS_PER_MS,
+            (double)prefetch_wait_ns / SDL_NS_PER_MS,
+            (double)saved_ns / SDL_NS_PER_MS);
+
+    for (int i = 0; i < prefetched_count; i++) {
+        SDL_free(prefetched[i].data);
+        prefetched[i].data = NULL;
+    }
+
+    prefetched_count = 0;
+    SDL_DestroyCondition(prefetch_condition);
+    SDL_DestroyMutex(prefetch_mutex);
+    prefetch_condition = NULL;
+    prefetch_mutex = NULL;
+}
+
+// Files
+
+bool AFS_LoadIndex() {
+    wait_for_prefetch(1);
+
+    if (is_toc_loaded) {
+        return true;
+    }
+
+    return load_index(AFS_Read);
+}
+
+uint64_t AFS_GetIndexHash() {
+    wait_for_prefetch(1);
+    return is_toc_loaded ? toc_hash : 0;
+}
+
+size_t AFS_GetFileSize(int file_id) {
+    wait_for_prefetch(1);
+
+    if (!is_toc_loaded || (file_id < 0) || (file_id >= AFS_FILE_COUNT)) {
+        return 0;
+    }
+
+    return toc[file_id].size;
+}
+
+size_t AFS_ReadFile(int file_id, size_t offset, void* buffer, size_t size) {
+    const int index = find_prefetched(file_id);
+
+    if (index >= 0) {
+        wait_for_prefetch(index + 2);
+        const PrefetchedFile* file = &prefetched[index];
+
+        if (file->data != NULL) {
+            if (offset >= file->size) {
+                return 0;
+            }
+
+            size = SDL_min(size, file->size - offset);
+            SDL_memcpy(buffer, file->data + offset, size);
+            return size;
+        }
+    }
+
+    const size_t file_size = AFS_GetFileSize(file_id);
+
+    if (offset >= file_size) {
+        return 0;
+    }
+
+    size = SDL_min(size, file_size - offset);
+    return AFS_Read((size_t)toc[file_id].offset + offset, buffer, size);
+}
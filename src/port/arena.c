@@ -0,0 +1,81 @@
+#include "port/arena.h"
+#include "port/config.h"
+
+#include <SDL3/SDL.h>
+
+// Arena sizes.
+//
+// The PS2 version splits 24 MiB between its arenas by hand. Here every size is a setting in KiB,
+// so a host that packs many instances can shrink them and one that sees eviction churn can grow
+// them. The footprint profile (see heap_monitor.c) prints settings that fit what a run used.
+//
+// Sizes are read once, before the heap is set up, and never change afterwards. A heap too small
+// for the other arenas plus a minimal RAMCNT is grown to fit, since RAMCNT would be negative.
+
+#define KIB 1024
+#define RAMCNT_SIZE_MIN (1024 * KIB)
+#define HEAP_SLACK (4 * KIB) // Alignment of the arenas carved out of the heap
+
+typedef struct ArenaInfo {
+    const char* name;
+    size_t default_size;
+} ArenaInfo;
+
+static const ArenaInfo arenas[ARENA_COUNT] = {
+    [ARENA_HEAP] = { "heap", 0x1800000 },
+    [ARENA_SYSMEM] = { "sysmem", 0xA00000 },
+    [ARENA_SEQS] = { "seqs", 0xD000 },
+    [ARENA_PPG] = { "ppg", 0x60000 },
+    [ARENA_ZLIB] = { "zlib", 0x10000 },
+};
+
+static size_t sizes[ARENA_COUNT] = { 0 };
+static bool is_resolved = false;
+
+static size_t read_size(ArenaId arena) {
+    char key[32];
+    const int default_kb = arenas[arena].default_size / KIB;
+
+    SDL_snprintf(key, sizeof(key), "arena_%s_kb", arenas[arena].name);
+    const int kb = Config_GetInt(key, default_kb);
+
+    if (kb <= 0) {
+        SDL_Log("Invalid %s %d, using %d", key, kb, default_kb);
+        return arenas[arena].default_size;
+    }
+
+    return (size_t)kb * KIB;
+}
+
+static void resolve() {
+    size_t others = 0;
+
+    for (int i = 0; i < ARENA_COUNT; i++) {
+        sizes[i] = read_size(i);
+
+        if (i != ARENA_HEAP) {
+            others += sizes[i];
+        }
+    }
+
+    const size_t heap_min = others + RAMCNT_SIZE_MIN + HEAP_SLACK;
+
+    if (sizes[ARENA_HEAP] < heap_min) {
+        SDL_Log("Heap of %zu KiB can't hold the other arenas, using %zu KiB", sizes[ARENA_HEAP] / KIB, heap_min / KIB);
+        sizes[ARENA_HEAP] = heap_min;
+    }
+
+    is_resolved = true;
+}
+
+size_t Arena_GetSize(ArenaId arena) {
+    if (!is_resolved) {
+        resolve();
+    }
+
+    return sizes[arena];
+}
+
+const char* Arena_GetName(ArenaId arena) {
+    return arenas[arena].name;
+}
@@ -0,0 +1,351 @@
+#include "port/batch.h"
+#include "common.h"
+#include "port/afs.h"
+#include "port/bench.h"
+#include "port/resources.h"
+#include "port/sdl/sdl_app.h"
+#include "port/sound/mixer.h"
+#include "sf33rd/Source/Game/PLCNT.h"
+#include "sf33rd/Source/Game/WORK_SYS.h"
+#include "sf33rd/Source/Game/workuser.h"
+#include "structs.h"
+
+#include <SDL3/SDL.h>
+
+#if !defined(_WIN32)
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Batch runner.
+//
+// All game state is process-global, so parallel matches need separate processes. Instead of
+// starting each of them from scratch, the runner initializes the game once with the AFS mapped
+// shared, then forks a worker per job from that image. Workers share the archive pages and all
+// data loaded by game_init copy-on-write.
+//
+// Workers still play their input log from boot, through the menus and character select. They
+// can't be forked from a match in progress: an input log only makes sense from the first frame,
+// jobs play different logs, and the game seeds its RNG from the frames counted since boot
+// (system_timer) when a game starts, so a job's seed has to be in place before the menus run.
+// What forking saves is mapping the AFS and game_init, not the way to the match.
+//
+// A job is one input log played headless the same way 3sx_bench plays it, optionally with a
+// seed written into system_timer (the game seeds its RNG from it). Each worker sends a fixed-size
+// record back over its own pipe; the record is smaller than PIPE_BUF, so it arrives in one piece.
+// At most `--workers` jobs run at a time.
+//
+// The audio device is stopped before forking, so no worker inherits a held audio lock. Workers
+// have no audio thread and leave with _exit, without touching SDL again.
+
+#define WORKERS_MAX 64
+
+typedef struct BatchRecord {
+    Uint32 frames;
+    Uint64 chain;
+    Uint64 final;
+    Uint64 wall_ns;
+    Sint8 winner;
+    Uint8 wins[2];
+    Sint16 vital[2];
+} BatchRecord;
+
+#if defined(_WIN32)
+
+bool Batch_Init(int argc, char* argv[]) {
+    SDL_Log("3sx_batch needs fork() and isn't available on Windows");
+    return false;
+}
+
+bool Batch_IsRunning() {
+    return false;
+}
+
+void Batch_RunWorkers() {
+    // Do nothing
+}
+
+void Batch_Quit() {
+    // Do nothing
+}
+
+#else
+
+typedef struct Worker {
+    pid_t pid;
+    int fd;
+    int job;
+} Worker;
+
+static bool is_running = false;
+static char** log_paths = NULL;
+static int log_count = 0;
+static int worker_count = 0;
+static int repeat_count = 1;
+static bool has_seed = false;
+static Uint32 seed = 0;
+
+// Set in workers only
+static int job_index = -1;
+static int result_fd = -1;
+static Uint64 job_start_time = 0;
+
+static void print_usage() {
+    SDL_Log("Usage: 3sx_batch [--workers <n>] [--repeat <n>] [--seed <n>] <input log>...");
+}
+
+bool Batch_Init(int argc, char* argv[]) {
+    log_paths = SDL_malloc(sizeof(char*) * SDL_max(argc, 1));
+    worker_count = SDL_GetNumLogicalCPUCores();
+
+    for (int i = 1; i < argc; i++) {
+        if ((SDL_strcmp(argv[i], "--workers") == 0) && (i + 1 < argc)) {
+            worker_count = SDL_atoi(argv[++i]);
+        } else if ((SDL_strcmp(argv[i], "--repeat") == 0) && (i + 1 < argc)) {
+            repeat_count = SDL_atoi(argv[++i]);
+        } else if ((SDL_strcmp(argv[i], "--seed") == 0) && (i + 1 < argc)) {
+            seed = SDL_strtoul(argv[++i], NULL, 10);
+            has_seed = true;
+        } else if (argv[i][0] != '-') {
+            log_paths[log_count++] = argv[i];
+        } else {
+            print_usage();
+            return false;
+        }
+    }
+
+    if ((log_count == 0) || (repeat_count < 1)) {
+        print_usage();
+        return false;
+    }
+
+    worker_count = SDL_clamp(worker_count, 1, WORKERS_MAX);
+
+    if (!Resources_CheckIfPresent()) {
+        SDL_Log("Game resources are missing. Run 3sx once to set them up");
+        return false;
+    }
+
+    if (!AFS_Map()) {
+        return false;
+    }
+
+    Bench_SetHeadless();
+    is_running = true;
+    return true;
+}
+
+bool Batch_IsRunning() {
+    return is_running;
+}
+
+static Uint32 job_seed(int job) {
+    return seed + job;
+}
+
+static void become_worker(int job, int fd, const Worker* workers, int active) {
+    // Other workers' pipes belong to the runner
+    for (int i = 0; i < active; i++) {
+        close(workers[i].fd);
+    }
+
+    job_index = job;
+    result_fd = fd;
+
+    if (has_seed) {
+        system_timer = job_seed(job);
+    }
+
+    if (!Bench_Start(log_paths[job % log_count])) {
+        _exit(1);
+    }
+
+    job_start_time = SDL_GetTicksNS();
+}
+
+/// @return `false` if the worker couldn't be started. In the worker, `job_index` is set.
+static bool start_worker(Worker* workers, int active, int job) {
+    int fds[2];
+
+    if (pipe(fds) != 0) {
+        SDL_Log("Couldn't create a pipe for job %d", job);
+        return false;
+    }
+
+    const pid_t pid = fork();
+
+    if (pid < 0) {
+        SDL_Log("Couldn't fork a worker for job %d", job);
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        become_worker(job, fds[1], workers, active);
+        return true;
+    }
+
+    close(fds[1]);
+    workers[active].pid = pid;
+    workers[active].fd = fds[0];
+    workers[active].job = job;
+    return true;
+}
+
+/// @brief Wait for any worker to exit and collect its record.
+/// @return Index of the worker in `workers`, or -1 if there was nothing to wait for.
+static int wait_for_worker(const Worker* workers, int active, BatchRecord* records, bool* succeeded) {
+    int status = 0;
+    const pid_t pid = waitpid(-1, &status, 0);
+
+    if (pid < 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < active; i++) {
+        if (workers[i].pid != pid) {
+            continue;
+        }
+
+        BatchRecord* record = &records[workers[i].job];
+        const bool has_record = read(workers[i].fd, record, sizeof(*record)) == sizeof(*record);
+        succeeded[workers[i].job] = has_record && WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+        close(workers[i].fd);
+        return i;
+    }
+
+    // Not one of ours
+    return wait_for_worker(workers, active, records, succeeded);
+}
+
+static void print_report(const BatchRecord* records, const bool* succeeded, int job_count, Uint64 wall_ns) {
+    Uint64 total_frames = 0;
+    double worker_fps_sum = 0;
+    int failed = 0;
+
+    for (int job = 0; job < job_count; job++) {
+        const BatchRecord* record = &records[job];
+        const char* log_path = log_paths[job % log_count];
+
+        if (!succeeded[job]) {
+            SDL_Log("Job %d (%s): FAILED", job, log_path);
+            failed += 1;
+            continue;
+        }
+
+        const double fps = (record->wall_ns > 0) ? (double)record->frames * SDL_NS_PER_SECOND / record->wall_ns : 0.0;
+        total_frames += record->frames;
+        worker_fps_sum += fps;
+
+        SDL_Log("Job %d (%s, seed %u): %u frames, %.1f fps, winner %d, wins %u-%u, vitality %d-%d, "
+                "chain %016" SDL_PRIx64,
+                job,
+                log_path,
+                has_seed ? job_seed(job) : 0,
+                record->frames,
+                fps,
+                record->winner,
+                record->wins[0],
+                record->wins[1],
+                record->vital[0],
+                record->vital[1],
+                record->chain);
+    }
+
+    SDL_Log("%d jobs on %d workers, %d failed, wall time %.2f s",
+            job_count,
+            worker_count,
+            failed,
+            (double)wall_ns / SDL_NS_PER_SECOND);
+    SDL_Log("Throughput: %.1f frames/s total, %.1f frames/s per worker",
+            (wall_ns > 0) ? (double)total_frames * SDL_NS_PER_SECOND / wall_ns : 0.0,
+            (job_count > failed) ? worker_fps_sum / (job_count - failed) : 0.0);
+}
+
+void Batch_RunWorkers() {
+    if (!is_running || (job_index >= 0)) {
+        return;
+    }
+
+    const int job_count = log_count * repeat_count;
+    BatchRecord* records = SDL_calloc(job_count, sizeof(BatchRecord));
+    bool* succeeded = SDL_calloc(job_count, sizeof(bool));
+    Worker workers[WORKERS_MAX];
+    int active = 0;
+    int next_job = 0;
+    bool all_succeeded = true;
+
+    Mixer_PauseDevice(true);
+    SDL_Log("Running %d jobs on %d workers", job_count, worker_count);
+    const Uint64 start_time = SDL_GetTicksNS();
+
+    while ((next_job < job_count) || (active > 0)) {
+        while ((active < worker_count) && (next_job < job_count)) {
+            const int job = next_job++;
+
+            if (!start_worker(workers, active, job)) {
+                continue;
+            }
+
+            if (job_index >= 0) {
+                // This is the worker, go run the job
+                SDL_free(records);
+                SDL_free(succeeded);
+                return;
+            }
+
+            active += 1;
+        }
+
+        const int finished = wait_for_worker(workers, active, records, succeeded);
+
+        if (finished < 0) {
+            break;
+        }
+
+        workers[finished] = workers[active - 1];
+        active -= 1;
+    }
+
+    print_report(records, succeeded, job_count, SDL_GetTicksNS() - start_time);
+
+    for (int job = 0; job < job_count; job++) {
+        all_succeeded &= succeeded[job];
+    }
+
+    SDL_free(records);
+    SDL_free(succeeded);
+    SDL_free(log_paths);
+    SDLApp_Quit();
+    exit(all_succeeded ? 0 : 1);
+}
+
+void Batch_Quit() {
+    if (job_index < 0) {
+        return;
+    }
+
+    BenchResult result;
+    BatchRecord record;
+    Bench_GetResult(&result);
+    SDL_zero(record);
+
+    record.frames = result.frames;
+    record.chain = result.chain;
+    record.final = result.final.total;
+    record.wall_ns = SDL_GetTicksNS() - job_start_time;
+    record.winner = Winner_id;
+    record.wins[0] = PL_Wins[0];
+    record.wins[1] = PL_Wins[1];
+    record.vital[0] = plw[0].wu.vital_new;
+    record.vital[1] = plw[1].wu.vital_new;
+
+    const bool written = write(result_fd, &record, sizeof(record)) == sizeof(record);
+    _exit(written ? 0 : 1);
+}
+
+#endif
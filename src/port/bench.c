@@ -0,0 +1,526 @@
+#include "port/bench.h"
+#include "port/input_log.h"
+#include "port/netplay/game_state.h"
+#include "port/resources.h"
+#include "port/run_ahead.h"
+#include "port/sound/mixer.h"
+#include "port/state_hash.h"
+
+#include <SDL3/SDL.h>
+
+#if !defined(_WIN32)
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Headless replay benchmark.
+//
+// Plays an input log (see input_log.h) as fast as the machine allows, with no visible window and
+// no audio device, and times each phase of the main loop. The state is hashed after every frame
+// and chained, so the result changes if any frame of the run simulated differently, not only the
+// last one. Golden values are kept in a small text file:
+//
+//     frames <n>
+//     chain <hex>
+//     final <hex>
+//     <region> <hex>    (one line per state hash region of the last frame)
+//
+// and `--update-golden` writes that file from the current run.
+//
+// `--check-run-ahead` checks that run-ahead leaves the real simulation unchanged. At the end of the
+// first frame the process forks. The copy is the reference and runs with run-ahead off, the
+// original runs with it on (two frames if `run_ahead_frames` is 0). After every frame the
+// reference sends its whole snapshot (see game_state.h) over a pipe, and the original compares it
+// byte for byte with its own. Both share one address space layout, so pointers compare too. The
+// first frame and global that differ are reported. As in the batch runner, the audio device is
+// paused while forking and the reference leaves with _exit. Frames that end with requests in the
+// load queue are counted, and with `--expect-loading` a log that never loads anything fails, since
+// it doesn't cover how run-ahead steps around loading.
+
+#define GOLDEN_LINE_MAX 128
+#define CHECK_RUN_AHEAD_FRAMES 2
+
+static const char* phase_names[BENCH_PHASE_COUNT] = {
+    "events", "input", "game", "draw", "ahead", "present", "vblank", "hash",
+};
+
+static bool is_running = false;
+static bool is_headless = false;
+static const char* golden_path = NULL;
+static bool update_golden = false;
+static Uint32 frame_limit = 0;
+static bool check_run_ahead = false;
+static bool expect_loading = false;
+static Uint32 loading_frames = 0;
+
+static Uint64 phase_ns[BENCH_PHASE_COUNT] = { 0 };
+static Uint64 phase_max_ns[BENCH_PHASE_COUNT] = { 0 };
+static Uint64 frame_phase_ns[BENCH_PHASE_COUNT] = { 0 };
+static Uint64 last_mark = 0;
+static Uint64 start_time = 0;
+static BenchResult result = { 0 };
+
+static void print_usage() {
+    SDL_Log("Usage: 3sx_bench <input log> [--golden <file>] [--update-golden] [--frames <n>] [--check-run-ahead] "
+            "[--expect-loading]");
+}
+
+bool Bench_Init(int argc, char* argv[]) {
+    const char* log_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if ((SDL_strcmp(argv[i], "--golden") == 0) && (i + 1 < argc)) {
+            golden_path = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--update-golden") == 0) {
+            update_golden = true;
+        } else if ((SDL_strcmp(argv[i], "--frames") == 0) && (i + 1 < argc)) {
+            frame_limit = SDL_strtoul(argv[++i], NULL, 10);
+        } else if (SDL_strcmp(argv[i], "--check-run-ahead") == 0) {
+            check_run_ahead = true;
+        } else if (SDL_strcmp(argv[i], "--expect-loading") == 0) {
+            expect_loading = true;
+        } else if ((argv[i][0] != '-') && (log_path == NULL)) {
+            log_path = argv[i];
+        } else {
+            print_usage();
+            return false;
+        }
+    }
+
+    if ((log_path == NULL) || (update_golden && (golden_path == NULL)) || (expect_loading && !check_run_ahead)) {
+        print_usage();
+        return false;
+    }
+
+#if defined(_WIN32)
+    if (check_run_ahead) {
+        SDL_Log("--check-run-ahead needs fork() and isn't available on Windows");
+        return false;
+    }
+#endif
+
+    if (!Resources_CheckIfPresent()) {
+        SDL_Log("Game resources are missing. Run 3sx once to set them up");
+        return false;
+    }
+
+    Bench_SetHeadless();
+    return Bench_Start(log_path);
+}
+
+void Bench_SetHeadless() {
+    // Environment variables still take precedence over these
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+    SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+    is_headless = true;
+}
+
+bool Bench_IsHeadless() {
+    return is_headless;
+}
+
+bool Bench_Start(const char* log_path) {
+    if (!InputLog_StartPlayback(log_path)) {
+        return false;
+    }
+
+    SDL_Log("Running %s (%u frames)", log_path, InputLog_GetPlaybackLength());
+    is_running = true;
+    start_time = SDL_GetTicksNS();
+    last_mark = start_time;
+    return true;
+}
+
+void Bench_GetResult(BenchResult* res) {
+    *res = result;
+}
+
+bool Bench_IsRunning() {
+    return is_running;
+}
+
+void Bench_BeginFrame() {
+    if (!is_running) {
+        return;
+    }
+
+    SDL_zeroa(frame_phase_ns);
+    last_mark = SDL_GetTicksNS();
+}
+
+void Bench_Mark(BenchPhase phase) {
+    // Frames run ahead go to the phase they were run from as a whole
+    if (!is_running || GameState_IsSpeculative()) {
+        return;
+    }
+
+    const Uint64 now = SDL_GetTicksNS();
+    frame_phase_ns[phase] += now - last_mark;
+    last_mark = now;
+}
+
+// Run-ahead check
+
+#if defined(_WIN32)
+
+static bool check_frame() {
+    return true;
+}
+
+static bool finish_check() {
+    return true;
+}
+
+#else
+
+static pid_t reference_pid = -1;
+static int check_fd = -1;
+static bool is_reference = false;
+static bool is_check_failed = false;
+static Uint8* local_state = NULL;
+static Uint8* reference_state = NULL;
+
+static bool transfer(Uint8* data, size_t size, bool is_write) {
+    while (size > 0) {
+        const ssize_t done = is_write ? write(check_fd, data, size) : read(check_fd, data, size);
+
+        if (done <= 0) {
+            return false;
+        }
+
+        data += done;
+        size -= done;
+    }
+
+    return true;
+}
+
+static bool start_check() {
+    int fds[2];
+
+    if (pipe(fds) != 0) {
+        SDL_Log("FAIL: couldn't create a pipe for the run-ahead check");
+        return false;
+    }
+
+    Mixer_PauseDevice(true);
+    reference_pid = fork();
+
+    if (reference_pid < 0) {
+        SDL_Log("FAIL: couldn't fork the run-ahead reference");
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    const size_t size = GameState_GetSize();
+    local_state = SDL_malloc(size);
+
+    if (reference_pid == 0) {
+        close(fds[0]);
+        check_fd = fds[1];
+        is_reference = true;
+        RunAhead_SetFrames(0);
+        return true;
+    }
+
+    // Ending the check early closes the pipe, which must end the reference rather than this process
+    signal(SIGPIPE, SIG_IGN);
+    close(fds[1]);
+    check_fd = fds[0];
+    reference_state = SDL_malloc(size);
+    Mixer_PauseDevice(false);
+
+    if (RunAhead_GetFrames() == 0) {
+        RunAhead_SetFrames(CHECK_RUN_AHEAD_FRAMES);
+    }
+
+    SDL_Log("Checking %d frames of run-ahead against a run without", RunAhead_GetFrames());
+    return true;
+}
+
+static size_t find_difference(const Uint8* a, const Uint8* b, size_t size) {
+    size_t offset = 0;
+
+    while ((offset < size) && (a[offset] == b[offset])) {
+        offset += 1;
+    }
+
+    return offset;
+}
+
+/// @return `false` if the run should stop.
+static bool check_frame() {
+    if ((check_fd < 0) && !start_check()) {
+        is_check_failed = true;
+        return false;
+    }
+
+    const size_t size = GameState_GetSize();
+    GameState_Save(local_state);
+
+    if (is_reference) {
+        if (!transfer(local_state, size, true)) {
+            _exit(1);
+        }
+
+        return true;
+    }
+
+    if (!transfer(reference_state, size, false)) {
+        SDL_Log("FAIL: the run without run-ahead ended before frame %u", result.frames);
+        is_check_failed = true;
+        return false;
+    }
+
+    if (SDL_memcmp(local_state, reference_state, size) != 0) {
+        const size_t offset = find_difference(local_state, reference_state, size);
+
+        SDL_Log("FAIL: with run-ahead frame %u differs from the run without, first in %s",
+                result.frames,
+                GameState_GetRegionName(offset));
+        is_check_failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+/// @return `true` if the check passed. Doesn't return in the reference.
+static bool finish_check() {
+    if (is_reference) {
+        _exit(0);
+    }
+
+    if (check_fd >= 0) {
+        close(check_fd);
+        check_fd = -1;
+    }
+
+    if (reference_pid > 0) {
+        int status = 0;
+        waitpid(reference_pid, &status, 0);
+        reference_pid = -1;
+    }
+
+    SDL_free(local_state);
+    SDL_free(reference_state);
+    local_state = NULL;
+    reference_state = NULL;
+
+    if (!is_check_failed && expect_loading && (loading_frames == 0)) {
+        SDL_Log("FAIL: nothing was loaded, the input log doesn't cover run-ahead around loading");
+        is_check_failed = true;
+    }
+
+    if (!is_check_failed) {
+        SDL_Log("PASS: run-ahead left the state of every frame unchanged, %u of them loading", loading_frames);
+    }
+
+    return !is_check_failed;
+}
+
+#endif
+
+bool Bench_EndFrame() {
+    if (!is_running) {
+        return true;
+    }
+
+    StateHash_Compute(&result.final);
+    result.chain = StateHash_Chain(result.chain, &result.final);
+    result.frames += 1;
+    Bench_Mark(BENCH_PHASE_HASH);
+
+    for (int i = 0; i < BENCH_PHASE_COUNT; i++) {
+        phase_ns[i] += frame_phase_ns[i];
+        phase_max_ns[i] = SDL_max(phase_max_ns[i], frame_phase_ns[i]);
+    }
+
+    if (check_run_ahead) {
+        loading_frames += GameState_IsLoading();
+
+        if (!check_frame()) {
+            return false;
+        }
+    }
+
+    if ((frame_limit > 0) && (result.frames >= frame_limit)) {
+        return false;
+    }
+
+    return !InputLog_IsPlaybackFinished();
+}
+
+// Golden values
+
+static bool write_golden(const char* path, const BenchResult* res) {
+    SDL_IOStream* io = SDL_IOFromFile(path, "w");
+
+    if (io == NULL) {
+        SDL_Log("Couldn't write %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_IOprintf(io, "frames %u\n", res->frames);
+    SDL_IOprintf(io, "chain %016" SDL_PRIx64 "\n", res->chain);
+    SDL_IOprintf(io, "final %016" SDL_PRIx64 "\n", res->final.total);
+
+    for (int i = 0; i < STATE_HASH_REGION_COUNT; i++) {
+        SDL_IOprintf(io, "%s %016" SDL_PRIx64 "\n", StateHash_GetRegionName(i), res->final.regions[i]);
+    }
+
+    SDL_CloseIO(io);
+    SDL_Log("Wrote golden values to %s", path);
+    return true;
+}
+
+static void parse_golden_line(const char* line, BenchResult* res) {
+    char key[GOLDEN_LINE_MAX];
+    char text[GOLDEN_LINE_MAX];
+
+    if (SDL_sscanf(line, "%127s %127s", key, text) != 2) {
+        return;
+    }
+
+    const Uint64 value = SDL_strtoull(text, NULL, 16);
+
+    if (SDL_strcmp(key, "frames") == 0) {
+        res->frames = SDL_strtoul(text, NULL, 10);
+    } else if (SDL_strcmp(key, "chain") == 0) {
+        res->chain = value;
+    } else if (SDL_strcmp(key, "final") == 0) {
+        res->final.total = value;
+    }
+
+    for (int i = 0; i < STATE_HASH_REGION_COUNT; i++) {
+        if (SDL_strcmp(key, StateHash_GetRegionName(i)) == 0) {
+            res->final.regions[i] = value;
+        }
+    }
+}
+
+static bool read_golden(const char* path, BenchResult* res) {
+    char* data = SDL_LoadFile(path, NULL);
+
+    if (data == NULL) {
+        SDL_Log("Couldn't read %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_zerop(res);
+    char* line = data;
+
+    while (line != NULL) {
+        char* next = SDL_strchr(line, '\n');
+
+        if (next != NULL) {
+            *next = '\0';
+            next += 1;
+        }
+
+        parse_golden_line(line, res);
+        line = next;
+    }
+
+    SDL_free(data);
+    return true;
+}
+
+static bool check_golden(const char* path, const BenchResult* res) {
+    BenchResult golden;
+
+    if (!read_golden(path, &golden)) {
+        return false;
+    }
+
+    bool matches = true;
+
+    if (res->frames != golden.frames) {
+        SDL_Log("FAIL: ran %u frames, golden run has %u", res->frames, golden.frames);
+        matches = false;
+    }
+
+    if (res->chain != golden.chain) {
+        SDL_Log("FAIL: chained checksum %016" SDL_PRIx64 ", expected %016" SDL_PRIx64, res->chain, golden.chain);
+        matches = false;
+    }
+
+    if (res->final.total != golden.final.total) {
+        const int region = StateHash_FindDivergence(&res->final, &golden.final);
+
+        SDL_Log("FAIL: final checksum %016" SDL_PRIx64 ", expected %016" SDL_PRIx64 " (first differing region: %s)",
+                res->final.total,
+                golden.final.total,
+                (region >= 0) ? StateHash_GetRegionName(region) : "none");
+        matches = false;
+    }
+
+    if (matches) {
+        SDL_Log("PASS: matches %s", path);
+    } else {
+        SDL_Log("Run with state_hash_log set to find the first frame that differs");
+    }
+
+    return matches;
+}
+
+// Report
+
+static void print_report() {
+    const Uint64 wall_ns = SDL_GetTicksNS() - start_time;
+    const Uint32 frames = SDL_max(result.frames, 1);
+    Uint64 sim_ns = 0;
+
+    for (int i = 0; i < BENCH_PHASE_COUNT; i++) {
+        if (i != BENCH_PHASE_HASH) {
+            sim_ns += phase_ns[i];
+        }
+    }
+
+    SDL_Log("Frames: %u, wall time %.2f s", result.frames, (double)wall_ns / SDL_NS_PER_SECOND);
+    SDL_Log("Simulation: %.1f fps (%.3f ms/frame)",
+            (sim_ns > 0) ? (double)result.frames * SDL_NS_PER_SECOND / sim_ns : 0.0,
+            (double)sim_ns / frames / SDL_NS_PER_MS);
+
+    for (int i = 0; i < BENCH_PHASE_COUNT; i++) {
+        SDL_Log("  %-8s %8.3f ms/frame  max %8.3f ms  %5.1f%%",
+                phase_names[i],
+                (double)phase_ns[i] / frames / SDL_NS_PER_MS,
+                (double)phase_max_ns[i] / SDL_NS_PER_MS,
+                (sim_ns > 0) ? 100.0 * phase_ns[i] / sim_ns : 0.0);
+    }
+
+    SDL_Log("Checksum: chain %016" SDL_PRIx64 ", final %016" SDL_PRIx64, result.chain, result.final.total);
+}
+
+int Bench_Quit() {
+    if (!is_running) {
+        return 1;
+    }
+
+    is_running = false;
+    const bool is_check_passed = !check_run_ahead || finish_check();
+    print_report();
+
+    if (!is_check_passed) {
+        return 1;
+    }
+
+    if (!InputLog_IsPlaybackFinished() && (frame_limit == 0)) {
+        SDL_Log("FAIL: stopped before the end of the input log");
+        return 1;
+    }
+
+    if (golden_path == NULL) {
+        return 0;
+    }
+
+    if (update_golden) {
+        return write_golden(golden_path, &result) ? 0 : 1;
+    }
+
+    return check_golden(golden_path, &result) ? 0 : 1;
+}
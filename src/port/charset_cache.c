@@ -0,0 +1,286 @@
+#include "port/charset_cache.h"
+#include "common.h"
+#include "port/config.h"
+#include "sf33rd/Source/Game/CHARSET.h"
+
+#include <SDL3/SDL.h>
+
+#include <stddef.h>
+
+// Pre-decoded character scripts.
+//
+// A character script is a list of records. Pattern records (code >= 0x100) end a run, everything
+// else is a command from `decode_chcmd`. Most runs are a few commands that only copy their operands
+// into the work (rja*, mdat, sps, ...), an `end` loop back, and the pattern they lead to.
+//
+// The first time a run is entered it's decoded into a sequence of ops: operand copies become a
+// store at a known offset, `end` becomes a jump with its target resolved, and anything else is
+// called through the command table as before and ends the sequence. Sequences are keyed by the
+// address of their first record. Script data is loaded into memory that gets reused, so every op
+// keeps a copy of its record and a sequence is decoded again as soon as it doesn't match.
+//
+// With `charset_verify` set, every fused op is also run through the original command on a copy of
+// the work, and the two results are compared.
+
+#define SEQUENCE_OPS_MAX 8
+#define SEQUENCE_TABLE_SIZE 4096
+#define SEQUENCE_COUNT_MAX (SEQUENCE_TABLE_SIZE / 2)
+#define MISMATCH_LOGS_MAX 16
+
+typedef enum OpKind {
+    OP_NOP,
+    OP_STORE,
+    OP_STATUS,
+    OP_JUMP,
+    OP_CALL,
+    OP_PATTERN,
+} OpKind;
+
+typedef struct Op {
+    const UNK11* record;
+    Uint64 raw;
+    Uint16 kind;
+    Uint16 offset;
+} Op;
+
+typedef struct Sequence {
+    const UNK11* key;
+    int op_count;
+    Op ops[SEQUENCE_OPS_MAX];
+} Sequence;
+
+typedef struct StoreCommand {
+    s32 (*command)();
+    size_t offset;
+} StoreCommand;
+
+extern s32 (*const decode_chcmd[125])();
+
+s32 comm_dummy(WORK*, UNK11*);
+s32 comm_end(WORK*, UNK11*);
+s32 comm_sps(WORK*, UNK11*);
+s32 comm_rja(WORK*, UNK11*);
+s32 comm_rja2(WORK*, UNK11*);
+s32 comm_rja3(WORK*, UNK11*);
+s32 comm_rja4(WORK*, UNK11*);
+s32 comm_rja5(WORK*, UNK11*);
+s32 comm_rja6(WORK*, UNK11*);
+s32 comm_rja7(WORK*, UNK11*);
+s32 comm_rmja(WORK*, UNK11*);
+s32 comm_mdat(WORK*, UNK11*);
+s32 comm_ydat(WORK*, UNK11*);
+s32 comm_cafr(WORK*, UNK11*);
+s32 comm_care(WORK*, UNK11*);
+s32 comm_ngda(WORK*, UNK11*);
+
+// Commands that only copy koc, ix and pat of their record into an UNK11 of the work
+static const StoreCommand store_commands[] = {
+    { comm_rja, offsetof(WORK, cmja) },  { comm_rja2, offsetof(WORK, cmj2) }, { comm_rja3, offsetof(WORK, cmj3) },
+    { comm_rja4, offsetof(WORK, cmj4) }, { comm_rja5, offsetof(WORK, cmj5) }, { comm_rja6, offsetof(WORK, cmj6) },
+    { comm_rja7, offsetof(WORK, cmj7) }, { comm_rmja, offsetof(WORK, cmms) }, { comm_mdat, offsetof(WORK, cmmd) },
+    { comm_ydat, offsetof(WORK, cmyd) }, { comm_cafr, offsetof(WORK, cmcf) }, { comm_care, offsetof(WORK, cmcr) },
+    { comm_ngda, offsetof(WORK, cmyd) },
+};
+
+static bool is_initialized = false;
+static bool is_enabled = true;
+static bool is_verifying = false;
+
+static Op command_ops[SDL_arraysize(decode_chcmd)];
+static Sequence sequences[SEQUENCE_TABLE_SIZE];
+static int sequence_count = 0;
+
+// Verification
+static WORK shadow_work;
+static int mismatch_count = 0;
+
+static Uint64 read_record(const UNK11* record) {
+    Uint64 raw;
+    SDL_memcpy(&raw, record, sizeof(raw));
+    return raw;
+}
+
+static void init() {
+    is_enabled = Config_GetBool("charset_predecode", true);
+    is_verifying = Config_GetBool("charset_verify", false);
+
+    for (int code = 0; code < SDL_arraysize(decode_chcmd); code++) {
+        Op* op = &command_ops[code];
+        op->kind = OP_CALL;
+
+        if (decode_chcmd[code] == comm_dummy) {
+            op->kind = OP_NOP;
+        } else if (decode_chcmd[code] == comm_end) {
+            op->kind = OP_JUMP;
+        } else if (decode_chcmd[code] == comm_sps) {
+            op->kind = OP_STATUS;
+        }
+
+        for (int i = 0; i < SDL_arraysize(store_commands); i++) {
+            if (decode_chcmd[code] == store_commands[i].command) {
+                op->kind = OP_STORE;
+                op->offset = store_commands[i].offset;
+            }
+        }
+    }
+
+    is_initialized = true;
+}
+
+bool CharsetCache_IsEnabled() {
+    if (!is_initialized) {
+        init();
+    }
+
+    return is_enabled;
+}
+
+static void reset_sequences() {
+    for (int i = 0; i < SEQUENCE_TABLE_SIZE; i++) {
+        sequences[i].key = NULL;
+    }
+
+    sequence_count = 0;
+}
+
+static void decode_sequence(Sequence* seq, const WORK* wk) {
+    const UNK11* record = seq->key;
+    seq->op_count = 0;
+
+    while (seq->op_count < SEQUENCE_OPS_MAX) {
+        Op* op = &seq->ops[seq->op_count];
+        seq->op_count += 1;
+
+        if (record->code >= 0x100) {
+            op->kind = OP_PATTERN;
+        } else if (record->code < SDL_arraysize(command_ops)) {
+            *op = command_ops[record->code];
+        } else {
+            op->kind = OP_CALL;
+        }
+
+        op->record = record;
+        op->raw = read_record(record);
+
+        switch (op->kind) {
+        case OP_CALL:
+        case OP_PATTERN:
+            return;
+
+        case OP_JUMP:
+            record = (const UNK11*)(wk->set_char_ad + (s16)((record->pat - 1) * wk->cgd_type));
+            break;
+
+        default:
+            record = (const UNK11*)((const u32*)record + wk->cgd_type);
+            break;
+        }
+    }
+}
+
+static Sequence* find_sequence(const UNK11* key, const WORK* wk) {
+    size_t slot = ((uintptr_t)key >> 3) * 0x9E3779B1u % SEQUENCE_TABLE_SIZE;
+
+    while ((sequences[slot].key != NULL) && (sequences[slot].key != key)) {
+        slot = (slot + 1) % SEQUENCE_TABLE_SIZE;
+    }
+
+    Sequence* seq = &sequences[slot];
+
+    if (seq->key == NULL) {
+        if (sequence_count >= SEQUENCE_COUNT_MAX) {
+            reset_sequences();
+            return find_sequence(key, wk);
+        }
+
+        seq->key = key;
+        decode_sequence(seq, wk);
+        sequence_count += 1;
+    }
+
+    return seq;
+}
+
+static void report_mismatch(const WORK* wk, const UNK11* record) {
+    mismatch_count += 1;
+
+    if (mismatch_count > MISMATCH_LOGS_MAX) {
+        return;
+    }
+
+    SDL_Log("charset: pre-decoded command %d differs from interpreter (koc %d, index %d, cg_ix %d)",
+            record->code,
+            wk->now_koc,
+            wk->char_index,
+            wk->cg_ix);
+}
+
+/// @return `true` if the script continues after the sequence.
+static bool run_sequence(WORK* wk, Sequence* seq) {
+    for (int i = 0; i < seq->op_count; i++) {
+        const Op* op = &seq->ops[i];
+        UNK11* cpc = (UNK11*)(wk->set_char_ad + wk->cg_ix);
+
+        if ((cpc != op->record) || (read_record(cpc) != op->raw)) {
+            // Stale or entered with another record size. Decode again and pick up from here.
+            decode_sequence(seq, wk);
+            return true;
+        }
+
+        const bool verify = is_verifying && (op->kind != OP_CALL) && (op->kind != OP_PATTERN);
+
+        if (verify) {
+            SDL_memcpy(&shadow_work, wk, sizeof(WORK));
+            decode_chcmd[cpc->code](&shadow_work, cpc);
+            shadow_work.cg_ix += shadow_work.cgd_type;
+        }
+
+        switch (op->kind) {
+        case OP_NOP:
+            wk->cg_ix += wk->cgd_type;
+            break;
+
+        case OP_STORE:
+            SDL_memcpy((u8*)wk + op->offset + offsetof(UNK11, koc), &cpc->koc, sizeof(UNK11) - offsetof(UNK11, koc));
+            wk->cg_ix += wk->cgd_type;
+            break;
+
+        case OP_STATUS:
+            wk->pat_status = cpc->pat;
+            wk->cg_ix += wk->cgd_type;
+            break;
+
+        case OP_JUMP:
+            wk->cg_ix = (cpc->pat - 1) * wk->cgd_type;
+            break;
+
+        case OP_CALL:
+            if (decode_chcmd[cpc->code](wk, cpc) == 0) {
+                return false;
+            }
+
+            wk->cg_ix += wk->cgd_type;
+            return true;
+
+        case OP_PATTERN:
+            check_cgd_patdat(wk);
+            return false;
+        }
+
+        if (verify && (SDL_memcmp(&shadow_work, wk, sizeof(WORK)) != 0)) {
+            report_mismatch(wk, cpc);
+        }
+    }
+
+    // Sequence was cut at SEQUENCE_OPS_MAX
+    return true;
+}
+
+void CharsetCache_Run(WORK* wk) {
+    bool running = true;
+
+    while (running) {
+        const UNK11* cpc = (const UNK11*)(wk->set_char_ad + wk->cg_ix);
+        running = run_sequence(wk, find_sequence(cpc, wk));
+    }
+}
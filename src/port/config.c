@@ -0,0 +1,165 @@
+#include "port/config.h"
+
+#include <SDL3/SDL.h>
+
+#include <ctype.h>
+
+#define ENTRIES_MAX 128
+#define KEY_LENGTH_MAX 64
+#define ENV_PREFIX "SF3SX_"
+
+typedef struct ConfigEntry {
+    char* key;
+    char* value;
+} ConfigEntry;
+
+static ConfigEntry entries[ENTRIES_MAX] = { 0 };
+static int entry_count = 0;
+static bool is_loaded = false;
+
+static char* trim(char* str) {
+    while (isspace((unsigned char)*str)) {
+        str += 1;
+    }
+
+    char* end = str + SDL_strlen(str);
+
+    while ((end > str) && isspace((unsigned char)end[-1])) {
+        end -= 1;
+    }
+
+    *end = '\0';
+    return str;
+}
+
+static void parse_line(char* line) {
+    char* comment = SDL_strchr(line, '#');
+
+    if (comment != NULL) {
+        *comment = '\0';
+    }
+
+    char* separator = SDL_strchr(line, '=');
+
+    if ((separator == NULL) || (entry_count >= ENTRIES_MAX)) {
+        return;
+    }
+
+    *separator = '\0';
+    const char* key = trim(line);
+    const char* value = trim(separator + 1);
+
+    if (*key == '\0') {
+        return;
+    }
+
+    entries[entry_count].key = SDL_strdup(key);
+    entries[entry_count].value = SDL_strdup(value);
+    entry_count += 1;
+}
+
+static void load_if_needed() {
+    if (is_loaded) {
+        return;
+    }
+
+    is_loaded = true;
+
+    char* base = SDL_GetPrefPath("CrowdedStreet", "3SX");
+    char* path = NULL;
+    SDL_asprintf(&path, "%sconfig.ini", base);
+    SDL_free(base);
+
+    size_t size = 0;
+    char* data = SDL_LoadFile(path, &size);
+    SDL_free(path);
+
+    if (data == NULL) {
+        return;
+    }
+
+    char* line = data;
+
+    while (line != NULL) {
+        char* next = SDL_strchr(line, '\n');
+
+        if (next != NULL) {
+            *next = '\0';
+            next += 1;
+        }
+
+        parse_line(line);
+        line = next;
+    }
+
+    SDL_free(data);
+}
+
+static const char* lookup(const char* key) {
+    char env_name[KEY_LENGTH_MAX + sizeof(ENV_PREFIX)];
+    SDL_snprintf(env_name, sizeof(env_name), ENV_PREFIX "%s", key);
+
+    for (char* c = env_name; *c != '\0'; c++) {
+        *c = toupper((unsigned char)*c);
+    }
+
+    const char* env_value = SDL_getenv(env_name);
+
+    if (env_value != NULL) {
+        return env_value;
+    }
+
+    load_if_needed();
+
+    for (int i = 0; i < entry_count; i++) {
+        if (SDL_strcasecmp(entries[i].key, key) == 0) {
+            return entries[i].value;
+        }
+    }
+
+    return NULL;
+}
+
+const char* Config_GetString(const char* key, const char* default_value) {
+    const char* value = lookup(key);
+    return (value != NULL) ? value : default_value;
+}
+
+int Config_GetInt(const char* key, int default_value) {
+    const char* value = lookup(key);
+    return (value != NULL) ? SDL_atoi(value) : default_value;
+}
+
+double Config_GetFloat(const char* key, double default_value) {
+    const char* value = lookup(key);
+    return (value != NULL) ? SDL_atof(value) : default_value;
+}
+
+bool Config_GetBool(const char* key, bool default_value) {
+    const char* value = lookup(key);
+
+    if (value == NULL) {
+        return default_value;
+    }
+
+    return (SDL_strcasecmp(value, "1") == 0) || (SDL_strcasecmp(value, "true") == 0) ||
+           (SDL_strcasecmp(value, "yes") == 0) || (SDL_strcasecmp(value, "on") == 0);
+}
+
+char* Config_GetPath(const char* key) {
+    const char* name = Config_GetString(key, "");
+
+    if (*name == '\0') {
+        return NULL;
+    }
+
+    if (SDL_strchr(name, '/') != NULL || SDL_strchr(name, '\\') != NULL) {
+        return SDL_strdup(name);
+    }
+
+    char* base = SDL_GetPrefPath("CrowdedStreet", "3SX");
+    char* path = NULL;
+    SDL_asprintf(&path, "%s%s", base, name);
+    SDL_free(base);
+    return path;
+}
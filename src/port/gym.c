@@ -0,0 +1,323 @@
+#include "port/gym.h"
+#include "common.h"
+#include "port/bench.h"
+#include "port/resources.h"
+#include "port/sdl/sdl_app.h"
+#include "port/sdl/sdl_game_renderer.h"
+#include "port/sdl/sdl_message_renderer.h"
+#include "sf33rd/Source/Game/GD3rd.h"
+#include "sf33rd/Source/Game/Game.h"
+#include "sf33rd/Source/Game/MMTMCNT.h"
+#include "sf33rd/Source/Game/OPENING.h"
+#include "sf33rd/Source/Game/PLCNT.h"
+#include "sf33rd/Source/Game/PulPul.h"
+#include "sf33rd/Source/Game/Reset.h"
+#include "sf33rd/Source/Game/SLOWF.h"
+#include "sf33rd/Source/Game/SYS_sub.h"
+#include "sf33rd/Source/Game/SysDir.h"
+#include "sf33rd/Source/Game/WORK_SYS.h"
+#include "sf33rd/Source/Game/bg.h"
+#include "sf33rd/Source/Game/color3rd.h"
+#include "sf33rd/Source/Game/main.h"
+#include "sf33rd/Source/Game/menu.h"
+#include "sf33rd/Source/Game/op_sub.h"
+#include "sf33rd/Source/Game/workuser.h"
+#include "structs.h"
+
+#include <SDL3/SDL.h>
+
+// Gym environment.
+//
+// Lets a host program (a training loop, an AI regression suite) drive the game one frame at a
+// time, headless and uncapped. Frames are never drawn: the renderers drop draw calls and main.c
+// ends them with SDLApp_EndUndrawnFrame, which skips rendering and presenting.
+//
+// `Gym_Reset` holds start and select for the game's own soft reset, which returns to the title
+// screen from anywhere, attract mode and a finished round included. From the title it enters
+// versus mode the way the main menu does (`Setup_VS_Mode`). The character select screen is
+// skipped: its results (characters, super arts, colors and the stage) are written the way Sel_PL
+// leaves them, and the game goes on from the end of Game01, through loading and the intros, into
+// the fight. Frames run until the fight accepts input. From there every `Gym_Step` is exactly
+// one frame of `Game_Task`, with versus mode's own round timer and no handicap.
+//
+// Step inputs replace the switch words right after the pads are converted, so nothing from the
+// keyboard, the input log or netplay gets in. A side given GYM_INPUT_CPU is handed to the AI in
+// Com_Sub.c for that frame. The seed goes into system_timer and every random index, once when the
+// round is set up and again when the fight starts, so loading times don't change the round.
+
+#define CHARACTER_COUNT 20
+#define STAGE_COUNT 22
+#define SETUP_FRAMES_MAX (60 * 60)
+#define MODE_VERSUS 1         // Mode_Type of versus mode
+#define TITLE_TEXTURES 601    // Texture group the title screen releases when it's left
+#define SELECT_TEXTURES 3     // Texture cache list the select screen sets up for the fight
+#define ENTRY_IN_GAME 4       // Entry_Task step once the characters are chosen
+#define RESET_SWITCHES 0xC000 // Start and select
+#define SWITCH_MASK 0x0FFF    // Lever and buttons, so start can't pause the round
+
+static bool is_initialized = false;
+static bool is_closed = false;
+static bool is_round_running = false;
+static bool is_reset_held = false;
+static bool is_done = false;
+static Uint32 round_frames = 0;
+static Uint16 inputs[2] = { GYM_INPUT_CPU, GYM_INPUT_CPU };
+
+static void run_frame() {
+    // Run-ahead turns drawing back on after its frames
+    SDLGameRenderer_SetDrawEnabled(false);
+    SDLMessageRenderer_SetDrawEnabled(false);
+    main_run_gym_frame();
+}
+
+static bool init() {
+    if (!Resources_CheckIfPresent()) {
+        SDL_Log("Game resources are missing. Run 3sx once to set them up");
+        return false;
+    }
+
+    Bench_SetHeadless();
+
+    if (SDLApp_Init() != 0) {
+        return false;
+    }
+
+    is_initialized = true;
+
+    // The first frames load the game, then the attract mode starts
+    for (int i = 0; !get_game_initialized() || (G_No[0] == 0); i++) {
+        if (i == SETUP_FRAMES_MAX) {
+            SDL_Log("The game didn't reach the attract mode in %d frames", SETUP_FRAMES_MAX);
+            return false;
+        }
+
+        run_frame();
+    }
+
+    return true;
+}
+
+static void seed_random(Uint32 seed) {
+    // Spread the seed over all indices, so that nearby seeds give different rounds
+    Uint64 bits = seed * 0x9E3779B97F4A7C15ull;
+
+    system_timer = seed;
+    Random_ix16 = bits & 0x3F;
+    bits >>= 6;
+    Random_ix32 = bits & 0x7F;
+    bits >>= 7;
+    Random_ix16_ex = bits & 0xF;
+    bits >>= 4;
+    Random_ix32_ex = bits & 0x1F;
+    bits >>= 5;
+    Random_ix16_com = bits & 0x3F;
+    bits >>= 6;
+    Random_ix32_com = bits & 0x7F;
+    bits >>= 7;
+    Random_ix16_ex_com = bits & 0xF;
+    bits >>= 4;
+    Random_ix32_ex_com = bits & 0x1F;
+    bits >>= 5;
+    Random_ix16_bg = bits & 0x3F;
+}
+
+/// @brief Go back to the title screen through the soft reset.
+static bool soft_reset() {
+    // Held until the reset task notices, then let go, since it waits for start to be released
+    is_reset_held = true;
+
+    for (int i = 0; is_reset_held || nowSoftReset(); i++) {
+        if (i == SETUP_FRAMES_MAX) {
+            SDL_Log("The game didn't finish a soft reset in %d frames", SETUP_FRAMES_MAX);
+            is_reset_held = false;
+            return false;
+        }
+
+        run_frame();
+
+        if (nowSoftReset()) {
+            is_reset_held = false;
+        }
+    }
+
+    return true;
+}
+
+/// @brief Leave the title screen for versus mode and hand the chosen characters and stage to
+/// Game02, as the menu, the select screen and Game01 do.
+static void start_versus(int char1, int char2, int stage, Uint32 seed) {
+    s16 chars[2] = { char1, char2 };
+
+    // Leaving the title screen (Game0_2) and picking versus in the menu
+    TexRelease(TITLE_TEXTURES);
+    title_tex_flag = 0;
+    Setup_VS_Mode(&task[MENU_TASK_NUM]);
+    Mode_Type = MODE_VERSUS;
+    cpExitTask(MENU_TASK_NUM);
+
+    // Game01 before the select screen
+    S_No[0] = S_No[1] = S_No[2] = S_No[3] = 0;
+    Break_Into = 0;
+    Stop_Combo = 0;
+    seed_random(seed);
+    init_slow_flag();
+    System_all_clear_Level_B();
+    pulpul_stop();
+    init_pulpul_work();
+
+    // What Sel_PL leaves once both sides chose. Super arts stay at the first, as Before_Select_Sub
+    // set them, and a mirror match gets the second color for player 2
+    for (int i = 0; i < 2; i++) {
+        My_char[i] = chars[i];
+        Last_My_char[i] = chars[i];
+        Sel_Arts_Complete[i] = -1;
+        Push_LDREQ_Queue_Player(i, My_char[i]);
+    }
+
+    Player_Color[0] = 0;
+    Player_Color[1] = (char1 == char2);
+    Battle_Country = stage;
+    bg_w.stage = stage;
+    bg_w.area = 0;
+    Push_LDREQ_Queue_BG(bg_w.stage);
+    init_omop();
+
+    // The end of Game01
+    Game01_Sub();
+    Cover_Timer = 5;
+    appear_type = 1;
+    set_hitmark_color();
+    Purge_texcash_of_list(SELECT_TEXTURES);
+    Make_texcash_of_list(SELECT_TEXTURES);
+    Play_Type = 1;
+    G_No[1] = 2;
+    G_No[2] = 0;
+    G_No[3] = 0;
+    E_No[0] = ENTRY_IN_GAME;
+    E_No[1] = 0;
+    E_No[2] = 0;
+    E_No[3] = 0;
+}
+
+static void observe_player(GymPlayer* player, const PLW* wk) {
+    player->x = wk->wu.xyz[0].disp.pos;
+    player->y = wk->wu.xyz[1].disp.pos;
+    player->vitality = wk->wu.vital_new;
+    player->stun = wk->py->now.quantity.h;
+    player->stun_max = wk->py->genkai;
+    player->super_gauge = wk->sa->gauge.s.h;
+    player->super_stocks = wk->sa->store;
+
+    for (int i = 0; i < SDL_arraysize(player->routine); i++) {
+        player->routine[i] = wk->wu.routine_no[i];
+    }
+
+    player->pattern = wk->wu.cg_number;
+    player->kind_of_waza = wk->wu.kind_of_waza;
+    player->facing = wk->wu.rl_flag;
+    player->is_cpu = (wk->wu.operator == 0);
+}
+
+static void observe(GymObservation* obs) {
+    if (obs == NULL) {
+        return;
+    }
+
+    SDL_zerop(obs);
+    obs->frame = round_frames;
+    obs->timer = Counter_hi;
+    obs->winner = is_done ? Winner_id : -1;
+    obs->done = is_done;
+
+    for (int i = 0; i < 2; i++) {
+        observe_player(&obs->players[i], &plw[i]);
+    }
+}
+
+bool Gym_Reset(int char1, int char2, int stage, uint32_t seed, GymObservation* obs) {
+    if ((char1 < 0) || (char1 >= CHARACTER_COUNT) || (char2 < 0) || (char2 >= CHARACTER_COUNT) || (stage < 0) ||
+        (stage >= STAGE_COUNT)) {
+        SDL_Log("Invalid gym round: characters %d and %d, stage %d", char1, char2, stage);
+        return false;
+    }
+
+    if (is_closed) {
+        SDL_Log("The gym was closed and can't start another round");
+        return false;
+    }
+
+    if (!is_initialized && !init()) {
+        return false;
+    }
+
+    is_round_running = false;
+
+    if (!soft_reset()) {
+        return false;
+    }
+
+    start_versus(char1, char2, stage, seed);
+
+    for (int i = 0; Allow_a_battle_f == 0; i++) {
+        if (i == SETUP_FRAMES_MAX) {
+            SDL_Log("The gym round didn't start in %d frames", SETUP_FRAMES_MAX);
+            return false;
+        }
+
+        run_frame();
+    }
+
+    // Game2_0 clears the random indices in versus mode
+    seed_random(seed);
+    is_round_running = true;
+    is_done = false;
+    round_frames = 0;
+    observe(obs);
+    return true;
+}
+
+bool Gym_Step(uint16_t p1_input, uint16_t p2_input, GymObservation* obs) {
+    if (!is_round_running) {
+        SDL_Log("Gym_Step needs a round started with Gym_Reset");
+        return false;
+    }
+
+    if (!is_done) {
+        inputs[0] = p1_input;
+        inputs[1] = p2_input;
+        run_frame();
+        round_frames += 1;
+        is_done = (Conclusion_Flag != 0);
+    }
+
+    observe(obs);
+    return true;
+}
+
+void Gym_Close() {
+    if (!is_initialized || is_closed) {
+        return;
+    }
+
+    is_round_running = false;
+    is_closed = true;
+    SDLApp_Quit();
+}
+
+void Gym_ProcessSwitches() {
+    u16* switches[2] = { &p1sw_buff, &p2sw_buff };
+
+    for (int i = 0; i < 2; i++) {
+        // Setup frames run without input, except for the soft reset
+        if (!is_round_running) {
+            *switches[i] = (is_reset_held && (i == 0)) ? RESET_SWITCHES : 0;
+            continue;
+        }
+
+        const bool is_cpu = (inputs[i] == GYM_INPUT_CPU);
+
+        plw[i].wu.operator = !is_cpu;
+        Operator_Status[i] = !is_cpu;
+        *switches[i] = is_cpu ? 0 : (inputs[i] & SWITCH_MASK);
+    }
+}
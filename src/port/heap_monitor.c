@@ -0,0 +1,462 @@
+#include "port/heap_monitor.h"
+#include "common.h"
+#include "port/arena.h"
+#include "port/bench.h"
+#include "port/config.h"
+#include "port/netplay/game_state.h"
+#include "port/netplay/netplay.h"
+#include "port/sdl/sdl_game_renderer.h"
+#include "port/state_hash.h"
+#include "sf33rd/AcrSDK/common/memfound.h"
+#include "sf33rd/Source/Common/PPGFile.h"
+#include "sf33rd/Source/Compress/zlibApp.h"
+#include "sf33rd/Source/Game/MTRANS.h"
+#include "sf33rd/Source/Game/RAMCNT.h"
+#include "sf33rd/Source/Game/main.h"
+#include "sf33rd/Source/Game/workuser.h"
+
+#include <SDL3/SDL.h>
+
+// Heap monitor.
+//
+// The game carves its memory out of fixed PS2-sized arenas (see arena.h). After many character and
+// stage changes an arena can have enough free space in total but no gap large enough for the next
+// load. The monitor measures each arena by walking its blocks:
+//
+//     sysmem  AcrSDK system memory (memmgr): textures, palettes, DMA queues
+//     ramcnt  RAMCNT keys (MemMan): character, stage and effect data
+//     seqs    Sprite chips of a frame
+//     ppg     PPG work memory (MemMan)
+//     zlib    zlib state (MemMan)
+//
+// Fragmentation is 1 - largest free gap / free space, so 0 means all free space is one gap. The
+// high-water marks of sysmem and seqs are sampled once a frame. MemMan keeps its own low-water mark
+// of free space, so the peaks of the other arenas are exact.
+//
+// System memory is only reached through handles, which is what lets `flCompact` move its blocks.
+// The compactor does the same work a block at a time: while no fight is running it moves blocks for
+// at most `heap_compact_budget_us` a frame, until the arena is packed again. It runs at the end of
+// flFlip, after the DMA of the frame was sent and right before the temporary buffer is set up
+// again, the same point flPS2DmaTerminate flushes at. RAMCNT hands out plain addresses that game
+// code keeps, so its blocks can't move and it is only measured.
+//
+// The footprint profile (`arena_profile_frames`) runs the game headless and uncapped, so with no
+// input it goes through the title and the attract demos. After that many frames it writes the
+// report and quits. The report ends with `arena_*_kb` settings that fit the peaks of the run plus
+// `arena_profile_headroom` percent. Attract mode doesn't load everything a real match does, so the
+// headroom should stay generous when shrinking RAMCNT.
+
+#define KIB 1024
+#define RAMCNT_KEY_COUNT (RCKEY_WORK_MAX - 1)
+
+typedef enum MonitoredArena {
+    MONITORED_SYSMEM,
+    MONITORED_RAMCNT,
+    MONITORED_SEQS,
+    MONITORED_PPG,
+    MONITORED_ZLIB,
+    MONITORED_COUNT,
+} MonitoredArena;
+
+typedef struct ArenaStats {
+    size_t size;
+    size_t used;
+    size_t used_peak;
+    size_t free;
+    size_t largest_free;
+    int live_blocks;
+    int live_blocks_peak;
+} ArenaStats;
+
+typedef struct ArenaPeaks {
+    size_t used;
+    int live_blocks;
+} ArenaPeaks;
+
+typedef struct CompactorStats {
+    Uint64 passes;
+    Uint64 blocks_moved;
+    Uint64 bytes_moved;
+    Uint64 time_ns;
+} CompactorStats;
+
+static const char* arena_names[MONITORED_COUNT] = { "sysmem", "ramcnt", "seqs", "ppg", "zlib" };
+
+static bool is_compactor_enabled = false;
+static Uint64 compact_budget_ns = 0;
+static bool is_report_requested = false;
+static int profile_frames = 0;
+static int profile_headroom = 0;
+static int frames_profiled = 0;
+
+static ArenaPeaks peaks[MONITORED_COUNT] = { 0 };
+static CompactorStats compactor = { 0 };
+
+// Measuring
+
+static void measure_memmgr(const MEM_MGR* mgr, ArenaStats* stats) {
+    const bool is_upward = (mgr->direction != 0);
+    const uintptr_t low = is_upward ? (uintptr_t)mgr->memptr : (uintptr_t)mgr->memptr - mgr->memsize;
+    const uintptr_t high = is_upward ? (uintptr_t)mgr->memptr + mgr->memsize : (uintptr_t)mgr->memptr;
+    uintptr_t edge = is_upward ? low : high;
+
+    stats->size = mgr->memsize;
+    stats->used = mgr->used_size;
+    stats->free = mgr->memsize - mgr->used_size;
+
+    // Blocks are listed in address order, going away from memptr
+    for (u32 han = mgr->blocklist; han != MEM_NULL_HANDLE; han = mgr->block[han].next) {
+        const MEM_BLOCK* block = &mgr->block[han];
+        const uintptr_t start = (uintptr_t)block->ptr;
+        const uintptr_t end = start + block->len;
+        const size_t gap = is_upward ? start - edge : edge - end;
+
+        stats->largest_free = SDL_max(stats->largest_free, gap);
+        stats->live_blocks += 1;
+        edge = is_upward ? end : start;
+    }
+
+    stats->largest_free = SDL_max(stats->largest_free, is_upward ? high - edge : edge - low);
+}
+
+static void measure_memman(const _MEMMAN_OBJ* mm, ArenaStats* stats) {
+    stats->size = mm->memSize - mm->ownUnit * 2;
+    stats->free = mm->remainder;
+    stats->used = stats->size - stats->free;
+    stats->used_peak = stats->size - mm->remainderMin;
+
+    // The first and the last cell only mark the ends of the heap
+    for (const struct _MEMMAN_CELL* cell = mm->cell_1st; cell->next != NULL; cell = cell->next) {
+        const size_t gap = (uintptr_t)cell->next - (uintptr_t)cell - cell->size;
+
+        stats->largest_free = SDL_max(stats->largest_free, gap);
+
+        if (cell != mm->cell_1st) {
+            stats->live_blocks += 1;
+        }
+    }
+}
+
+static void measure_seqs(ArenaStats* stats) {
+    stats->size = seqsGetUseMemorySize();
+    stats->used = seqs_w.sprTotal * sizeof(Sprite2);
+    stats->used_peak = seqsGetSprMax() * sizeof(Sprite2);
+    stats->free = stats->size - stats->used;
+    stats->largest_free = stats->free;
+    stats->live_blocks = seqs_w.sprTotal;
+}
+
+static void measure(MonitoredArena arena, ArenaStats* stats) {
+    SDL_zerop(stats);
+
+    switch (arena) {
+    case MONITORED_SYSMEM:
+        measure_memmgr(&sysmemmgr, stats);
+        break;
+
+    case MONITORED_RAMCNT:
+        measure_memman(&rckey_mmobj, stats);
+        break;
+
+    case MONITORED_SEQS:
+        measure_seqs(stats);
+        break;
+
+    case MONITORED_PPG:
+        measure_memman(ppg_GetHeap(), stats);
+        break;
+
+    case MONITORED_ZLIB:
+        measure_memman(zlib_GetHeap(), stats);
+        break;
+
+    default:
+        break;
+    }
+
+    stats->used_peak = SDL_max(stats->used_peak, SDL_max(peaks[arena].used, stats->used));
+    stats->live_blocks_peak = SDL_max(peaks[arena].live_blocks, stats->live_blocks);
+}
+
+static bool is_arena_ready() {
+    return get_game_initialized() && (sysmemmgr.block != NULL) && (rckey_mmobj.cell_1st != NULL);
+}
+
+static float fragmentation(const ArenaStats* stats) {
+    if (stats->free == 0) {
+        return 0.0f;
+    }
+
+    return 1.0f - (float)stats->largest_free / (float)stats->free;
+}
+
+// Recommended sizes
+
+static size_t add_headroom(size_t size) {
+    const size_t padded = size + size * profile_headroom / 100;
+    return (padded + KIB - 1) / KIB * KIB;
+}
+
+/// @brief Fill `sizes` with arena sizes that fit the peaks seen so far.
+static void recommend_sizes(size_t sizes[ARENA_COUNT]) {
+    ArenaStats stats[MONITORED_COUNT];
+
+    for (int i = 0; i < MONITORED_COUNT; i++) {
+        measure(i, &stats[i]);
+    }
+
+    // Textures are loaded through a temporary buffer past the last block
+    sizes[ARENA_SYSMEM] = add_headroom(stats[MONITORED_SYSMEM].used_peak + mflTemporaryUseMax);
+    sizes[ARENA_SEQS] = add_headroom(stats[MONITORED_SEQS].used_peak);
+
+    // MemMan heaps lose two cells to their ends and up to one to alignment
+    sizes[ARENA_PPG] = add_headroom(stats[MONITORED_PPG].used_peak + ppg_GetHeap()->ownUnit * 3);
+    sizes[ARENA_ZLIB] = add_headroom(stats[MONITORED_ZLIB].used_peak + zlib_GetHeap()->ownUnit * 3);
+
+    const size_t ramcnt = add_headroom(stats[MONITORED_RAMCNT].used_peak + rckey_mmobj.ownUnit * 3);
+    sizes[ARENA_HEAP] = ramcnt;
+
+    for (int i = 0; i < ARENA_COUNT; i++) {
+        if (i != ARENA_HEAP) {
+            sizes[ARENA_HEAP] += sizes[i];
+        }
+    }
+}
+
+// Report
+
+static void write_arena(SDL_IOStream* io, MonitoredArena arena, const ArenaStats* stats) {
+    SDL_IOprintf(io, "    \"%s\": {\n", arena_names[arena]);
+    SDL_IOprintf(io, "      \"size\": %zu,\n", stats->size);
+    SDL_IOprintf(io, "      \"used\": %zu,\n", stats->used);
+    SDL_IOprintf(io, "      \"used_peak\": %zu,\n", stats->used_peak);
+    SDL_IOprintf(io, "      \"free\": %zu,\n", stats->free);
+    SDL_IOprintf(io, "      \"largest_free\": %zu,\n", stats->largest_free);
+    SDL_IOprintf(io, "      \"fragmentation\": %.4f,\n", fragmentation(stats));
+    SDL_IOprintf(io, "      \"live_blocks\": %d,\n", stats->live_blocks);
+    SDL_IOprintf(io, "      \"live_blocks_peak\": %d", stats->live_blocks_peak);
+
+    switch (arena) {
+    case MONITORED_SYSMEM:
+        SDL_IOprintf(io, ",\n      \"temporary_peak\": %d", mflTemporaryUseMax);
+        break;
+
+    case MONITORED_RAMCNT:
+        SDL_IOprintf(io, ",\n      \"keys\": %d,\n", RAMCNT_KEY_COUNT - rckeyctr);
+        SDL_IOprintf(io, "      \"keys_peak\": %d,\n", RAMCNT_KEY_COUNT - rckeymin);
+        SDL_IOprintf(io, "      \"keys_max\": %d", RAMCNT_KEY_COUNT);
+        break;
+
+    default:
+        break;
+    }
+
+    SDL_IOprintf(io, "\n    }%s\n", (arena == MONITORED_COUNT - 1) ? "" : ",");
+}
+
+bool HeapMonitor_WriteReport(const char* path) {
+    if (!is_arena_ready()) {
+        SDL_Log("No heap report before the game has started");
+        return false;
+    }
+
+    SDL_IOStream* io = SDL_IOFromFile(path, "w");
+
+    if (io == NULL) {
+        SDL_Log("Couldn't write heap report %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    size_t sizes[ARENA_COUNT];
+    recommend_sizes(sizes);
+
+    SDL_IOprintf(io, "{\n");
+    SDL_IOprintf(io, "  \"frame\": %u,\n", StateHash_GetFrame());
+    SDL_IOprintf(io, "  \"arenas\": {\n");
+
+    for (int i = 0; i < MONITORED_COUNT; i++) {
+        ArenaStats stats;
+
+        measure(i, &stats);
+        write_arena(io, i, &stats);
+    }
+
+    SDL_IOprintf(io, "  },\n");
+    SDL_IOprintf(io, "  \"compactor\": {\n");
+    SDL_IOprintf(io, "    \"enabled\": %s,\n", is_compactor_enabled ? "true" : "false");
+    SDL_IOprintf(io, "    \"budget_us\": %" SDL_PRIu64 ",\n", compact_budget_ns / SDL_NS_PER_US);
+    SDL_IOprintf(io, "    \"passes\": %" SDL_PRIu64 ",\n", compactor.passes);
+    SDL_IOprintf(io, "    \"blocks_moved\": %" SDL_PRIu64 ",\n", compactor.blocks_moved);
+    SDL_IOprintf(io, "    \"bytes_moved\": %" SDL_PRIu64 ",\n", compactor.bytes_moved);
+    SDL_IOprintf(io, "    \"time_us\": %" SDL_PRIu64 "\n", compactor.time_ns / SDL_NS_PER_US);
+    SDL_IOprintf(io, "  },\n");
+    SDL_IOprintf(io, "  \"recommended\": {\n");
+    SDL_IOprintf(io, "    \"headroom_percent\": %d,\n", profile_headroom);
+
+    for (int i = 0; i < ARENA_COUNT; i++) {
+        SDL_IOprintf(io,
+                     "    \"arena_%s_kb\": %zu%s\n",
+                     Arena_GetName(i),
+                     sizes[i] / KIB,
+                     (i == ARENA_COUNT - 1) ? "" : ",");
+    }
+
+    SDL_IOprintf(io, "  }\n");
+    SDL_IOprintf(io, "}\n");
+
+    const bool success = SDL_CloseIO(io);
+    SDL_Log("Wrote heap report to %s", path);
+    return success;
+}
+
+static void write_report_to_setting(const char* default_name) {
+    char* path = Config_GetPath("heap_report");
+
+    if (path == NULL) {
+        char* base = SDL_GetPrefPath("CrowdedStreet", "3SX");
+        SDL_asprintf(&path, "%s%s", base, default_name);
+        SDL_free(base);
+    }
+
+    HeapMonitor_WriteReport(path);
+    SDL_free(path);
+}
+
+static void log_summary() {
+    for (int i = 0; i < MONITORED_COUNT; i++) {
+        ArenaStats stats;
+
+        measure(i, &stats);
+        SDL_Log("Heap %s: %zu of %zu KiB used, peak %zu KiB, %d blocks, %.1f%% fragmented",
+                arena_names[i],
+                stats.used / KIB,
+                stats.size / KIB,
+                stats.used_peak / KIB,
+                stats.live_blocks,
+                fragmentation(&stats) * 100.0f);
+    }
+
+    if (is_compactor_enabled) {
+        SDL_Log("Heap compactor moved %" SDL_PRIu64 " blocks, %" SDL_PRIu64 " KiB in %" SDL_PRIu64 " us",
+                compactor.blocks_moved,
+                compactor.bytes_moved / KIB,
+                compactor.time_ns / SDL_NS_PER_US);
+    }
+}
+
+static void finish_profile() {
+    size_t sizes[ARENA_COUNT];
+
+    recommend_sizes(sizes);
+    SDL_Log("Footprint profile of %d frames, settings with %d%% headroom:", frames_profiled, profile_headroom);
+
+    for (int i = 0; i < ARENA_COUNT; i++) {
+        SDL_Log("    arena_%s_kb = %zu (now %zu)", Arena_GetName(i), sizes[i] / KIB, Arena_GetSize(i) / KIB);
+    }
+
+    write_report_to_setting("arena_profile.json");
+
+    SDL_Event event = { .type = SDL_EVENT_QUIT };
+    SDL_PushEvent(&event);
+}
+
+// Compactor
+
+static void compact() {
+    const Uint64 start = SDL_GetTicksNS();
+    const Uint64 deadline = start + compact_budget_ns;
+    Uint64 blocks_moved = 0;
+
+    do {
+        const u32 len = mflCompactStep();
+
+        if (len == 0) {
+            break;
+        }
+
+        blocks_moved += 1;
+        compactor.bytes_moved += len;
+    } while (SDL_GetTicksNS() < deadline);
+
+    if (blocks_moved == 0) {
+        return;
+    }
+
+    SDLGameRenderer_RelocateTextures();
+    compactor.passes += 1;
+    compactor.blocks_moved += blocks_moved;
+    compactor.time_ns += SDL_GetTicksNS() - start;
+}
+
+// Frame
+
+void HeapMonitor_Init() {
+    is_compactor_enabled = Config_GetBool("heap_compact", false);
+    compact_budget_ns = (Uint64)SDL_max(Config_GetInt("heap_compact_budget_us", 500), 1) * SDL_NS_PER_US;
+    profile_frames = SDL_max(Config_GetInt("arena_profile_frames", 0), 0);
+    profile_headroom = SDL_clamp(Config_GetInt("arena_profile_headroom", 25), 0, 1000);
+
+    if (is_compactor_enabled) {
+        SDL_Log("Compacting system memory between rounds, %" SDL_PRIu64 " us a frame",
+                compact_budget_ns / SDL_NS_PER_US);
+    }
+
+    if (profile_frames > 0) {
+        SDL_Log("Profiling the memory footprint for %d frames", profile_frames);
+        Bench_SetHeadless();
+    }
+}
+
+void HeapMonitor_Quit() {
+    if (!is_arena_ready()) {
+        return;
+    }
+
+    log_summary();
+
+    char* path = Config_GetPath("heap_report");
+
+    if ((path != NULL) && (profile_frames == 0)) {
+        HeapMonitor_WriteReport(path);
+    }
+
+    SDL_free(path);
+}
+
+void HeapMonitor_RequestReport() {
+    is_report_requested = true;
+}
+
+void HeapMonitor_EndFrame() {
+    if (!is_arena_ready()) {
+        return;
+    }
+
+    // Frames that are run again or ahead aren't counted, and the compactor waits for the real one
+    const bool is_real_frame = !GameState_IsSpeculative() && !Netplay_IsResimulating();
+
+    if (is_compactor_enabled && is_real_frame && (Allow_a_battle_f == 0)) {
+        compact();
+    }
+
+    for (int i = 0; i < MONITORED_COUNT; i++) {
+        ArenaStats stats;
+
+        measure(i, &stats);
+        peaks[i].used = stats.used_peak;
+        peaks[i].live_blocks = stats.live_blocks_peak;
+    }
+
+    if (is_report_requested) {
+        is_report_requested = false;
+        write_report_to_setting("heap_report.json");
+    }
+
+    if ((profile_frames > 0) && is_real_frame) {
+        frames_profiled += 1;
+
+        if (frames_profiled == profile_frames) {
+            finish_profile();
+        }
+    }
+}
@@ -0,0 +1,187 @@
+#include "port/input_log.h"
+#include "port/config.h"
+#include "port/netplay/game_state.h"
+
+#include <SDL3/SDL.h>
+
+// Pad input log.
+//
+// The log stores `tarpad_root` as it is right after `tarPADRead`, so everything downstream (repeat,
+// button config, keyConvert) is recomputed on playback the same way it was while recording. Input
+// changes rarely, so the file is a list of runs: a frame count followed by the pad state that was
+// held for that many frames. Values are stored in host byte order.
+
+#define LOG_MAGIC "3SXI"
+#define LOG_VERSION 1
+
+typedef struct LogHeader {
+    char magic[4];
+    Uint32 version;
+    Uint32 pads_size;
+} LogHeader;
+
+typedef struct LogRun {
+    Uint32 frames;
+    TARPAD pads[2];
+} LogRun;
+
+// Recording
+static SDL_IOStream* record_io = NULL;
+static LogRun current_run = { 0 };
+
+// Playback
+static LogRun* runs = NULL;
+static size_t run_count = 0;
+static size_t run_index = 0;
+static Uint32 run_frames_left = 0;
+static Uint32 playback_length = 0;
+static bool is_playing = false;
+static bool is_playback_finished = false;
+
+static void write_current_run() {
+    if (current_run.frames == 0) {
+        return;
+    }
+
+    if (SDL_WriteIO(record_io, &current_run, sizeof(current_run)) != sizeof(current_run)) {
+        SDL_Log("Couldn't write input log: %s", SDL_GetError());
+    }
+
+    current_run.frames = 0;
+}
+
+void InputLog_Init() {
+    if (is_playing) {
+        return;
+    }
+
+    char* path = Config_GetPath("input_record");
+
+    if (path == NULL) {
+        return;
+    }
+
+    record_io = SDL_IOFromFile(path, "wb");
+
+    if (record_io == NULL) {
+        SDL_Log("Couldn't open input log %s: %s", path, SDL_GetError());
+        SDL_free(path);
+        return;
+    }
+
+    const LogHeader header = { .magic = LOG_MAGIC, .version = LOG_VERSION, .pads_size = sizeof(current_run.pads) };
+    SDL_WriteIO(record_io, &header, sizeof(header));
+    SDL_Log("Recording input to %s", path);
+    SDL_free(path);
+}
+
+void InputLog_Quit() {
+    if (record_io != NULL) {
+        write_current_run();
+        SDL_CloseIO(record_io);
+        record_io = NULL;
+    }
+
+    SDL_free(runs);
+    runs = NULL;
+    is_playing = false;
+}
+
+bool InputLog_StartPlayback(const char* path) {
+    size_t size = 0;
+    Uint8* data = SDL_LoadFile(path, &size);
+
+    if (data == NULL) {
+        SDL_Log("Couldn't load input log %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    LogHeader header;
+
+    if (size < sizeof(header)) {
+        SDL_Log("Input log %s is truncated", path);
+        SDL_free(data);
+        return false;
+    }
+
+    SDL_memcpy(&header, data, sizeof(header));
+
+    if ((SDL_memcmp(header.magic, LOG_MAGIC, sizeof(header.magic)) != 0) || (header.version != LOG_VERSION) ||
+        (header.pads_size != sizeof(current_run.pads))) {
+        SDL_Log("%s is not an input log of this build", path);
+        SDL_free(data);
+        return false;
+    }
+
+    run_count = (size - sizeof(header)) / sizeof(LogRun);
+    runs = SDL_malloc(SDL_max(run_count, 1) * sizeof(LogRun));
+    SDL_memcpy(runs, data + sizeof(header), run_count * sizeof(LogRun));
+    SDL_free(data);
+
+    playback_length = 0;
+
+    for (size_t i = 0; i < run_count; i++) {
+        playback_length += runs[i].frames;
+    }
+
+    run_index = 0;
+    run_frames_left = (run_count > 0) ? runs[0].frames : 0;
+    is_playing = true;
+    is_playback_finished = (playback_length == 0);
+    return true;
+}
+
+static void play(TARPAD pads[2]) {
+    while ((run_frames_left == 0) && (run_index + 1 < run_count)) {
+        run_index += 1;
+        run_frames_left = runs[run_index].frames;
+    }
+
+    if (run_frames_left == 0) {
+        is_playback_finished = true;
+        return;
+    }
+
+    SDL_memcpy(pads, runs[run_index].pads, sizeof(current_run.pads));
+    run_frames_left -= 1;
+
+    if ((run_frames_left == 0) && (run_index + 1 >= run_count)) {
+        is_playback_finished = true;
+    }
+}
+
+static void record(const TARPAD pads[2]) {
+    if ((current_run.frames > 0) && (SDL_memcmp(current_run.pads, pads, sizeof(current_run.pads)) == 0)) {
+        current_run.frames += 1;
+        return;
+    }
+
+    write_current_run();
+    SDL_memcpy(current_run.pads, pads, sizeof(current_run.pads));
+    current_run.frames = 1;
+}
+
+void InputLog_Process(TARPAD pads[2]) {
+    // Speculative frames get their input from run-ahead or netplay, not from the log
+    if (GameState_IsSpeculative()) {
+        return;
+    }
+
+    if (is_playing) {
+        play(pads);
+    } else if (record_io != NULL) {
+        record(pads);
+    }
+}
+
+bool InputLog_IsRecording() {
+    return record_io != NULL;
+}
+
+bool InputLog_IsPlaybackFinished() {
+    return is_playback_finished;
+}
+
+Uint32 InputLog_GetPlaybackLength() {
+    return playback_length;
+}
@@ -0,0 +1,486 @@
+#include "port/netplay/game_state.h"
+#include "common.h"
+#include "port/memcard.h"
+#include "port/state_hash.h"
+#include "sf33rd/Source/Game/BCD.h"
+#include "sf33rd/Source/Game/CHARSET.h"
+#include "sf33rd/Source/Game/Ck_Pass.h"
+#include "sf33rd/Source/Game/Com_Sub.h"
+#include "sf33rd/Source/Game/Continue.h"
+#include "sf33rd/Source/Game/DEMO00.h"
+#include "sf33rd/Source/Game/EFF45.h"
+#include "sf33rd/Source/Game/EFF56.h"
+#include "sf33rd/Source/Game/EFF77.h"
+#include "sf33rd/Source/Game/EFFA6.h"
+#include "sf33rd/Source/Game/EFFB8.h"
+#include "sf33rd/Source/Game/EFFECT.h"
+#include "sf33rd/Source/Game/EFFF9.h"
+#include "sf33rd/Source/Game/EFFH6.h"
+#include "sf33rd/Source/Game/Eff79.h"
+#include "sf33rd/Source/Game/Eff95.h"
+#include "sf33rd/Source/Game/EffA2.h"
+#include "sf33rd/Source/Game/Entry.h"
+#include "sf33rd/Source/Game/GD3rd.h"
+#include "sf33rd/Source/Game/GameOver.h"
+#include "sf33rd/Source/Game/Grade.h"
+#include "sf33rd/Source/Game/HITCHECK.h"
+#include "sf33rd/Source/Game/IOConv.h"
+#include "sf33rd/Source/Game/Manage.h"
+#include "sf33rd/Source/Game/Next_CPU.h"
+#include "sf33rd/Source/Game/OPENING.h"
+#include "sf33rd/Source/Game/PLCNT.h"
+#include "sf33rd/Source/Game/Pause.h"
+#include "sf33rd/Source/Game/PulPul.h"
+#include "sf33rd/Source/Game/RANKING.h"
+#include "sf33rd/Source/Game/Reset.h"
+#include "sf33rd/Source/Game/SLOWF.h"
+#include "sf33rd/Source/Game/SYS_sub.h"
+#include "sf33rd/Source/Game/SysDir.h"
+#include "sf33rd/Source/Game/VITAL.h"
+#include "sf33rd/Source/Game/WORK_SYS.h"
+#include "sf33rd/Source/Game/Win.h"
+#include "sf33rd/Source/Game/animation/appear.h"
+#include "sf33rd/Source/Game/animation/lose_pl.h"
+#include "sf33rd/Source/Game/animation/win_pl.h"
+#include "sf33rd/Source/Game/bg.h"
+#include "sf33rd/Source/Game/bg_data.h"
+#include "sf33rd/Source/Game/cmb_win.h"
+#include "sf33rd/Source/Game/cmd_data.h"
+#include "sf33rd/Source/Game/count.h"
+#include "sf33rd/Source/Game/debug/Debug.h"
+#include "sf33rd/Source/Game/effb2.h"
+#include "sf33rd/Source/Game/effb3.h"
+#include "sf33rd/Source/Game/effb9.h"
+#include "sf33rd/Source/Game/effl8.h"
+#include "sf33rd/Source/Game/end_0.h"
+#include "sf33rd/Source/Game/end_14.h"
+#include "sf33rd/Source/Game/end_5.h"
+#include "sf33rd/Source/Game/end_data.h"
+#include "sf33rd/Source/Game/init3rd.h"
+#include "sf33rd/Source/Game/main.h"
+#include "sf33rd/Source/Game/menu.h"
+#include "sf33rd/Source/Game/n_input.h"
+#include "sf33rd/Source/Game/plpat14.h"
+#include "sf33rd/Source/Game/sc_data.h"
+#include "sf33rd/Source/Game/sc_sub.h"
+#include "sf33rd/Source/Game/sel_pl.h"
+#include "sf33rd/Source/Game/spgauge.h"
+#include "sf33rd/Source/Game/staff.h"
+#include "sf33rd/Source/Game/stun.h"
+#include "sf33rd/Source/Game/ta_sub.h"
+#include "sf33rd/Source/Game/workuser.h"
+#include "structs.h"
+
+#include <SDL3/SDL.h>
+
+// Game state snapshots.
+//
+// The simulation keeps its state in globals, so a snapshot is the concatenation of every global
+// the game logic reads back on a later frame. The table below comes from an audit of every
+// non-const global defined under Source/Game, grouped by the header that declares it. Globals
+// that were private to their translation unit but carry state between frames got an extern in
+// their header, and function statics with the same role were moved to file scope.
+//
+// Left out on purpose, since the simulation never reads them back:
+// - sound: the ADX and BGM work in Sound3rd.c, the sequencer status in SE.c
+// - palettes and drawing: color3rd.c, meta_col.c, the chip and sort lists in MTRANS.c, aboutspr.c,
+//   DC_Ghost.c, the BG polygons in bg.c and the screen textures in sc_sub.c
+// - debug work in debug/, and tables that are initialized data and never written
+//
+// Loading is read back, but only the load queue in GD3rd.c is part of the snapshot. The files it
+// loads go to the RAMCNT heap, and RAMCNT.c, texgroup.c and texcash.c keep their bookkeeping in and
+// about that heap, too much to copy every frame. Instead the queue doesn't move on a frame that may
+// be thrown away (`GameState_IsLoadQueueHeld`), and run-ahead and netplay only run such frames while
+// the queue is empty (`GameState_IsLoading`). Game code that loads directly (texture groups, texture
+// caches, palettes) checks whether the work is done already, so a frame that is run again finds
+// nothing left to do. A frame that isn't run again leaves what it loaded until the game purges that
+// kind of memory, which it does when the scene changes.
+//
+// The save screen (savesub.c, mcsub.c) is left out the same way. Its work points into the RAMCNT
+// heap and drives card commands that finish on their own thread, so run-ahead and netplay only run
+// frames that may be thrown away while no save screen is open (`GameState_IsSaving`).
+//
+// Regions that hold pointers are marked. Pointers stay valid because snapshots never leave the
+// process, but they differ between processes, so `GameState_HashPlain` skips those regions. The
+// state hash covers the pointer free fields of the ones that matter with field lists instead.
+
+#define REGION(name) { (void*)&name, sizeof(name), #name, false }
+#define POINTER_REGION(name) { (void*)&name, sizeof(name), #name, true }
+
+typedef struct StateRegion {
+    void* data;
+    size_t size;
+    const char* name;
+    bool has_pointers;
+} StateRegion;
+
+// Defined in mlPAD.c. The button repeat counters carry over between frames
+extern FLPAD flpad_root[2];
+extern FLPAD flpad_conf[2];
+
+// Defined in savesub.c, whose header brings CRI types that clash with SDL's
+s32 SaveIsOpen();
+
+static bool is_speculative = false;
+static bool is_rollback_enabled = false;
+
+static const StateRegion regions[] = {
+    // workuser.h
+    REGION(Order), REGION(Order_Timer), REGION(Order_Dir), REGION(Score), POINTER_REGION(Tech_Address),
+    REGION(Complete_Bonus), POINTER_REGION(Shell_Address), REGION(Stock_Score), REGION(Vital_Bonus), REGION(Time_Bonus),
+    REGION(Stage_Stock_Score), REGION(Bonus_Score), REGION(Final_Bonus_Score), POINTER_REGION(Synchro_Address),
+    REGION(WGJ_Score), REGION(Bonus_Score_Plus), REGION(Perfect_Bonus), REGION(Keep_Score), REGION(Disp_Score_Buff),
+    REGION(Winner_id), REGION(Loser_id), REGION(Counter_hi), REGION(Counter_low), REGION(Break_Into), REGION(My_char),
+    REGION(Allow_a_battle_f), REGION(Round_num), REGION(Complete_Judgement), REGION(Fade_Flag), REGION(Super_Arts),
+    REGION(Forbid_Break), REGION(Request_Break), REGION(Continue_Count), REGION(Personal_Continue_Flag),
+    REGION(Personal_Disp_Flag), REGION(win_pause_go), REGION(request_message), REGION(judge_flag), REGION(WINNER),
+    REGION(LOSER), REGION(New_Challenger), REGION(Champion), REGION(Fade_Half_Flag), REGION(Reserve_Cut),
+    REGION(Perfect_Flag), REGION(Next_Step), REGION(Switch_Type), REGION(Cover_Timer), REGION(Personal_Timer),
+    REGION(Request_E_No), REGION(Request_G_No), REGION(Present_Rank), REGION(Best_Grade), REGION(Cursor_Timer),
+    REGION(Demo_Type), REGION(Rank_Type), REGION(Flash_Sign), REGION(Flash_Rank_Time), REGION(Flash_Rank_Interval),
+    REGION(Ranking_X), REGION(Rank), REGION(Rank_X), REGION(E_07_Flag), REGION(Complete_Victory), REGION(Demo_Flag),
+    REGION(Next_Demo), REGION(Demo_PL_Index), REGION(Demo_Stage_Index), REGION(Face_MV_Request), REGION(Face_Move),
+    REGION(Appear_Cursor), REGION(Select_Timer), REGION(Time_Stop), REGION(Time_Over), REGION(Player_id),
+    REGION(Last_Player_id), REGION(Player_Number), REGION(DENJIN_Term), REGION(Rapid_No), REGION(COM_id), REGION(EM_id),
+    REGION(Select_Status), REGION(Select_Demo_Index), REGION(Country), REGION(Demo_Time_Stop), REGION(Combo_Speed),
+    REGION(Exec_Wipe), REGION(Passive_Mode), REGION(Passive_Flag), REGION(Flip_Flag), REGION(Lie_Flag),
+    REGION(Counter_Attack), REGION(Attack_Flag), REGION(Limited_Flag), REGION(Shell_Ignore_Timer),
+    REGION(Event_Judge_Gals), REGION(EJG_index), REGION(Guard_Flag), REGION(Pierce_Menu), REGION(Face_MV_Time),
+    REGION(Before_Jump), REGION(Stop_Combo), REGION(Stock_Hit_Flag), REGION(Rolling_Flag), REGION(Continue_Coin),
+    REGION(Ignore_Entry), REGION(Slide_Type), REGION(Moving_Plate), REGION(Naming_Cut), REGION(Moving_Plate_Counter),
+    REGION(Player_Color), REGION(PP_Priority), REGION(OK_Priority), REGION(Stock_My_char), REGION(Stock_Player_Color),
+    REGION(Usage), REGION(Music_Fade), REGION(Stop_SG), REGION(Operator_Status), REGION(Round_Operator),
+    REGION(another_bg), REGION(Last_Super_Arts), REGION(Last_My_char), REGION(Continue_Menu), REGION(Timer_Freeze),
+    REGION(Type_of_Attack), REGION(Standing_Timer), REGION(Before_Look), REGION(Attack_Count_No0),
+    REGION(Standing_Master_Timer), REGION(PB_Music_Off), REGION(No_Death), REGION(Flash_MT), REGION(Squat_Timer),
+    REGION(Squat_Master_Timer), REGION(Turn_Over), REGION(Turn_Over_Timer), REGION(Jump_Pass_Timer),
+    REGION(sa_gauge_flash), REGION(Receive_Flag), REGION(Disposal_Again), REGION(BGM_Vol), REGION(Used_char),
+    REGION(Break_Com), REGION(aiuchi_flag), REGION(paring_counter), REGION(paring_bonus_r), REGION(paring_ctr_vs),
+    REGION(paring_ctr_ori), REGION(Attack_Count_Buff), REGION(Attack_Count_Index), REGION(CC_Value),
+    REGION(Continue_Coin2), REGION(Weak_PL), REGION(Bullet_No), REGION(Bullet_Counter), REGION(Final_Result_id),
+    REGION(Disp_Win_Name), REGION(Perfect_Counter), REGION(Straight_Counter), REGION(Appear_Q), REGION(Cut_Scroll),
+    REGION(Break_Into_CPU), REGION(ID_of_Face), REGION(Cursor_Move), REGION(Auto_Cursor), REGION(Auto_No),
+    REGION(Auto_Index), REGION(Auto_Timer), REGION(ID2), REGION(Explosion), REGION(Introduce_Break_Into),
+    REGION(gouki_wins), REGION(EM_Rank), REGION(Disp_PERFECT), REGION(Escape_SS), REGION(Deley_Shot_No),
+    REGION(Deley_Shot_Timer), REGION(Lost_Round), REGION(Super_Arts_Finish), REGION(Stage_SA_Finish),
+    REGION(Perfect_Finish), REGION(Cheap_Finish), REGION(Last_My_char2), REGION(gouki_app), REGION(Bonus_Game_Complete),
+    REGION(Get_Demo_Index), REGION(Combo_Demo_Flag), REGION(Stage_Continue), REGION(Pause_Hit_Marks),
+    REGION(Extra_Break), REGION(Shin_Gouki_BGM), REGION(Stage_Lost_Round), REGION(Stage_Perfect_Finish),
+    REGION(Stage_Cheap_Finish), REGION(EXE_obroll), REGION(End_PL), REGION(Stock_Com_Arts), REGION(PB_Status),
+    REGION(Flip_Counter), REGION(Stage_Time_Finish), REGION(Bonus_Type), REGION(Completion_Bonus), REGION(ichikannkei),
+    REGION(Complete_Face), REGION(Plate_Disposal_No), REGION(SO_No), REGION(Disp_Command_Name), REGION(SC_No),
+    POINTER_REGION(Free_Ptr), REGION(BGM_No), REGION(BGM_Timer), REGION(EM_List), REGION(Sel_EM_Complete),
+    REGION(Temporary_EM), REGION(OK_Moving_SA_Plate), REGION(Battle_Q), REGION(EM_History), REGION(Scene_Cut),
+    REGION(GO_No), REGION(Aborigine), REGION(Continue_Count_Down), REGION(WGJ_Target), REGION(EM_Candidate),
+    REGION(Last_Selected_EM), REGION(Q_Country), REGION(Continue_Cut), REGION(Introduce_Boss), REGION(Suicide),
+    REGION(Final_Play_Type), REGION(Rank_In), REGION(Request_Disp_Rank), REGION(Reset_Timer), REGION(bbbs_type),
+    REGION(Straight_Flag), REGION(kakushi_ix), REGION(kakushi_op), REGION(RO_backup), REGION(PT_backup),
+    REGION(E_Number), REGION(E_No), REGION(C_No), REGION(S_No), REGION(G_No), REGION(D_No), REGION(M_No),
+    REGION(Exit_No), REGION(SP_No), REGION(Face_No), REGION(Select_Start), REGION(Cursor_X), REGION(Cursor_Y),
+    REGION(Cursor_Y_Pos), REGION(Stop_Cursor), REGION(Training_Index), REGION(Connect_Status), REGION(Menu_Suicide),
+    REGION(Game_pause), REGION(Game_difficulty), REGION(Pause), REGION(Pause_ID), REGION(Play_Type), REGION(Exit_Menu),
+    REGION(Conclusion_Flag), REGION(CP_No), REGION(CP_Index), REGION(Gap_Timer), REGION(Message_Suicide),
+    REGION(Disp_Cockpit), REGION(Select_Arts), REGION(Lamp_No), REGION(Lamp_Index), REGION(Lamp_Color),
+    REGION(Stop_Update_Score), REGION(test_flag), REGION(ixbfw_cut), REGION(Cont_No), REGION(PL_Wins),
+    REGION(Fade_R_No0), REGION(Fade_R_No1), REGION(Conclusion_Type), REGION(win_type), REGION(message_index),
+    REGION(F_No0), REGION(F_No1), REGION(F_No2), REGION(F_No3), REGION(keep_condition), REGION(Check_Buff),
+    REGION(Convert_Buff), REGION(Unsubstantial_BG), REGION(Menu_Cursor_X), REGION(Menu_Cursor_Y), REGION(Replay_Status),
+    REGION(Disappear_LOGO), REGION(count_end), REGION(Play_Game), REGION(Menu_Cursor_Move), REGION(flash_win_type),
+    REGION(sync_win_type), REGION(Mode_Type), REGION(Menu_Page), REGION(Menu_Max), REGION(reset_NG_flag),
+    REGION(VS_Stage), REGION(Present_Mode), REGION(Play_Mode), REGION(Page_Max), REGION(Direction_Working),
+    REGION(Vital_Handicap), REGION(Cursor_Limit), REGION(Synchro_No), REGION(SA_shadow_on), REGION(Pause_Down),
+    REGION(Training_ID), REGION(Disp_Attack_Data), REGION(Record_Data_Tr), REGION(End_Training), REGION(Menu_Page_Buff),
+    REGION(Reset_Bootrom), REGION(Decide_ID), REGION(Training_Cursor), REGION(Lag_Timer), POINTER_REGION(Lag_Ptr),
+    REGION(CPU_Time_Lag), REGION(Forbid_Reset), REGION(CPU_Rec), REGION(Pause_Type), REGION(Game_timer),
+    REGION(Control_Time), REGION(Time_in_Time), REGION(Round_Level), REGION(Round_Result), REGION(Fade_Number),
+    REGION(G_Timer), REGION(D_Timer), REGION(Rank_Pos_X), REGION(Rank_Pos_Y), REGION(E_Timer), REGION(F_Timer),
+    REGION(ENTRY_X), REGION(C_Timer), REGION(S_Timer), REGION(Flash_Complete), REGION(Sel_PL_Complete),
+    REGION(Sel_Arts_Complete), REGION(Arts_Y), REGION(Move_Super_Arts), REGION(Battle_Country), REGION(Face_Status),
+    REGION(Unit_Of_Timer), REGION(ID), REGION(mes_already), REGION(Timer_00), REGION(Timer_01), REGION(PL_Distance),
+    REGION(Area_Number), REGION(Lever_Buff), REGION(Lever_Pool), REGION(Tech_Index), REGION(Random_ix16),
+    REGION(Random_ix32), REGION(M_Timer), REGION(VS_Tech), REGION(Guard_Type), REGION(Separate_Area),
+    REGION(Free_Lever), REGION(Term_No), REGION(Com_Width_Data), REGION(Lever_Squat), REGION(M_Lv), REGION(Insert_Y),
+    REGION(scr_req_x), REGION(scr_req_y), REGION(zoom_req_flag_old), REGION(zoom_request_flag),
+    REGION(zoom_request_level), REGION(Last_Selected_ID), REGION(Last_Called_SE), REGION(VS_Index), REGION(Rapid_Index),
+    REGION(Shell_Separate_Area), REGION(Attack_Counter), REGION(Last_Attack_Counter), REGION(Pattern_Index),
+    REGION(Com_Color_Shot), REGION(Resume_Lever), REGION(players_timer), REGION(Lever_Store), REGION(Return_CP_No),
+    REGION(Return_CP_Index), REGION(Return_Pattern_Index), REGION(Lever_LR), REGION(Last_Eftype), REGION(DENJIN_No),
+    REGION(SC_Personal_Time), REGION(Guard_Counter), REGION(Limit_Time), REGION(Last_Pattern_Index),
+    REGION(Random_ix16_ex), REGION(Random_ix32_ex), REGION(DE_X), REGION(Exit_Timer), REGION(Max_vitality),
+    REGION(Bonus_Game_Flag), REGION(Bonus_Game_Work), REGION(Bonus_Game_result), REGION(Stock_Bonus_Game_Result),
+    REGION(bs_scrrrl), REGION(Bonus_Stage_RNO), REGION(Bonus_Stage_Level), REGION(Bonus_Stage_Tix),
+    REGION(Bonus_Game_ex_result), REGION(Stock_Com_Color), REGION(bs2_floor), REGION(bs2_hosei),
+    REGION(bs2_current_damage), REGION(Win_Record), REGION(Stock_Win_Record), REGION(WGJ_Win), REGION(Target_BG_X),
+    REGION(Offset_BG_X), REGION(Result_Timer), REGION(scrl), REGION(scrr), REGION(vital_stop_flag),
+    REGION(gauge_stop_flag), REGION(Lamp_Timer), REGION(Cont_Timer), POINTER_REGION(Demo_Ptr), REGION(Plate_X),
+    REGION(Plate_Y), REGION(Demo_Timer), REGION(Condense_Buff), REGION(Keep_Grade), REGION(IO_Result),
+    REGION(VS_Win_Record), REGION(plsw_00), REGION(plsw_01), REGION(Flash_Synchro), REGION(Synchro_Level),
+    REGION(Random_ix16_com), REGION(Random_ix32_com), REGION(Random_ix16_ex_com), REGION(Random_ix32_ex_com),
+    REGION(Random_ix16_bg), REGION(Opening_Now),
+    // WORK_SYS.h
+    REGION(Zoom_Base_Position_Z), REGION(Zoom_Base_Position_Y), REGION(Zoom_Base_Position_X), REGION(Frame_Zoom_Y),
+    REGION(Frame_Zoom_X), REGION(SA_Zoom_Y), REGION(SA_Zoom_X), REGION(Screen_Zoom_Y), REGION(Screen_Zoom_X),
+    REGION(scr_sc), REGION(sca_y), REGION(sca_x), REGION(bg_prm), REGION(fm_pos), REGION(bg_pos), REGION(Screen_PAL),
+    REGION(PLsw), REGION(Gill_Appear_Flag), REGION(Interrupt_Timer), REGION(p4sw_buff), REGION(p3sw_buff),
+    REGION(p2sw_buff), REGION(p1sw_buff), REGION(Interrupt_Flag), REGION(Correct_Y), REGION(Correct_X),
+    REGION(Turbo_Timer), REGION(Turbo), REGION(No_Trans), REGION(Disp_Size_V), REGION(Disp_Size_H),
+    REGION(Y_Adjust_Buff), REGION(X_Adjust_Buff), REGION(Y_Adjust), REGION(X_Adjust), REGION(Interface_Type),
+    REGION(system_timer), REGION(Process_Counter), REGION(p4sw_1), REGION(p4sw_0), REGION(p3sw_1), REGION(p3sw_0),
+    REGION(p2sw_1), REGION(p2sw_0), REGION(p1sw_1), REGION(p1sw_0), REGION(ck_ex_option), POINTER_REGION(vm_w),
+    REGION(sys_w), REGION(current_task_num), REGION(save_w), REGION(permission_player), REGION(system_dir),
+    POINTER_REGION(Replay_w), POINTER_REGION(Rep_Game_Infor), POINTER_REGION(task), REGION(BgMATRIX), REGION(Training),
+    // PLCNT.h
+    REGION(pcon_rno), REGION(appear_type), REGION(round_slow_flag), REGION(pcon_dp_flag), REGION(win_sp_flag),
+    REGION(dead_voice_flag), REGION(super_arts), REGION(piyori_type), REGION(rambod), REGION(ramhan),
+    REGION(omop_spmv_ng_table), REGION(omop_spmv_ng_table2), REGION(vital_inc_timer), REGION(vital_dec_timer),
+    REGION(cmd_sel), REGION(vib_sel), REGION(sag_inc_timer), REGION(no_sa), REGION(combo_type), REGION(remake_power),
+    POINTER_REGION(plw), REGION(zanzou_table),
+    // EFFECT.h
+    REGION(exec_tm), POINTER_REGION(frw), REGION(head_ix), REGION(tail_ix), REGION(frwctr_min), REGION(frwctr),
+    REGION(frwque),
+    // HITCHECK.h
+    POINTER_REGION(hs), POINTER_REGION(q_hit_push), REGION(ca_check_flag), REGION(grdb), REGION(grdb2),
+    POINTER_REGION(dmdat_adrs), REGION(mkm_wk), REGION(hpq_in),
+    // cmd_data.h
+    REGION(wcp), REGION(t_pl_lvr), POINTER_REGION(waza_work), REGION(cmd_id), POINTER_REGION(cmd_tbl_ptr),
+    REGION(sw_work), POINTER_REGION(chk_pl), REGION(waza_type), POINTER_REGION(waza_ptr), POINTER_REGION(cmd_pl),
+    REGION(lvr_chk_tbl),
+    // bg.h
+    REGION(bgPalCodeOffset), REGION(Screen_Switch_Buffer), REGION(Screen_Switch), POINTER_REGION(bg_w),
+    REGION(bg_disp_off), REGION(bg_priority), REGION(rw_num), REGION(rw_bg_flag), REGION(tokusyu_stage),
+    REGION(rw_gbix), REGION(stage_flash), REGION(stage_ftimer), REGION(yang_ix_plus), REGION(yang_ix),
+    REGION(yang_timer), REGION(ending_flag), REGION(end_prm), REGION(gouki_end_gbix), POINTER_REGION(rw3col_ptr),
+    POINTER_REGION(rw_dat),
+    // bg_data.h
+    REGION(y_sitei_pos), REGION(y_sitei_flag), REGION(c_number), REGION(c_kakikae), REGION(g_number), REGION(g_kakikae),
+    REGION(nosekae), POINTER_REGION(scr_bcm), REGION(scrn_adgjust_y), REGION(scrn_adgjust_x), REGION(zoom_add),
+    REGION(ls_cnt1), REGION(bg_app), REGION(sa_pa_flag), REGION(aku_flag), REGION(seraph_flag), REGION(akebono_flag),
+    REGION(bg_mvxy), REGION(chase_time_y), REGION(chase_time_x), REGION(chase_y), REGION(chase_x),
+    REGION(demo_car_flag), REGION(ideal_w), POINTER_REGION(bgw_ptr), REGION(bg_app_stop), REGION(bg_stop),
+    REGION(base_y_pos), REGION(etcBgPalCnvTable), REGION(etcBgGixCnvTable),
+    // count.h
+    REGION(round_timer), REGION(flash_timer), REGION(flash_r_num), REGION(flash_col), REGION(math_counter_hi),
+    REGION(math_counter_low), REGION(counter_color), REGION(mugen_flag), REGION(hoji_counter),
+    // SLOWF.h
+    REGION(SLOW_timer), REGION(SLOW_flag), REGION(EXE_flag),
+    // Grade.h
+    REGION(judge_gals), REGION(judge_com), REGION(judge_final), REGION(judge_item), REGION(last_judge_dada),
+    REGION(ji_sat),
+    // cmb_win.h
+    REGION(cst_write), REGION(cst_read), REGION(last_hit_time), REGION(sarts_finish_flag), REGION(score_calc),
+    REGION(calc_hit), REGION(end_flag), REGION(sa_kind), REGION(hit_num), REGION(bonus_pts), REGION(paring_attack),
+    REGION(rever_attack), REGION(first_attack), REGION(cmb_stock), REGION(old_cmb_flag), REGION(cmst_buff),
+    { cmb_calc_now, 2, "cmb_calc_now", false }, { cmb_all_stock, 1, "cmb_all_stock", false },
+    // SysDir.h
+    REGION(omop_dokidoki), REGION(omop_round_timer), REGION(omop_cockpit), REGION(omop_sa_bar_disp),
+    REGION(omop_st_bar_disp), REGION(omop_vt_bar_disp), REGION(omop_vital_init), REGION(omop_sag_len_ix),
+    REGION(omop_sag_max_ix), REGION(omop_vital_ix), REGION(omop_r_block_ix), REGION(omop_b_block_ix),
+    REGION(omop_otedama_ix), REGION(omop_stun_gauge_len), REGION(omop_stun_gauge_rcv), REGION(omop_stun_gauge_add),
+    REGION(omop_sa_gauge_ix), REGION(omop_guard_distance_ix), REGION(omop_use_ex_gauge_ix), REGION(chainex_check),
+    // n_input.h
+    REGION(rank_name_w), REGION(Name_00), REGION(name_wk), POINTER_REGION(name_ptr), REGION(Name_Input_f),
+    REGION(naming_cnt), REGION(n_disp_flag), REGION(name_limit_timer), REGION(ne_flash_flag),
+    POINTER_REGION(ne_pointer), REGION(ne_col), REGION(ne_timer), REGION(sc_name_wk), POINTER_REGION(nsc_ptr),
+    // EFFB8.h
+    REGION(old_mes_no2), REGION(old_mes_no3), REGION(old_mes_no_pl), REGION(test_pl_no), REGION(test_mes_no),
+    REGION(test_in), REGION(mes_timer),
+    // EFF45.h
+    REGION(Message_Data),
+    // GD3rd.h
+    REGION(plt_req), POINTER_REGION(q_ldreq), REGION(ldreq_result), REGION(ldreq_break), REGION(ldreq_pushed),
+    // Reset.h
+    REGION(Reset_Status), REGION(RESET_X),
+    // effb2.h
+    REGION(rf_b2_flag), REGION(b2_curr_no),
+    // sel_pl.h
+    REGION(Play_Type_1st), REGION(SEL_PL_X), REGION(Color7), REGION(Decide_Stage), REGION(hc3alpha),
+    REGION(hc3alphaadd),
+    // ta_sub.h
+    REGION(eff_hit_flag),
+    // IOConv.h
+    REGION(io_w),
+    // main.h
+    POINTER_REGION(mpp_w),
+    // Debug.h
+    REGION(sysFF), REGION(sysSLOW), REGION(Slow_Timer), REGION(Record_Timer),
+    // BCD.h
+    REGION(bcdext),
+    // CHARSET.h
+    REGION(att_req),
+    // Ck_Pass.h
+    REGION(PASSIVE_X),
+    // Com_Sub.h
+    REGION(Lv), REGION(Rnd),
+    // Continue.h
+    REGION(CONTINUE_X),
+    // DEMO00.h
+    REGION(picon_no), REGION(picon_level),
+    // EFF56.h
+    POINTER_REGION(ci_pointer), REGION(ci_col), REGION(ci_timer),
+    // EFF77.h
+    REGION(chk77_flag),
+    // EFFA6.h
+    REGION(effa6_pos_x_1p), REGION(effa6_pos_y_1p), REGION(effa6_pos_z_1p), REGION(effa6_pos_x_2p),
+    REGION(effa6_pos_y_2p), REGION(mmes_already),
+    // EFFF9.h
+    POINTER_REGION(efff9_txt_no_adrs), POINTER_REGION(efff9_txt_scene_adrs), REGION(efff9_suicide), REGION(efff9_PL_NO),
+    REGION(efff9_txt_point), REGION(efff9_message), REGION(keep_mes_no),
+    // EFFH6.h
+    REGION(roll_rate_t), REGION(roll_rate),
+    // Eff79.h
+    REGION(OK_Appear79), REGION(Extra_Counter),
+    // Eff95.h
+    REGION(RND_95), REGION(END_OF_95),
+    // EffA2.h
+    POINTER_REGION(hnc_pointer), REGION(hnc_timer), REGION(hnc_end_timer), REGION(hnc_col),
+    // Entry.h
+    REGION(letter_stack), REGION(letter_counter), POINTER_REGION(letter_ptr),
+    // GameOver.h
+    REGION(GAME_OVER_X),
+    // Manage.h
+    REGION(Disp_Bonus_Contents), REGION(MANAGE_X),
+    // Next_CPU.h
+    REGION(SEL_CPU_X), REGION(Start_X),
+    // OPENING.h
+    REGION(op_obj_disp), REGION(op_scrn_end), REGION(title_tex_flag), REGION(op_timer0), REGION(op_w),
+    REGION(music_scene), REGION(music_time), REGION(op_plmove_timer), POINTER_REGION(opw_ptr), REGION(op_end_flag),
+    REGION(op_demo_index), REGION(op_sound_status), REGION(op_bg_mvxy),
+    // Pause.h
+    REGION(PAUSE_X), REGION(Stock_Turbo_Timer), REGION(Stock_Process_Counter),
+    // PulPul.h
+    REGION(vib_req), REGION(pulpul_scene), POINTER_REGION(ppwork), REGION(pul),
+    // RANKING.h
+    REGION(Present_Data), REGION(Ranking_Data),
+    // SYS_sub.h
+    REGION(Candidate_Buff),
+    // VITAL.h
+    REGION(vit),
+    // Win.h
+    REGION(WIN_X),
+    // animation/appear.h
+    REGION(Appear_car_stop), REGION(Appear_hv), REGION(Appear_free), REGION(Appear_flag), REGION(app_counter),
+    REGION(appear_work), REGION(Appear_end),
+    // animation/lose_pl.h
+    REGION(lose_rno), REGION(lose_free),
+    // animation/win_pl.h
+    REGION(win_free), REGION(a_rno), REGION(win_rno), REGION(poison_flag),
+    // effb3.h
+    POINTER_REGION(oya_adrs),
+    // effb9.h
+    POINTER_REGION(oya_p),
+    // effl8.h
+    REGION(spmv_ng_save),
+    // end_0.h
+    REGION(gill_quake_flag2), REGION(fade_prio), REGION(gill_quake_flag),
+    // end_14.h
+    REGION(gxy),
+    // end_5.h
+    REGION(bdl_index), REGION(wr5_index), REGION(end_5_flag),
+    // end_data.h
+    REGION(staff_r_no), REGION(end_name_cut), REGION(end_fade_timer), REGION(end_staff_flag), REGION(end_no_cut),
+    REGION(end_fade_flag), REGION(ending_all_end), REGION(end_etc_flag), REGION(e_line_step), REGION(end_w),
+    // init3rd.h
+    REGION(Keep_Zoom_X), REGION(Test_Cursor),
+    // menu.h
+    REGION(r_no_plus), REGION(control_player), REGION(control_pl_rno),
+    // plpat14.h
+    REGION(stop_count),
+    // sc_data.h
+    REGION(tr_data),
+    // sc_sub.h
+    REGION(WipeLimit), REGION(FadeLimit), REGION(Hnc_Num), REGION(fd_dat),
+    // spgauge.h
+    REGION(Old_Stop_SG), REGION(Exec_Wipe_F), REGION(time_clear), REGION(spg_number), REGION(spg_work),
+    REGION(spg_offset), REGION(time_num), REGION(time_timer), REGION(time_flag), REGION(col), REGION(time_operate),
+    REGION(sast_now), REGION(max2), REGION(max_rno2), POINTER_REGION(spg_dat),
+    // staff.h
+    REGION(roll_rate2), REGION(roll_rate_t2), REGION(roll_stop), REGION(name_timer), REGION(staffroll_end),
+    REGION(staff_name_ptr),
+    // stun.h
+    REGION(sdat),
+    // mlPAD.c
+    POINTER_REGION(flpad_root), POINTER_REGION(flpad_conf),
+};
+
+size_t GameState_GetSize() {
+    size_t size = 0;
+
+    for (int i = 0; i < SDL_arraysize(regions); i++) {
+        size += regions[i].size;
+    }
+
+    return size;
+}
+
+void GameState_Save(void* buffer) {
+    Uint8* dst = buffer;
+
+    for (int i = 0; i < SDL_arraysize(regions); i++) {
+        SDL_memcpy(dst, regions[i].data, regions[i].size);
+        dst += regions[i].size;
+    }
+}
+
+void GameState_Load(const void* buffer) {
+    const Uint8* src = buffer;
+
+    for (int i = 0; i < SDL_arraysize(regions); i++) {
+        SDL_memcpy(regions[i].data, src, regions[i].size);
+        src += regions[i].size;
+    }
+}
+
+void GameState_SetSpeculative(bool speculative) {
+    is_speculative = speculative;
+}
+
+bool GameState_IsSpeculative() {
+    return is_speculative;
+}
+
+void GameState_SetRollbackEnabled(bool enabled) {
+    is_rollback_enabled = enabled;
+}
+
+bool GameState_IsLoadQueueHeld(bool has_new_request) {
+    // Any frame may be rolled back, but only to its start. A request made during the frame is
+    // undone with the rest of the snapshot as long as the queue waits a step before starting it.
+    if (is_rollback_enabled) {
+        return has_new_request;
+    }
+
+    // Frames run ahead are always thrown away
+    return is_speculative;
+}
+
+bool GameState_IsLoading() {
+    return !Check_LDREQ_Clear();
+}
+
+bool GameState_IsSaving() {
+    return SaveIsOpen() || Memcard_IsBusy();
+}
+
+uint64_t GameState_HashPlain() {
+    Uint64 hash = 0;
+
+    for (int i = 0; i < SDL_arraysize(regions); i++) {
+        if (!regions[i].has_pointers) {
+            hash = StateHash_HashBytes(regions[i].data, regions[i].size, hash);
+        }
+    }
+
+    return hash;
+}
+
+const char* GameState_GetRegionName(size_t offset) {
+    for (int i = 0; i < SDL_arraysize(regions); i++) {
+        if (offset < regions[i].size) {
+            return regions[i].name;
+        }
+
+        offset -= regions[i].size;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,625 @@
+#include "port/netplay/netplay.h"
+#include "port/bench.h"
+#include "port/config.h"
+#include "port/netplay/game_state.h"
+#include "port/netplay/transport.h"
+#include "port/sdl/sdl_game_renderer.h"
+#include "port/sdl/sdl_message_renderer.h"
+#include "port/state_hash.h"
+
+#include <SDL3/SDL.h>
+
+// Rollback netplay.
+//
+// Both peers run the same simulation. Local input is applied `netplay_delay` frames after it was
+// read and sent to the peer right away, redundantly until the peer acknowledges it, so a lost
+// packet is covered by the next one. When the remote input for a frame hasn't arrived yet, the
+// last known remote input is used in its place. A snapshot of the game state is saved before
+// every frame; once the real input arrives and differs from the prediction, the state is restored
+// to that frame and every frame since is simulated again with drawing and sound requests dropped.
+//
+// The session doesn't let the local side run more than `netplay_max_rollback` frames past the last
+// confirmed remote input, and the side that is ahead of the other skips a frame now and then so
+// neither has to roll back more than the latency requires. Peers exchange state hashes of confirmed
+// frames to catch desyncs.
+//
+// Loading isn't part of a snapshot (see game_state.c), so it only runs on confirmed input. While
+// the load queue is busy the session waits for the remote input instead of predicting it, and a
+// rollback that makes a load request stops resimulating at the first frame whose input is still
+// predicted. The frames after it are run again once their input is in; local input for them was
+// sent already, so it is kept and what the pads read in the meantime is dropped. An open save screen
+// is treated the same way. There is no card during a session (see sdk_libmc.c), but the screen's
+// own work isn't part of a snapshot either.
+//
+// Packets start with a little endian header, followed by the packed pad inputs it carries:
+//
+//     magic "3SXN", delay, frame, ack, first input frame, input count, hash frame, hash (64 bit),
+//     ping, pong
+
+#define PACKET_MAGIC "3SXN"
+#define HEADER_SIZE 44
+#define INPUT_SIZE 48
+#define PACKET_INPUTS_MAX 24
+#define FRAME_RING 256
+#define ROLLBACK_LIMIT 16
+#define DELAY_LIMIT 8
+#define HASH_INTERVAL 8
+#define HASH_RING (FRAME_RING / HASH_INTERVAL)
+#define SYNC_INTERVAL 60
+#define SKIP_FRAMES_MAX 4
+#define RESEND_INTERVAL_MS 16
+#define FRAME_RATE 60
+#define NO_FRAME SDL_MAX_UINT32
+
+typedef struct FrameHash {
+    Uint32 frame;
+    Uint64 hash;
+    bool confirmed;
+} FrameHash;
+
+typedef struct NetplayStats {
+    Uint32 rollbacks;
+    Uint32 resimulated_frames;
+    Uint64 resimulation_ns;
+    Uint64 max_resimulation_ns;
+    Uint32 max_rollback_frames;
+    Uint32 stalls;
+    Uint32 skipped_frames;
+    Uint32 rewound_frames;
+} NetplayStats;
+
+static bool is_active = false;
+static bool is_resimulating = false;
+static int delay = 2;
+static int max_rollback = 8;
+static int local_index = 0;
+
+// Frames
+static Uint32 frame = 0;
+static Uint32 sim_frame = 0;
+static bool live_frame_ran = false;
+static Uint32 first_mispredicted = NO_FRAME;
+
+// Inputs, indexed by frame
+static Uint8 local_inputs[FRAME_RING][INPUT_SIZE];
+static Uint8 remote_inputs[FRAME_RING][INPUT_SIZE];
+static Uint8 predicted_inputs[FRAME_RING][INPUT_SIZE];
+static Uint32 local_input_end = 0;
+static Uint32 remote_input_end = 0;
+static Uint32 remote_ack = 0;
+
+// Snapshots
+static Uint8* snapshot_data = NULL;
+static Uint32* snapshot_frames = NULL;
+static size_t snapshot_size = 0;
+static int snapshot_count = 0;
+
+// Desync detection
+static FrameHash local_hashes[HASH_RING];
+static FrameHash remote_hashes[HASH_RING];
+static Uint32 next_hash_frame = HASH_INTERVAL;
+static Uint32 confirmed_hash_frame = 0;
+static bool is_desync_reported = false;
+
+// Peer and time sync
+static bool is_peer_seen = false;
+static bool is_delay_mismatch_reported = false;
+static Uint32 remote_frame = 0;
+static Uint32 last_ping = 0;
+static Uint32 rtt_ms = 0;
+static Uint64 last_send_ms = 0;
+static Uint32 next_sync_frame = SYNC_INTERVAL;
+static int skip_frames = 0;
+static bool is_stalled = false;
+
+static NetplayStats stats = { 0 };
+
+// Serialization
+
+static void put16(Uint8** p, Uint16 value) {
+    value = SDL_Swap16LE(value);
+    SDL_memcpy(*p, &value, sizeof(value));
+    *p += sizeof(value);
+}
+
+static void put32(Uint8** p, Uint32 value) {
+    value = SDL_Swap32LE(value);
+    SDL_memcpy(*p, &value, sizeof(value));
+    *p += sizeof(value);
+}
+
+static void put64(Uint8** p, Uint64 value) {
+    value = SDL_Swap64LE(value);
+    SDL_memcpy(*p, &value, sizeof(value));
+    *p += sizeof(value);
+}
+
+static Uint16 get16(const Uint8** p) {
+    Uint16 value;
+    SDL_memcpy(&value, *p, sizeof(value));
+    *p += sizeof(value);
+    return SDL_Swap16LE(value);
+}
+
+static Uint32 get32(const Uint8** p) {
+    Uint32 value;
+    SDL_memcpy(&value, *p, sizeof(value));
+    *p += sizeof(value);
+    return SDL_Swap32LE(value);
+}
+
+static Uint64 get64(const Uint8** p) {
+    Uint64 value;
+    SDL_memcpy(&value, *p, sizeof(value));
+    *p += sizeof(value);
+    return SDL_Swap64LE(value);
+}
+
+/// @brief Pack everything of a pad but the connection info, which holds a device handle.
+static void pack_pad(const TARPAD* pad, Uint8* out) {
+    Uint8* p = out;
+
+    *p++ = pad->state;
+    *p++ = pad->anstate;
+    put16(&p, pad->kind);
+    put32(&p, pad->sw);
+    SDL_memcpy(p, pad->anshot.pow, sizeof(pad->anshot.pow));
+    p += sizeof(pad->anshot.pow);
+
+    for (int i = 0; i < 2; i++) {
+        const PAD_STICK* stick = &pad->stick[i];
+        Uint32 rad;
+
+        SDL_memcpy(&rad, &stick->rad, sizeof(rad));
+        put16(&p, stick->x);
+        put16(&p, stick->y);
+        put16(&p, stick->pow);
+        put16(&p, stick->ang);
+        put32(&p, rad);
+    }
+
+    SDL_assert(p - out == INPUT_SIZE);
+}
+
+static void unpack_pad(const Uint8* in, TARPAD* pad) {
+    const Uint8* p = in;
+
+    pad->state = *p++;
+    pad->anstate = *p++;
+    pad->kind = get16(&p);
+    pad->sw = get32(&p);
+    SDL_memcpy(pad->anshot.pow, p, sizeof(pad->anshot.pow));
+    p += sizeof(pad->anshot.pow);
+
+    for (int i = 0; i < 2; i++) {
+        PAD_STICK* stick = &pad->stick[i];
+
+        stick->x = get16(&p);
+        stick->y = get16(&p);
+        stick->pow = get16(&p);
+        stick->ang = get16(&p);
+        const Uint32 rad = get32(&p);
+        SDL_memcpy(&stick->rad, &rad, sizeof(rad));
+    }
+}
+
+// Packets
+
+static void send_packet() {
+    Uint8 buffer[HEADER_SIZE + PACKET_INPUTS_MAX * INPUT_SIZE];
+    Uint8* p = buffer;
+    const Uint32 first_input = remote_ack;
+    const Uint32 input_count = SDL_min(local_input_end - first_input, PACKET_INPUTS_MAX);
+    const FrameHash* hash = &local_hashes[(confirmed_hash_frame / HASH_INTERVAL) % HASH_RING];
+
+    SDL_memcpy(p, PACKET_MAGIC, 4);
+    p += 4;
+    put32(&p, delay);
+    put32(&p, frame);
+    put32(&p, remote_input_end);
+    put32(&p, first_input);
+    put32(&p, input_count);
+    put32(&p, confirmed_hash_frame);
+    put64(&p, (confirmed_hash_frame > 0) ? hash->hash : 0);
+    put32(&p, (Uint32)SDL_GetTicks());
+    put32(&p, last_ping);
+
+    for (Uint32 i = 0; i < input_count; i++) {
+        SDL_memcpy(p, local_inputs[(first_input + i) % FRAME_RING], INPUT_SIZE);
+        p += INPUT_SIZE;
+    }
+
+    Transport_Send(buffer, p - buffer);
+    last_send_ms = SDL_GetTicks();
+}
+
+static void compare_hashes(Uint32 hash_frame) {
+    const FrameHash* local = &local_hashes[(hash_frame / HASH_INTERVAL) % HASH_RING];
+    const FrameHash* remote = &remote_hashes[(hash_frame / HASH_INTERVAL) % HASH_RING];
+
+    if (is_desync_reported || (local->frame != hash_frame) || !local->confirmed || (remote->frame != hash_frame)) {
+        return;
+    }
+
+    if (local->hash != remote->hash) {
+        SDL_Log("Netplay desync at frame %u: state hash %016" SDL_PRIx64 ", peer has %016" SDL_PRIx64,
+                hash_frame,
+                local->hash,
+                remote->hash);
+        is_desync_reported = true;
+    }
+}
+
+static void receive_inputs(Uint32 first_input, Uint32 input_count, const Uint8* inputs) {
+    for (Uint32 i = 0; i < input_count; i++) {
+        const Uint32 input_frame = first_input + i;
+        const Uint8* input = &inputs[i * INPUT_SIZE];
+
+        if (input_frame < remote_input_end) {
+            continue;
+        }
+
+        if (input_frame > remote_input_end) {
+            break;
+        }
+
+        SDL_memcpy(remote_inputs[input_frame % FRAME_RING], input, INPUT_SIZE);
+
+        if ((input_frame < frame) && (input_frame < first_mispredicted) &&
+            (SDL_memcmp(predicted_inputs[input_frame % FRAME_RING], input, INPUT_SIZE) != 0)) {
+            first_mispredicted = input_frame;
+        }
+
+        remote_input_end += 1;
+    }
+}
+
+static void handle_packet(const Uint8* data, size_t size) {
+    const Uint8* p = data;
+
+    if ((size < HEADER_SIZE) || (SDL_memcmp(p, PACKET_MAGIC, 4) != 0)) {
+        return;
+    }
+
+    p += 4;
+    const Uint32 peer_delay = get32(&p);
+    const Uint32 peer_frame = get32(&p);
+    const Uint32 ack = get32(&p);
+    const Uint32 first_input = get32(&p);
+    const Uint32 input_count = get32(&p);
+    const Uint32 hash_frame = get32(&p);
+    const Uint64 hash = get64(&p);
+    const Uint32 ping = get32(&p);
+    const Uint32 pong = get32(&p);
+
+    if (peer_delay != delay) {
+        if (!is_delay_mismatch_reported) {
+            SDL_Log("Netplay peer uses an input delay of %u frames, this side %d. Both have to match",
+                    peer_delay,
+                    delay);
+            is_delay_mismatch_reported = true;
+        }
+
+        return;
+    }
+
+    if (!is_peer_seen) {
+        SDL_Log("Connected to netplay peer");
+        is_peer_seen = true;
+    }
+
+    remote_frame = SDL_max(remote_frame, peer_frame);
+    remote_ack = SDL_max(remote_ack, ack);
+    last_ping = ping;
+
+    if (pong != 0) {
+        const Uint32 sample = (Uint32)SDL_GetTicks() - pong;
+        rtt_ms = (rtt_ms == 0) ? sample : (rtt_ms * 7 + sample) / 8;
+    }
+
+    if ((input_count <= PACKET_INPUTS_MAX) && (size >= HEADER_SIZE + input_count * INPUT_SIZE)) {
+        receive_inputs(first_input, input_count, p);
+    }
+
+    if ((hash_frame > 0) && (hash_frame % HASH_INTERVAL == 0)) {
+        FrameHash* remote = &remote_hashes[(hash_frame / HASH_INTERVAL) % HASH_RING];
+        remote->frame = hash_frame;
+        remote->hash = hash;
+        compare_hashes(hash_frame);
+    }
+}
+
+static void receive_packets() {
+    Uint8 buffer[TRANSPORT_PACKET_SIZE_MAX];
+    size_t size;
+
+    while ((size = Transport_Receive(buffer, sizeof(buffer))) > 0) {
+        handle_packet(buffer, size);
+    }
+}
+
+// Snapshots
+
+static void save_snapshot(Uint32 snapshot_frame) {
+    const int index = snapshot_frame % snapshot_count;
+
+    GameState_Save(&snapshot_data[index * snapshot_size]);
+    snapshot_frames[index] = snapshot_frame;
+
+    if (snapshot_frame % HASH_INTERVAL == 0) {
+        FrameHash* local = &local_hashes[(snapshot_frame / HASH_INTERVAL) % HASH_RING];
+        StateHash hash;
+
+        StateHash_Compute(&hash);
+        local->frame = snapshot_frame;
+        local->hash = hash.total;
+        local->confirmed = false;
+    }
+}
+
+static bool load_snapshot(Uint32 snapshot_frame) {
+    const int index = snapshot_frame % snapshot_count;
+
+    if (snapshot_frames[index] != snapshot_frame) {
+        return false;
+    }
+
+    GameState_Load(&snapshot_data[index * snapshot_size]);
+    return true;
+}
+
+/// @brief Hashes of frames whose inputs are all known and that won't be resimulated are final.
+static void confirm_hashes() {
+    while ((next_hash_frame <= remote_input_end) && (next_hash_frame < frame)) {
+        FrameHash* local = &local_hashes[(next_hash_frame / HASH_INTERVAL) % HASH_RING];
+
+        if (local->frame == next_hash_frame) {
+            local->confirmed = true;
+            confirmed_hash_frame = next_hash_frame;
+            compare_hashes(next_hash_frame);
+        }
+
+        next_hash_frame += HASH_INTERVAL;
+    }
+}
+
+static void set_draw_enabled(bool enabled) {
+    SDLGameRenderer_SetDrawEnabled(enabled);
+    SDLMessageRenderer_SetDrawEnabled(enabled);
+}
+
+static void rollback(NetplaySimulateFrame simulate) {
+    if (first_mispredicted >= frame) {
+        first_mispredicted = NO_FRAME;
+        return;
+    }
+
+    const Uint32 rollback_frame = first_mispredicted;
+    first_mispredicted = NO_FRAME;
+
+    if (!load_snapshot(rollback_frame)) {
+        SDL_Log("Netplay can't roll back to frame %u, the snapshot is gone", rollback_frame);
+        return;
+    }
+
+    const Uint64 start = SDL_GetTicksNS();
+    is_resimulating = true;
+    GameState_SetSpeculative(true);
+    set_draw_enabled(false);
+
+    for (sim_frame = rollback_frame; sim_frame < frame; sim_frame++) {
+        // Loading and saving only run on confirmed input, the frames from here on are run again live
+        if ((sim_frame >= remote_input_end) && (GameState_IsLoading() || GameState_IsSaving())) {
+            stats.rewound_frames += frame - sim_frame;
+            frame = sim_frame;
+            break;
+        }
+
+        if (sim_frame != rollback_frame) {
+            save_snapshot(sim_frame);
+        }
+
+        simulate();
+    }
+
+    set_draw_enabled(true);
+    GameState_SetSpeculative(false);
+    is_resimulating = false;
+
+    const Uint64 elapsed = SDL_GetTicksNS() - start;
+    const Uint32 frames = frame - rollback_frame;
+    stats.rollbacks += 1;
+    stats.resimulated_frames += frames;
+    stats.resimulation_ns += elapsed;
+    stats.max_resimulation_ns = SDL_max(stats.max_resimulation_ns, elapsed);
+    stats.max_rollback_frames = SDL_max(stats.max_rollback_frames, frames);
+}
+
+/// @brief Let the peer catch up if this side runs ahead of it.
+static void sync_time() {
+    if (!is_peer_seen || (frame < next_sync_frame)) {
+        return;
+    }
+
+    next_sync_frame = frame + SYNC_INTERVAL;
+    const Uint32 remote_estimate = remote_frame + (rtt_ms / 2) * FRAME_RATE / 1000;
+    const int advantage = (int)(frame - remote_estimate);
+
+    if (advantage >= 2) {
+        skip_frames = SDL_min(advantage / 2, SKIP_FRAMES_MAX);
+    }
+}
+
+static void resend_if_idle() {
+    if (SDL_GetTicks() - last_send_ms >= RESEND_INTERVAL_MS) {
+        send_packet();
+    }
+}
+
+// API
+
+void Netplay_Init() {
+    const char* remote = Config_GetString("netplay_remote", NULL);
+
+    // Headless runs (benchmark, batch runner, gym) drive a single instance
+    if ((remote == NULL) || (remote[0] == '\0') || Bench_IsHeadless()) {
+        return;
+    }
+
+    const int local_port = Config_GetInt("netplay_local_port", 7000);
+    const TransportConditions conditions = {
+        .latency_ms = Config_GetInt("netplay_sim_latency_ms", 0),
+        .jitter_ms = Config_GetInt("netplay_sim_jitter_ms", 0),
+        .loss = Config_GetInt("netplay_sim_loss", 0),
+    };
+
+    delay = SDL_clamp(Config_GetInt("netplay_delay", 2), 1, DELAY_LIMIT);
+    max_rollback = SDL_clamp(Config_GetInt("netplay_max_rollback", 8), 1, ROLLBACK_LIMIT);
+    local_index = (Config_GetInt("netplay_player", 1) == 2) ? 1 : 0;
+
+    if (!Transport_Open(local_port, remote, &conditions)) {
+        return;
+    }
+
+    snapshot_size = GameState_GetSize();
+    snapshot_count = max_rollback + 1;
+    snapshot_data = SDL_malloc(snapshot_size * snapshot_count);
+    snapshot_frames = SDL_malloc(sizeof(Uint32) * snapshot_count);
+
+    for (int i = 0; i < snapshot_count; i++) {
+        snapshot_frames[i] = NO_FRAME;
+    }
+
+    // Nothing is read for the first frames, they run with released pads on both sides
+    SDL_zeroa(local_inputs);
+    SDL_zeroa(remote_inputs);
+    local_input_end = delay;
+    remote_input_end = delay;
+    remote_ack = delay;
+
+    is_active = true;
+    GameState_SetRollbackEnabled(true);
+    SDL_Log("Netplay as player %d with %s on port %d, %d frames of delay, up to %d frames of rollback",
+            local_index + 1,
+            remote,
+            local_port,
+            delay,
+            max_rollback);
+    SDL_Log("Netplay snapshots are %zu KB", snapshot_size / 1024);
+}
+
+void Netplay_Quit() {
+    if (!is_active) {
+        return;
+    }
+
+    SDL_Log("Netplay: %u frames, %u rollbacks (%u frames resimulated, longest %u), %u stalls, %u frames skipped, "
+            "%u frames rewound for loading",
+            frame,
+            stats.rollbacks,
+            stats.resimulated_frames,
+            stats.max_rollback_frames,
+            stats.stalls,
+            stats.skipped_frames,
+            stats.rewound_frames);
+
+    if (stats.rollbacks > 0) {
+        SDL_Log("Netplay: rollback took %.3f ms on average, %.3f ms at most (frame budget 16.7 ms), rtt %u ms",
+                (double)stats.resimulation_ns / stats.rollbacks / SDL_NS_PER_MS,
+                (double)stats.max_resimulation_ns / SDL_NS_PER_MS,
+                rtt_ms);
+    }
+
+    Transport_Close();
+    SDL_free(snapshot_data);
+    SDL_free(snapshot_frames);
+    snapshot_data = NULL;
+    snapshot_frames = NULL;
+    is_active = false;
+    GameState_SetRollbackEnabled(false);
+}
+
+bool Netplay_IsActive() {
+    return is_active;
+}
+
+bool Netplay_IsResimulating() {
+    return is_resimulating;
+}
+
+bool Netplay_BeginFrame(NetplaySimulateFrame simulate) {
+    if (!is_active) {
+        return true;
+    }
+
+    if (live_frame_ran) {
+        live_frame_ran = false;
+        frame += 1;
+    }
+
+    receive_packets();
+
+    // The game initializes itself on the first frame, there is nothing to roll back to before that
+    if (frame == 0) {
+        sim_frame = 0;
+        return true;
+    }
+
+    rollback(simulate);
+    confirm_hashes();
+
+    // A frame that is run on predicted input may have to be undone, which loading and saving can't be
+    const bool is_predicted = frame >= remote_input_end;
+    const bool is_busy = GameState_IsLoading() || GameState_IsSaving();
+
+    if (is_predicted && ((frame - remote_input_end >= max_rollback) || is_busy)) {
+        if (!is_stalled) {
+            stats.stalls += 1;
+            is_stalled = true;
+        }
+
+        resend_if_idle();
+        SDL_Delay(1);
+        return false;
+    }
+
+    is_stalled = false;
+
+    if (skip_frames > 0) {
+        skip_frames -= 1;
+        stats.skipped_frames += 1;
+        resend_if_idle();
+        SDL_DelayNS(SDL_NS_PER_SECOND / FRAME_RATE);
+        return false;
+    }
+
+    sync_time();
+    save_snapshot(frame);
+    sim_frame = frame;
+    return true;
+}
+
+void Netplay_ProcessPads(TARPAD pads[2]) {
+    if (!is_active) {
+        return;
+    }
+
+    if (!is_resimulating) {
+        // A frame that was rewound already sent its input
+        if (sim_frame + delay >= local_input_end) {
+            pack_pad(&pads[0], local_inputs[(sim_frame + delay) % FRAME_RING]);
+            local_input_end = sim_frame + delay + 1;
+        }
+
+        live_frame_ran = true;
+        send_packet();
+    }
+
+    const Uint32 slot = sim_frame % FRAME_RING;
+    const Uint8* remote = (sim_frame < remote_input_end) ? remote_inputs[slot]
+                                                         : remote_inputs[(remote_input_end - 1) % FRAME_RING];
+
+    SDL_memcpy(predicted_inputs[slot], remote, INPUT_SIZE);
+    unpack_pad(local_inputs[slot], &pads[local_index]);
+    unpack_pad(remote, &pads[local_index ^ 1]);
+}
@@ -0,0 +1,231 @@
+// getaddrinfo needs a newer POSIX level than the rest of the port
+#undef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+
+#include "port/netplay/transport.h"
+
+#include <SDL3/SDL.h>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+typedef SOCKET Socket;
+#define INVALID_SOCKET_VALUE INVALID_SOCKET
+#define close_socket closesocket
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef int Socket;
+#define INVALID_SOCKET_VALUE -1
+#define close_socket close
+#endif
+
+// UDP transport.
+//
+// The netplay session only ever talks to one peer, so the socket is bound to a local port and
+// packets from any other address are ignored. Simulated conditions are applied on the sending
+// side: dropped packets are never sent, delayed ones wait in a queue that is flushed whenever
+// the transport is used. Two instances on one machine with swapped ports make a loopback setup.
+
+#define DELAY_QUEUE_SIZE 256
+
+typedef struct DelayedPacket {
+    Uint64 send_time;
+    size_t size;
+    Uint8 data[TRANSPORT_PACKET_SIZE_MAX];
+} DelayedPacket;
+
+static Socket sock = INVALID_SOCKET_VALUE;
+static struct sockaddr_storage remote_addr;
+static socklen_t remote_addr_len = 0;
+static TransportConditions conditions = { 0 };
+
+static DelayedPacket delay_queue[DELAY_QUEUE_SIZE];
+static int delay_queue_count = 0;
+
+static bool resolve_remote(const char* remote) {
+    char host[256];
+    const char* colon = SDL_strrchr(remote, ':');
+
+    if ((colon == NULL) || ((size_t)(colon - remote) >= sizeof(host))) {
+        SDL_Log("Netplay peer %s is not host:port", remote);
+        return false;
+    }
+
+    SDL_strlcpy(host, remote, colon - remote + 1);
+
+    struct addrinfo hints;
+    struct addrinfo* result = NULL;
+    SDL_zero(hints);
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    if ((getaddrinfo(host, colon + 1, &hints, &result) != 0) || (result == NULL)) {
+        SDL_Log("Couldn't resolve netplay peer %s", remote);
+        return false;
+    }
+
+    SDL_memcpy(&remote_addr, result->ai_addr, result->ai_addrlen);
+    remote_addr_len = result->ai_addrlen;
+    freeaddrinfo(result);
+    return true;
+}
+
+static bool set_nonblocking() {
+#if defined(_WIN32)
+    u_long mode = 1;
+    return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+    const int flags = fcntl(sock, F_GETFL, 0);
+    return (flags >= 0) && (fcntl(sock, F_SETFL, flags | O_NONBLOCK) == 0);
+#endif
+}
+
+bool Transport_Open(Uint16 local_port, const char* remote, const TransportConditions* sim_conditions) {
+#if defined(_WIN32)
+    WSADATA wsa_data;
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        SDL_Log("Couldn't initialize Winsock");
+        return false;
+    }
+#endif
+
+    if (!resolve_remote(remote)) {
+        Transport_Close();
+        return false;
+    }
+
+    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    if (sock == INVALID_SOCKET_VALUE) {
+        SDL_Log("Couldn't create netplay socket");
+        Transport_Close();
+        return false;
+    }
+
+    struct sockaddr_in local_addr;
+    SDL_zero(local_addr);
+    local_addr.sin_family = AF_INET;
+    local_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    local_addr.sin_port = htons(local_port);
+
+    if (bind(sock, (struct sockaddr*)&local_addr, sizeof(local_addr)) != 0) {
+        SDL_Log("Couldn't bind netplay socket to port %u", local_port);
+        Transport_Close();
+        return false;
+    }
+
+    if (!set_nonblocking()) {
+        SDL_Log("Couldn't make netplay socket non-blocking");
+        Transport_Close();
+        return false;
+    }
+
+    conditions = *sim_conditions;
+    delay_queue_count = 0;
+
+    if ((conditions.latency_ms > 0) || (conditions.jitter_ms > 0) || (conditions.loss > 0)) {
+        SDL_Log("Simulating %d ms latency, %d ms jitter, %d%% loss",
+                conditions.latency_ms,
+                conditions.jitter_ms,
+                conditions.loss);
+    }
+
+    return true;
+}
+
+void Transport_Close() {
+    if (sock != INVALID_SOCKET_VALUE) {
+        close_socket(sock);
+        sock = INVALID_SOCKET_VALUE;
+    }
+
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+static void send_now(const void* data, size_t size) {
+    sendto(sock, data, size, 0, (struct sockaddr*)&remote_addr, remote_addr_len);
+}
+
+static void flush_delay_queue() {
+    const Uint64 now = SDL_GetTicksNS();
+    int kept = 0;
+
+    for (int i = 0; i < delay_queue_count; i++) {
+        DelayedPacket* packet = &delay_queue[i];
+
+        if (packet->send_time <= now) {
+            send_now(packet->data, packet->size);
+        } else {
+            if (kept != i) {
+                delay_queue[kept] = *packet;
+            }
+
+            kept += 1;
+        }
+    }
+
+    delay_queue_count = kept;
+}
+
+void Transport_Send(const void* data, size_t size) {
+    if ((sock == INVALID_SOCKET_VALUE) || (size > TRANSPORT_PACKET_SIZE_MAX)) {
+        return;
+    }
+
+    flush_delay_queue();
+
+    if ((conditions.loss > 0) && (SDL_rand(100) < conditions.loss)) {
+        return;
+    }
+
+    int delay_ms = conditions.latency_ms;
+
+    if (conditions.jitter_ms > 0) {
+        delay_ms += SDL_rand(conditions.jitter_ms + 1);
+    }
+
+    if ((delay_ms <= 0) || (delay_queue_count >= DELAY_QUEUE_SIZE)) {
+        send_now(data, size);
+        return;
+    }
+
+    DelayedPacket* packet = &delay_queue[delay_queue_count];
+    packet->send_time = SDL_GetTicksNS() + (Uint64)delay_ms * SDL_NS_PER_MS;
+    packet->size = size;
+    SDL_memcpy(packet->data, data, size);
+    delay_queue_count += 1;
+}
+
+size_t Transport_Receive(void* buffer, size_t size) {
+    if (sock == INVALID_SOCKET_VALUE) {
+        return 0;
+    }
+
+    flush_delay_queue();
+
+    for (;;) {
+        struct sockaddr_storage from;
+        socklen_t from_len = sizeof(from);
+        const int received = recvfrom(sock, buffer, size, 0, (struct sockaddr*)&from, &from_len);
+
+        if (received <= 0) {
+            return 0;
+        }
+
+        const struct sockaddr_in* peer = (const struct sockaddr_in*)&remote_addr;
+        const struct sockaddr_in* sender = (const struct sockaddr_in*)&from;
+
+        if ((sender->sin_addr.s_addr == peer->sin_addr.s_addr) && (sender->sin_port == peer->sin_port)) {
+            return received;
+        }
+    }
+}
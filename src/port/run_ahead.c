@@ -0,0 +1,183 @@
+#include "port/run_ahead.h"
+#include "port/config.h"
+#include "port/netplay/game_state.h"
+#include "port/netplay/netplay.h"
+#include "port/sdl/sdl_game_renderer.h"
+#include "port/sdl/sdl_message_renderer.h"
+#include "sf33rd/Source/Game/main.h"
+
+#include <SDL3/SDL.h>
+
+// Run-ahead.
+//
+// The state is saved between `game_step_0` and `game_step_1` of the real frame, so each frame run
+// ahead is a `game_step_1` followed by the next `game_step_0`. Only the draws of the last one reach
+// the renderer. Frames run ahead are speculative: their sound requests are dropped and the input
+// log doesn't see them. Pads are read as usual, but the state of the real frame is replayed so
+// every frame run ahead uses the same input.
+//
+// Loading isn't part of the snapshot (see game_state.c). A frame that starts with requests in the
+// load queue isn't hidden or run ahead of; it is shown as is. A request the real frame makes waits
+// while frames are run ahead, since the queue doesn't move on speculative frames. Frames are shown
+// as is for the same reason while a save screen is open or a card command is running.
+//
+// Timing covers the real frame's game step and the whole run-ahead (save, frames, restore). The
+// frame budget is spent when both together take longer than a frame.
+
+#define RUN_AHEAD_FRAMES_MAX 2
+#define FRAME_BUDGET_NS (SDL_NS_PER_SECOND / 60)
+
+typedef struct RunAheadStats {
+    Uint64 frames;
+    Uint64 ahead_ns;
+    Uint64 max_ahead_ns;
+    Uint64 total_ns;
+    Uint64 max_total_ns;
+    Uint64 over_budget;
+    Uint64 loading;
+    Uint64 saving;
+} RunAheadStats;
+
+static int run_ahead_frames = 0;
+static Uint8* snapshot = NULL;
+static TARPAD real_pads[2];
+static bool is_frame_hidden = false;
+static Uint64 frame_start = 0;
+
+static RunAheadStats stats = { 0 };
+static Uint64 stats_log_interval_ns = 0;
+static Uint64 last_stats_log = 0;
+
+static void set_draw_enabled(bool enabled) {
+    SDLGameRenderer_SetDrawEnabled(enabled);
+    SDLMessageRenderer_SetDrawEnabled(enabled);
+}
+
+static void log_stats() {
+    if (stats.frames == 0) {
+        return;
+    }
+
+    SDL_Log("Run-ahead (%d frames): %llu frames, run-ahead mean %.3f ms, max %.3f ms, "
+            "with the real frame mean %.3f ms, max %.3f ms, over the %.1f ms budget %llu, "
+            "%llu frames not run ahead of while loading, %llu while saving",
+            run_ahead_frames,
+            (unsigned long long)stats.frames,
+            (double)stats.ahead_ns / stats.frames / SDL_NS_PER_MS,
+            (double)stats.max_ahead_ns / SDL_NS_PER_MS,
+            (double)stats.total_ns / stats.frames / SDL_NS_PER_MS,
+            (double)stats.max_total_ns / SDL_NS_PER_MS,
+            (double)FRAME_BUDGET_NS / SDL_NS_PER_MS,
+            (unsigned long long)stats.over_budget,
+            (unsigned long long)stats.loading,
+            (unsigned long long)stats.saving);
+}
+
+void RunAhead_Init() {
+    run_ahead_frames = SDL_clamp(Config_GetInt("run_ahead_frames", 0), 0, RUN_AHEAD_FRAMES_MAX);
+
+    if (run_ahead_frames == 0) {
+        return;
+    }
+
+    if (Netplay_IsActive()) {
+        SDL_Log("Run-ahead is off during netplay");
+        run_ahead_frames = 0;
+        return;
+    }
+
+    snapshot = SDL_malloc(GameState_GetSize());
+    stats_log_interval_ns = (Uint64)Config_GetInt("frame_stats_interval", 0) * SDL_NS_PER_SECOND;
+    SDL_Log("Running %d frames ahead", run_ahead_frames);
+}
+
+void RunAhead_SetFrames(int frames) {
+    run_ahead_frames = SDL_clamp(frames, 0, RUN_AHEAD_FRAMES_MAX);
+
+    if ((run_ahead_frames > 0) && (snapshot == NULL)) {
+        snapshot = SDL_malloc(GameState_GetSize());
+    }
+}
+
+int RunAhead_GetFrames() {
+    return run_ahead_frames;
+}
+
+void RunAhead_Quit() {
+    log_stats();
+    SDL_free(snapshot);
+    snapshot = NULL;
+    run_ahead_frames = 0;
+}
+
+void RunAhead_BeginFrame() {
+    // The first frame initializes the game, there is nothing to run ahead of before that
+    if ((run_ahead_frames == 0) || !get_game_initialized()) {
+        return;
+    }
+
+    if (GameState_IsLoading()) {
+        stats.loading += 1;
+        return;
+    }
+
+    if (GameState_IsSaving()) {
+        stats.saving += 1;
+        return;
+    }
+
+    is_frame_hidden = true;
+    frame_start = SDL_GetTicksNS();
+    set_draw_enabled(false);
+}
+
+void RunAhead_EndFrame(RunAheadStep step_1, RunAheadStep step_0) {
+    if (!is_frame_hidden) {
+        return;
+    }
+
+    is_frame_hidden = false;
+    const Uint64 ahead_start = SDL_GetTicksNS();
+    GameState_Save(snapshot);
+    GameState_SetSpeculative(true);
+
+    for (int i = 0; i < run_ahead_frames; i++) {
+        step_1();
+        set_draw_enabled(i == run_ahead_frames - 1);
+        step_0();
+    }
+
+    GameState_Load(snapshot);
+    GameState_SetSpeculative(false);
+    set_draw_enabled(true);
+
+    const Uint64 now = SDL_GetTicksNS();
+    const Uint64 ahead = now - ahead_start;
+    const Uint64 total = now - frame_start;
+    stats.frames += 1;
+    stats.ahead_ns += ahead;
+    stats.max_ahead_ns = SDL_max(stats.max_ahead_ns, ahead);
+    stats.total_ns += total;
+    stats.max_total_ns = SDL_max(stats.max_total_ns, total);
+
+    if (total > FRAME_BUDGET_NS) {
+        stats.over_budget += 1;
+    }
+
+    if ((stats_log_interval_ns > 0) && (now - last_stats_log >= stats_log_interval_ns)) {
+        log_stats();
+        last_stats_log = now;
+    }
+}
+
+void RunAhead_ProcessPads(TARPAD pads[2]) {
+    if (run_ahead_frames == 0) {
+        return;
+    }
+
+    if (GameState_IsSpeculative()) {
+        SDL_memcpy(pads, real_pads, sizeof(real_pads));
+    } else {
+        SDL_memcpy(real_pads, pads, sizeof(real_pads));
+    }
+}
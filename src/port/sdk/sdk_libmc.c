@@ -1,99 +1,740 @@
+// fsync needs a newer POSIX level than the rest of the port
+#undef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
 #include "common.h"
+#include "port/bench.h"
+#include "port/config.h"
+#include "port/input_log.h"
+#include "port/memcard.h"
+#include "port/netplay/netplay.h"
 
 #include <libmc.h>
 
-#include <stdbool.h>
+#include <SDL3/SDL.h>
+
+#if !defined(_WIN32)
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
+// Memory card emulation.
+//
+// The card in port 1 is the `memcard` folder in the pref directory. Every save is a folder and
+// every file in it is a host file. As with libmc, a call only starts a command and `sceMcSync`
+// tells when it's done. Commands run on a background thread, so a slow disk (a home directory on
+// the network, say) holds up the save screen but never the frame. Port 2 is always empty.
+//
+// The card can be taken out with the `memcard` setting. Headless runs (benchmark, batch runner,
+// gym) and runs that record an input log see no card either, so replays don't depend on old saves
+// and a recorded log boots the same way when it's played back. Without a card the boot skips
+// loading the system file, see init3rd.c. The card is also out for as long as a netplay session is
+// active: the peers have different saves, and a command finishes after a time that depends on the
+// disk, not the frame, while every frame has to come out the same on both sides.
+//
+// A file is held in memory from open to close. A written file is committed on close: the data
+// goes to `<name>.tmp`, is flushed to the disk and renamed over the old file, so a crash leaves
+// either the old file or the new one, never a torn one. Each file starts with a header
+//
+//     "3SXM", data size, CRC-32 of the data, unused    (16 bytes)
+//
+// and a file whose header or checksum doesn't match is reported missing, so the game saves anew.
+
+#define CARD_PORT 0
+#define CARD_FREE_CLUSTERS 0x1F03
+#define FILE_MAX 32
+#define PATH_LENGTH_MAX 128
+#define ENTRY_MAX 64
+#define ENTRY_NAME_SIZE 32
+#define FILE_MAGIC "3SXM"
+#define HEADER_SIZE 16
+#define TEMP_SUFFIX ".tmp"
+#define FILE_ATTR (sceMcFileAttrReadable | sceMcFileAttrWriteable | sceMcFileAttrExecutable | sceMcFileAttrClosed)
 
-typedef void (*OperationFinalizer)(int* result);
+typedef enum CommandState {
+    COMMAND_IDLE,
+    COMMAND_RUNNING,
+    COMMAND_FINISHED,
+} CommandState;
 
-typedef struct GetInfoOperation {
+typedef struct Command {
+    int func;
+    char path[PATH_LENGTH_MAX];
+    int flags;
+    int fd;
+    void* dst;
+    const void* src;
+    int size;
     int* type;
     int* free;
     int* format;
-} GetInfoOperation;
-
-static GetInfoOperation get_info_operation = { 0 };
-static int registered_operation = 0;
-
-static void finalize_get_info(int* result) {
-    // *get_info_operation.type = sceMcTypePS2;
-    // *get_info_operation.free = 0x1F03;
-    // *get_info_operation.format = 1;
-
-    // For now we just report absence of a memory card
-    *get_info_operation.type = sceMcTypeNoCard;
-    *get_info_operation.free = 0;
-    *get_info_operation.format = 0;
-    *result = sceMcResSucceed;
-}
-
-static OperationFinalizer finalizers[21] = { NULL, finalize_get_info,
-                                             NULL, NULL,
-                                             NULL, NULL,
-                                             NULL, NULL,
-                                             NULL, NULL,
-                                             NULL, NULL,
-                                             NULL, NULL,
-                                             NULL, NULL,
-                                             NULL, NULL,
-                                             NULL, NULL,
-                                             NULL };
+    int result;
+} Command;
+
+typedef struct CardFile {
+    bool is_open;
+    bool is_dirty;
+    char* path;
+    Uint8* data;
+    int size;
+    int pos;
+} CardFile;
+
+typedef struct Listing {
+    char* dir;
+    char names[ENTRY_MAX][ENTRY_NAME_SIZE];
+    int count;
+    int cursor;
+} Listing;
+
+static SDL_Thread* thread = NULL;
+static SDL_Semaphore* command_sem = NULL;
+static SDL_AtomicInt state = { COMMAND_IDLE };
+static SDL_AtomicInt is_quitting = { 0 };
+static Command command = { 0 };
+
+// Owned by the command thread
+static char* card_root = NULL;
+static CardFile files[FILE_MAX] = { 0 };
+static Listing listing = { 0 };
+
+// Paths
+
+static bool is_name_allowed(const char* name) {
+    return (SDL_strstr(name, "..") == NULL) && (SDL_strchr(name, '\\') == NULL) && (SDL_strchr(name, ':') == NULL);
+}
+
+/// @brief Make the host path of a card path. Returns `NULL` for a path that would leave the card.
+static char* host_path(const char* name) {
+    char* path = NULL;
+
+    while (*name == '/') {
+        name += 1;
+    }
+
+    if (!is_name_allowed(name)) {
+        SDL_Log("Memory card path %s is not allowed", name);
+        return NULL;
+    }
+
+    SDL_asprintf(&path, "%s%s", card_root, name);
+    return path;
+}
+
+static bool is_temp_file(const char* name) {
+    const size_t length = SDL_strlen(name);
+    const size_t suffix_length = SDL_strlen(TEMP_SUFFIX);
+
+    return (length >= suffix_length) && (SDL_strcmp(name + length - suffix_length, TEMP_SUFFIX) == 0);
+}
+
+// Files
+
+static int load_file(const char* path, Uint8** data, int* size) {
+    size_t file_size = 0;
+    Uint8* file = SDL_LoadFile(path, &file_size);
+
+    if (file == NULL) {
+        return sceMcResNoEntry;
+    }
+
+    Uint32 header[4];
+
+    if (file_size >= HEADER_SIZE) {
+        SDL_memcpy(header, file, HEADER_SIZE);
+    }
+
+    if ((file_size < HEADER_SIZE) || (SDL_memcmp(file, FILE_MAGIC, 4) != 0) ||
+        (SDL_Swap32LE(header[1]) != file_size - HEADER_SIZE) ||
+        (SDL_Swap32LE(header[2]) != SDL_crc32(0, file + HEADER_SIZE, file_size - HEADER_SIZE))) {
+        SDL_Log("Memory card file %s is damaged, ignoring it", path);
+        SDL_free(file);
+        return sceMcResNoEntry;
+    }
+
+    *size = file_size - HEADER_SIZE;
+    SDL_memmove(file, file + HEADER_SIZE, *size);
+    *data = file;
+    return sceMcResSucceed;
+}
+
+static bool sync_to_disk(SDL_IOStream* io) {
+    if (!SDL_FlushIO(io)) {
+        return false;
+    }
+
+#if !defined(_WIN32)
+    FILE* fp = SDL_GetPointerProperty(SDL_GetIOProperties(io), SDL_PROP_IOSTREAM_STDIO_FILE_POINTER, NULL);
+
+    if ((fp != NULL) && (fsync(fileno(fp)) != 0)) {
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+static int commit_file(const CardFile* file) {
+    char* temp_path = NULL;
+    SDL_asprintf(&temp_path, "%s%s", file->path, TEMP_SUFFIX);
+
+    SDL_IOStream* io = SDL_IOFromFile(temp_path, "wb");
+    bool success = (io != NULL);
+
+    if (success) {
+        Uint32 header[4] = { 0 };
+
+        SDL_memcpy(header, FILE_MAGIC, 4);
+        header[1] = SDL_Swap32LE(file->size);
+        header[2] = SDL_Swap32LE(SDL_crc32(0, file->data, file->size));
+        success = (SDL_WriteIO(io, header, HEADER_SIZE) == HEADER_SIZE);
+        success = success && (SDL_WriteIO(io, file->data, file->size) == (size_t)file->size);
+        success = sync_to_disk(io) && success;
+        success = SDL_CloseIO(io) && success;
+    }
+
+    success = success && SDL_RenamePath(temp_path, file->path);
+
+    if (!success) {
+        SDL_Log("Couldn't save %s: %s", file->path, SDL_GetError());
+        SDL_RemovePath(temp_path);
+    }
+
+    SDL_free(temp_path);
+    return success ? sceMcResSucceed : sceMcResFullDevice;
+}
+
+static CardFile* get_open_file(int fd) {
+    if ((fd < 0) || (fd >= FILE_MAX) || !files[fd].is_open) {
+        return NULL;
+    }
+
+    return &files[fd];
+}
+
+static void close_file(CardFile* file) {
+    SDL_free(file->path);
+    SDL_free(file->data);
+    SDL_zerop(file);
+}
+
+// Directory listings
+
+static SDL_EnumerationResult collect_entry(void* userdata, const char* dirname, const char* fname) {
+    const char* pattern = userdata;
+
+    if (listing.count == ENTRY_MAX) {
+        return SDL_ENUM_SUCCESS;
+    }
+
+    if (is_temp_file(fname) || ((SDL_strcmp(pattern, "*") != 0) && (SDL_strcmp(pattern, fname) != 0))) {
+        return SDL_ENUM_CONTINUE;
+    }
+
+    SDL_strlcpy(listing.names[listing.count], fname, ENTRY_NAME_SIZE);
+    listing.count += 1;
+    return SDL_ENUM_CONTINUE;
+}
+
+static void add_listing_entry(const char* name) {
+    SDL_strlcpy(listing.names[listing.count], name, ENTRY_NAME_SIZE);
+    listing.count += 1;
+}
+
+/// @brief List the entries matching `path`, whose last part is a name or `*`.
+static void list_entries(const char* path) {
+    char dir[PATH_LENGTH_MAX];
+    const char* slash = SDL_strrchr(path, '/');
+    const char* pattern = (slash != NULL) ? slash + 1 : path;
+
+    SDL_strlcpy(dir, path, SDL_min(sizeof(dir), (size_t)(pattern - path) + 1));
+    SDL_free(listing.dir);
+    listing.dir = host_path(dir);
+    listing.count = 0;
+    listing.cursor = 0;
+
+    if (listing.dir == NULL) {
+        return;
+    }
+
+    // Like on the card, folders list themselves and their parent first
+    if ((SDL_strcmp(pattern, "*") == 0) && (dir[0] != '\0')) {
+        add_listing_entry(".");
+        add_listing_entry("..");
+    }
+
+    SDL_EnumerateDirectory(listing.dir, collect_entry, (void*)pattern);
+}
+
+static void convert_time(SDL_Time time, sceMcStDateTime* date) {
+    SDL_DateTime dt;
+
+    SDL_zerop(date);
+
+    if (!SDL_TimeToDateTime(time, &dt, true)) {
+        return;
+    }
+
+    date->Sec = dt.second;
+    date->Min = dt.minute;
+    date->Hour = dt.hour;
+    date->Day = dt.day;
+    date->Month = dt.month;
+    date->Year = dt.year;
+}
+
+static bool fill_entry(sceMcTblGetDir* entry, const char* name) {
+    const bool is_self = (SDL_strcmp(name, ".") == 0) || (SDL_strcmp(name, "..") == 0);
+    char* path = NULL;
+    SDL_PathInfo info;
+
+    SDL_asprintf(&path, "%s%s", listing.dir, is_self ? "" : name);
+
+    if (!SDL_GetPathInfo(path, &info)) {
+        SDL_free(path);
+        return false;
+    }
+
+    SDL_zerop(entry);
+    entry->AttrFile = FILE_ATTR;
+
+    if (info.type == SDL_PATHTYPE_DIRECTORY) {
+        entry->AttrFile |= sceMcFileAttrSubdir;
+    } else {
+        Uint8* data = NULL;
+        int size = 0;
+
+        if (load_file(path, &data, &size) < 0) {
+            SDL_free(path);
+            return false;
+        }
+
+        entry->FileSizeByte = size;
+        SDL_free(data);
+    }
+
+    convert_time(info.create_time, &entry->_Create);
+    convert_time(info.modify_time, &entry->_Modify);
+    SDL_strlcpy((char*)entry->EntryName, name, sizeof(entry->EntryName));
+    SDL_free(path);
+    return true;
+}
+
+// Commands
+
+static int run_get_info(const Command* cmd) {
+    *cmd->type = sceMcTypePS2;
+    *cmd->free = CARD_FREE_CLUSTERS;
+    *cmd->format = 1;
+    return sceMcResSucceed;
+}
+
+static int run_open(const Command* cmd) {
+    int fd = 0;
+
+    // mcsub.c closes the previous fd after creating a file, which only works if fds are reused
+    // lowest first, as mcman does
+    while ((fd < FILE_MAX) && files[fd].is_open) {
+        fd += 1;
+    }
+
+    if (fd == FILE_MAX) {
+        return sceMcResUpLimitHandle;
+    }
+
+    CardFile* file = &files[fd];
+    SDL_PathInfo info;
+
+    file->path = host_path(cmd->path);
+
+    if (file->path == NULL) {
+        return sceMcResNoEntry;
+    }
+
+    if (SDL_GetPathInfo(file->path, &info) && (info.type == SDL_PATHTYPE_DIRECTORY)) {
+        close_file(file);
+        return sceMcResDeniedPermit;
+    }
+
+    int result = load_file(file->path, &file->data, &file->size);
+
+    if ((result == sceMcResNoEntry) && (cmd->flags & SCE_CREAT)) {
+        file->is_dirty = true;
+        result = sceMcResSucceed;
+    }
+
+    if (result < 0) {
+        close_file(file);
+        return result;
+    }
+
+    if (cmd->flags & SCE_TRUNC) {
+        file->size = 0;
+        file->is_dirty = true;
+    }
+
+    file->is_open = true;
+    return fd;
+}
+
+static int run_read(const Command* cmd) {
+    CardFile* file = get_open_file(cmd->fd);
+
+    if (file == NULL) {
+        return sceMcResNoEntry;
+    }
+
+    const int count = SDL_clamp(file->size - file->pos, 0, cmd->size);
+
+    SDL_memcpy(cmd->dst, file->data + file->pos, count);
+    file->pos += count;
+    return count;
+}
+
+static int run_write(const Command* cmd) {
+    CardFile* file = get_open_file(cmd->fd);
+
+    if (file == NULL) {
+        return sceMcResNoEntry;
+    }
+
+    const int end = file->pos + cmd->size;
+
+    if (end > file->size) {
+        Uint8* data = SDL_realloc(file->data, end);
+
+        if (data == NULL) {
+            SDL_Log("Couldn't grow %s to %d bytes", file->path, end);
+            return sceMcResFullDevice;
+        }
+
+        file->data = data;
+        file->size = end;
+    }
+
+    SDL_memcpy(file->data + file->pos, cmd->src, cmd->size);
+    file->pos = end;
+    file->is_dirty = true;
+    return cmd->size;
+}
+
+static int run_close(const Command* cmd) {
+    CardFile* file = get_open_file(cmd->fd);
+
+    if (file == NULL) {
+        return sceMcResNoEntry;
+    }
+
+    const int result = file->is_dirty ? commit_file(file) : sceMcResSucceed;
+    close_file(file);
+    return result;
+}
+
+static int run_mkdir(const Command* cmd) {
+    char* path = host_path(cmd->path);
+    SDL_PathInfo info;
+    int result = sceMcResSucceed;
+
+    if (path == NULL) {
+        return sceMcResDeniedPermit;
+    }
+
+    // libmc reports an existing folder as "no entry", and mcsub.c counts on it
+    if (SDL_GetPathInfo(path, &info)) {
+        result = sceMcResNoEntry;
+    } else if (!SDL_CreateDirectory(path)) {
+        SDL_Log("Couldn't create %s: %s", path, SDL_GetError());
+        result = sceMcResFullDevice;
+    }
+
+    SDL_free(path);
+    return result;
+}
+
+static SDL_EnumerationResult remove_temp_file(void* userdata, const char* dirname, const char* fname) {
+    if (is_temp_file(fname)) {
+        char* path = NULL;
+
+        SDL_asprintf(&path, "%s%s", dirname, fname);
+        SDL_RemovePath(path);
+        SDL_free(path);
+    }
+
+    return SDL_ENUM_CONTINUE;
+}
+
+static int run_delete(const Command* cmd) {
+    char* path = host_path(cmd->path);
+    SDL_PathInfo info;
+    int result = sceMcResSucceed;
+
+    if ((path == NULL) || !SDL_GetPathInfo(path, &info)) {
+        SDL_free(path);
+        return sceMcResNoEntry;
+    }
+
+    if (info.type == SDL_PATHTYPE_DIRECTORY) {
+        char pattern[PATH_LENGTH_MAX];
+
+        SDL_snprintf(pattern, sizeof(pattern), "%s/*", cmd->path);
+        list_entries(pattern);
+
+        // Only the folder itself and its parent are left
+        if (listing.count > 2) {
+            SDL_free(path);
+            return sceMcResNotEmpty;
+        }
+
+        // Leftovers of saves that didn't finish, which listings don't show
+        SDL_EnumerateDirectory(path, remove_temp_file, NULL);
+    }
+
+    if (!SDL_RemovePath(path)) {
+        SDL_Log("Couldn't delete %s: %s", path, SDL_GetError());
+        result = sceMcResDeniedPermit;
+    }
+
+    SDL_free(path);
+    return result;
+}
+
+static int run_get_dir(const Command* cmd) {
+    sceMcTblGetDir* table = cmd->dst;
+    int count = 0;
+
+    if (cmd->flags == 0) {
+        list_entries(cmd->path);
+    }
+
+    while ((count < cmd->size) && (listing.cursor < listing.count)) {
+        if (fill_entry(&table[count], listing.names[listing.cursor])) {
+            count += 1;
+        }
+
+        listing.cursor += 1;
+    }
+
+    return count;
+}
+
+static int run_command(const Command* cmd) {
+    switch (cmd->func) {
+    case sceMcFuncNoCardInfo:
+        return run_get_info(cmd);
+
+    case sceMcFuncNoOpen:
+        return run_open(cmd);
+
+    case sceMcFuncNoRead:
+        return run_read(cmd);
+
+    case sceMcFuncNoWrite:
+        return run_write(cmd);
+
+    case sceMcFuncNoClose:
+        return run_close(cmd);
+
+    case sceMcFuncNoMkdir:
+        return run_mkdir(cmd);
+
+    case sceMcFuncNoDelete:
+        return run_delete(cmd);
+
+    case sceMcFuncNoGetDir:
+        return run_get_dir(cmd);
+
+    case sceMcFuncNoFormat:
+        // The folder is always formatted
+        return sceMcResSucceed;
+
+    case sceMcFuncNoUnformat:
+        // Saves are never wiped from inside the game
+        SDL_Log("Ignoring memory card unformat");
+        return sceMcResSucceed;
+
+    default:
+        return sceMcResDeniedPermit;
+    }
+}
+
+static int command_main(void* data) {
+    SDL_CreateDirectory(card_root);
+
+    while (true) {
+        SDL_WaitSemaphore(command_sem);
+
+        if (SDL_GetAtomicInt(&is_quitting)) {
+            break;
+        }
+
+        command.result = run_command(&command);
+        SDL_SetAtomicInt(&state, COMMAND_FINISHED);
+    }
+
+    return 0;
+}
+
+static bool start_thread() {
+    char* base = SDL_GetPrefPath("CrowdedStreet", "3SX");
+    SDL_asprintf(&card_root, "%smemcard/", base);
+    SDL_free(base);
+
+    command_sem = SDL_CreateSemaphore(0);
+    thread = SDL_CreateThread(command_main, "memory card", NULL);
+
+    if (thread == NULL) {
+        SDL_Log("Couldn't start the memory card thread: %s", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Start `cmd` on the command thread, or finish it right away if there is no card in `port`.
+static int submit(const Command* cmd, int port) {
+    // Like libmc, one command at a time
+    if (SDL_GetAtomicInt(&state) != COMMAND_IDLE) {
+        return -1;
+    }
+
+    command = *cmd;
+
+    if ((port != CARD_PORT) || !Memcard_IsInserted()) {
+        command.result = sceMcResNoEntry;
+
+        if (command.func == sceMcFuncNoCardInfo) {
+            *command.type = sceMcTypeNoCard;
+            *command.free = 0;
+            *command.format = 0;
+            command.result = sceMcResSucceed;
+        }
+
+        SDL_SetAtomicInt(&state, COMMAND_FINISHED);
+        return 0;
+    }
+
+    if ((thread == NULL) && !start_thread()) {
+        return -1;
+    }
+
+    SDL_SetAtomicInt(&state, COMMAND_RUNNING);
+    SDL_SignalSemaphore(command_sem);
+    return 0;
+}
+
+bool Memcard_IsInserted() {
+    static int is_enabled = -1;
+
+    // Decided once, so the card doesn't come and go during a run
+    if (is_enabled < 0) {
+        is_enabled = Config_GetBool("memcard", true) && !Bench_IsHeadless() && !InputLog_IsRecording();
+    }
+
+    return is_enabled && !Netplay_IsActive();
+}
+
+bool Memcard_IsBusy() {
+    return SDL_GetAtomicInt(&state) != COMMAND_IDLE;
+}
+
+static void set_path(Command* cmd, const char* name) {
+    SDL_strlcpy(cmd->path, name, sizeof(cmd->path));
+}
 
 int sceMcInit(void) {
     return sceMcIniSucceed;
 }
 
+int sceMcEnd(void) {
+    if (thread == NULL) {
+        return 0;
+    }
+
+    // Let a save in progress reach the disk
+    while (SDL_GetAtomicInt(&state) == COMMAND_RUNNING) {
+        SDL_Delay(1);
+    }
+
+    SDL_SetAtomicInt(&is_quitting, 1);
+    SDL_SignalSemaphore(command_sem);
+    SDL_WaitThread(thread, NULL);
+    SDL_DestroySemaphore(command_sem);
+    thread = NULL;
+    command_sem = NULL;
+    return 0;
+}
+
 int sceMcSync(int mode, int* cmd, int* result) {
-    if (registered_operation > 0) {
-        *cmd = registered_operation;
-        finalizers[registered_operation](result);
-        registered_operation = 0;
-        return sceMcExecFinish;
-    } else {
+    int current;
+
+    while ((current = SDL_GetAtomicInt(&state)) == COMMAND_RUNNING) {
+        if (mode == 1) {
+            return sceMcExecRun;
+        }
+
+        SDL_Delay(1);
+    }
+
+    if (current == COMMAND_IDLE) {
         return sceMcExecIdle;
     }
+
+    *cmd = command.func;
+    *result = command.result;
+    SDL_SetAtomicInt(&state, COMMAND_IDLE);
+    return sceMcExecFinish;
 }
 
 int sceMcGetInfo(int port, int slot, int* type, int* free, int* format) {
-    registered_operation = sceMcFuncNoCardInfo;
-    get_info_operation.type = type;
-    get_info_operation.free = free;
-    get_info_operation.format = format;
-    return 0;
+    const Command cmd = { .func = sceMcFuncNoCardInfo, .type = type, .free = free, .format = format };
+    return submit(&cmd, port);
 }
 
-int sceMcOpen(int, int, const char*, int) {
-    not_implemented(__func__);
+int sceMcOpen(int port, int slot, const char* name, int mode) {
+    Command cmd = { .func = sceMcFuncNoOpen, .flags = mode };
+    set_path(&cmd, name);
+    return submit(&cmd, port);
 }
 
-int sceMcClose(int) {
-    not_implemented(__func__);
+int sceMcClose(int fd) {
+    const Command cmd = { .func = sceMcFuncNoClose, .fd = fd };
+    return submit(&cmd, CARD_PORT);
 }
 
-int sceMcRead(int, void*, int) {
-    not_implemented(__func__);
+int sceMcRead(int fd, void* buff, int size) {
+    const Command cmd = { .func = sceMcFuncNoRead, .fd = fd, .dst = buff, .size = size };
+    return submit(&cmd, CARD_PORT);
 }
 
-int sceMcWrite(int, const void*, int) {
-    not_implemented(__func__);
+int sceMcWrite(int fd, const void* buff, int size) {
+    const Command cmd = { .func = sceMcFuncNoWrite, .fd = fd, .src = buff, .size = size };
+    return submit(&cmd, CARD_PORT);
 }
 
-int sceMcMkdir(int, int, const char*) {
-    not_implemented(__func__);
+int sceMcMkdir(int port, int slot, const char* name) {
+    Command cmd = { .func = sceMcFuncNoMkdir };
+    set_path(&cmd, name);
+    return submit(&cmd, port);
 }
 
-int sceMcDelete(int, int, const char*) {
-    not_implemented(__func__);
+int sceMcDelete(int port, int slot, const char* name) {
+    Command cmd = { .func = sceMcFuncNoDelete };
+    set_path(&cmd, name);
+    return submit(&cmd, port);
 }
 
-int sceMcFormat(int, int) {
-    not_implemented(__func__);
+int sceMcFormat(int port, int slot) {
+    const Command cmd = { .func = sceMcFuncNoFormat };
+    return submit(&cmd, port);
 }
 
-int sceMcUnformat(int, int) {
-    not_implemented(__func__);
+int sceMcUnformat(int port, int slot) {
+    const Command cmd = { .func = sceMcFuncNoUnformat };
+    return submit(&cmd, port);
 }
 
 int sceMcGetDir(int port, int slot, const char* name, unsigned int mode, int maxent, sceMcTblGetDir* table) {
-    not_implemented(__func__);
+    Command cmd = { .func = sceMcFuncNoGetDir, .flags = mode, .dst = table, .size = maxent };
+    set_path(&cmd, name);
+    return submit(&cmd, port);
 }
@@ -1,6 +1,7 @@
 #if !defined(TARGET_PS2)
 
 #include "common.h"
+#include "port/afs.h"
 #include "port/resources.h"
 #include "types.h"
 
@@ -60,13 +61,8 @@ int sceCdRead(u_int lsn, u_int sectors, void* buf, sceCdRMode* mode) {
         // need to read from buf
         return 1;
     } else if ((lsn >= AFS_START_LSN) && (lsn < AFS_END_LSN)) {
-        char* afs_path = Resources_GetPath("SF33RD.AFS");
-        const int file_offset = (lsn - AFS_START_LSN) * 2048;
-        const int fd = open(afs_path, O_RDONLY);
-        lseek(fd, file_offset, SEEK_SET);
-        read(fd, buf, sectors * 2048);
-        close(fd);
-        SDL_free(afs_path);
+        const size_t file_offset = (size_t)(lsn - AFS_START_LSN) * 2048;
+        AFS_Read(file_offset, buf, (size_t)sectors * 2048);
     } else {
         fatal_error("Can't handle lsn %u", lsn);
     }
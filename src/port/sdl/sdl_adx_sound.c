@@ -1,6 +1,8 @@
 #include "port/sdl/sdl_adx_sound.h"
 #include "common.h"
-#include "sf33rd/Source/Game/GD3rd.h"
+#include "port/afs.h"
+#include "port/config.h"
+#include "port/sound/mixer.h"
 
 #include <SDL3/SDL.h>
 
@@ -19,11 +21,11 @@
 #include <malloc.h> // for _aligned_malloc / _aligned_free
 #endif
 
-#define SAMPLE_RATE 48000
-#define N_CHANNELS 2
+#define SAMPLE_RATE MIXER_SAMPLE_RATE
+#define N_CHANNELS MIXER_CHANNELS
 #define BYTES_PER_SAMPLE 2
-#define MIN_QUEUED_DATA_MS 400
-#define MIN_QUEUED_DATA (int)((float)SAMPLE_RATE * MIN_QUEUED_DATA_MS / 1000 * N_CHANNELS * BYTES_PER_SAMPLE)
+#define DEFAULT_QUEUED_DATA_MS 60
+#define QUEUED_DATA_SIZE(ms) (int)((float)SAMPLE_RATE * (ms) / 1000 * N_CHANNELS * BYTES_PER_SAMPLE)
 #define TRACKS_MAX 10
 
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -61,9 +63,10 @@ static ADXTrack tracks[TRACKS_MAX] = { 0 };
 static int num_tracks = 0;
 static int first_track_index = 0;
 static bool has_tracks = false;
+static int min_queued_data = QUEUED_DATA_SIZE(DEFAULT_QUEUED_DATA_MS);
 
 static int stream_data_needed() {
-    return MIN_QUEUED_DATA - SDL_GetAudioStreamQueued(stream);
+    return min_queued_data - SDL_GetAudioStreamQueued(stream);
 }
 
 static bool stream_needs_data() {
@@ -105,9 +108,9 @@ static void pipeline_destroy(ADXDecoderPipeline* pipeline) {
 }
 
 static void* load_file(int file_id, int* size) {
-    const unsigned int file_size = fsGetFileSize(file_id);
-    const size_t buff_size = (file_size + 2048 - 1) & ~(2048 - 1); // sceCdRead reads data in 2048-byte chunks
-    const size_t alignment = 64;                                   // ADXF requires buff to be aligned to 64
+    const size_t file_size = AFS_GetFileSize(file_id);
+    const size_t buff_size = (file_size + 64 - 1) & ~(64 - 1); // aligned_alloc wants a multiple of the alignment
+    const size_t alignment = 64;
 
 #if defined(_WIN32)
     void* buff = _aligned_malloc(buff_size, alignment);
@@ -115,13 +118,7 @@ static void* load_file(int file_id, int* size) {
     void* buff = aligned_alloc(alignment, buff_size);
 #endif
 
-    REQ req;
-    req.fnum = file_id;
-    fsOpen(&req);
-    req.size = file_size;
-    *size = req.size;
-    req.sect = fsCalSectorSize(req.size);
-    fsFileReadSync(&req, req.sect, buff);
+    *size = AFS_ReadFile(file_id, 0, buff, file_size);
     return buff;
 }
 
@@ -382,13 +379,16 @@ void SDLADXSound_ProcessTracks() {
 }
 
 void SDLADXSound_Init() {
-    const SDL_AudioSpec spec = { .format = SDL_AUDIO_S16, .channels = N_CHANNELS, .freq = SAMPLE_RATE };
-    stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, NULL, NULL);
+    // BGM is topped up once per frame, so the queue only has to cover a few frames of hitching
+    const int queued_data_ms = SDL_max(Config_GetInt("bgm_queue_ms", DEFAULT_QUEUED_DATA_MS), 20);
+    min_queued_data = QUEUED_DATA_SIZE(queued_data_ms);
+
+    stream = Mixer_GetBusStream(MIXER_BUS_BGM);
 }
 
 void SDLADXSound_Exit() {
     SDLADXSound_Stop();
-    SDL_DestroyAudioStream(stream);
+    stream = NULL;
 }
 
 void SDLADXSound_Stop() {
@@ -406,15 +406,11 @@ void SDLADXSound_Stop() {
 }
 
 int SDLADXSound_IsPaused() {
-    return SDL_AudioStreamDevicePaused(stream);
+    return Mixer_IsBusPaused(MIXER_BUS_BGM);
 }
 
 void SDLADXSound_Pause(int pause) {
-    if (pause) {
-        SDL_PauseAudioStreamDevice(stream);
-    } else {
-        SDL_ResumeAudioStreamDevice(stream);
-    }
+    Mixer_SetBusPaused(MIXER_BUS_BGM, pause);
 }
 
 void SDLADXSound_StartMem(void* buf, size_t size) {
@@ -451,7 +447,7 @@ void SDLADXSound_StartAfs(int file_id) {
 void SDLADXSound_SetOutVol(int volume) {
     // Convert volume (dB * 10) to linear gain
     const float gain = powf(10.0f, volume / 200.0f);
-    SDL_SetAudioStreamGain(stream, gain);
+    Mixer_SetBusGain(MIXER_BUS_BGM, gain);
 }
 
 int SDLADXSound_GetStat() {
@@ -1,15 +1,30 @@
 #include "port/sdl/sdl_app.h"
 #include "common.h"
+#include "port/config.h"
+#include "port/afs.h"
+#include "port/bench.h"
 #include "port/float_clamp.h"
+#include "port/heap_monitor.h"
+#include "port/input_log.h"
+#include "port/netplay/netplay.h"
+#include "port/run_ahead.h"
 #include "port/sdk_threads.h"
 #include "port/sdl/sdl_adx_sound.h"
+#include "port/sdl/sdl_capture.h"
+#include "port/sdl/sdl_frame_pacer.h"
 #include "port/sdl/sdl_game_renderer.h"
 #include "port/sdl/sdl_message_renderer.h"
 #include "port/sdl/sdl_pad.h"
+#include "port/sdl/sdl_scaler.h"
+#include "port/sound/mixer.h"
+#include "port/sound/se_queue.h"
+#include "port/state_hash.h"
+#include "port/texture_cache.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
 #include "sf33rd/Source/Game/main.h"
 
 #include <SDL3/SDL.h>
+#include <libmc.h>
 
 #define FRAME_END_TIMES_MAX 30
 
@@ -22,36 +37,23 @@ static const float display_target_ratio = 4.0 / 3.0;
 static const int window_default_width = 640;
 static const int window_default_height = (int)(window_default_width / display_target_ratio);
 static const double target_fps = 59.59949;
-static const Uint64 target_frame_time_ns = 1000000000.0 / target_fps;
 
 SDL_Window* window = NULL;
 static SDL_Renderer* renderer = NULL;
-static SDL_Texture* screen_texture = NULL;
 
-static Uint64 frame_deadline = 0;
 static Uint64 frame_end_times[FRAME_END_TIMES_MAX];
 static int frame_end_times_index = 0;
 static bool frame_end_times_filled = false;
 static double fps = 0;
 static Uint64 frame_counter = 0;
 
-static bool should_save_screenshot = false;
 static Uint64 last_mouse_motion_time = 0;
 static const int mouse_hide_delay_ms = 2000; // 2 seconds
 
-static void create_screen_texture() {
-    if (screen_texture != NULL) {
-        SDL_DestroyTexture(screen_texture);
-    }
-
-    int target_width, target_height;
-    SDL_GetRenderOutputSize(renderer, &target_width, &target_height);
-    screen_texture = SDL_CreateTexture(
-        renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, target_width * 2, target_height * 2);
-    SDL_SetTextureScaleMode(screen_texture, SDL_SCALEMODE_LINEAR);
-}
-
 int SDLApp_Init() {
+    // The footprint profile runs headless, which has to be decided before SDL_Init
+    HeapMonitor_Init();
+
     SDL_SetAppMetadata(app_name, "0.1", NULL);
     SDL_SetHint(SDL_HINT_VIDEO_WAYLAND_PREFER_LIBDECOR, "1");
     SDL_SetHint(SDL_HINT_NO_SIGNAL_HANDLERS, "1");
@@ -79,24 +81,79 @@ int SDLApp_Init() {
     // Initialize game renderer
     SDLGameRenderer_Init(renderer);
 
-    // Initialize screen texture
-    create_screen_texture();
+    // Initialize scaling
+    SDLScaler_Init(renderer, display_target_ratio);
+    SDLScaler_RunBenchmark(cps3_canvas, message_canvas, Config_GetInt("scale_benchmark", 0));
 
     // Initialize pads
     SDLPad_Init();
 
+    // Initialize audio output
+    Mixer_Init();
+
+    // Initialize frame pacing
+    SDLFramePacer_Init(renderer, target_fps);
+
+    // Initialize screenshot and video capture
+    SDLCapture_Init(renderer, cps3_canvas->w, cps3_canvas->h);
+
+    // Initialize determinism checks
+    StateHash_Init();
+    InputLog_Init();
+
+    // Initialize netplay and run-ahead
+    Netplay_Init();
+    RunAhead_Init();
+
     return 0;
 }
 
 void SDLApp_Quit() {
+    SDLFramePacer_LogStats();
+    SDLPad_LogLatency();
+    SDLPad_Quit();
+    RunAhead_Quit();
+    Netplay_Quit();
+    InputLog_Quit();
+    StateHash_Quit();
+    SDLCapture_Quit();
+    SDLScaler_Quit();
+    Mixer_Exit();
+    SEQueue_Quit();
+    HeapMonitor_Quit();
+    TextureCache_Quit();
+    sceMcEnd();
+    AFS_Close();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
 }
 
-static void set_screenshot_flag_if_needed(SDL_KeyboardEvent* event) {
-    if ((event->key == SDLK_GRAVE) && event->down && !event->repeat) {
-        should_save_screenshot = true;
+static void handle_capture_keys(SDL_KeyboardEvent* event) {
+    if (!event->down || event->repeat) {
+        return;
+    }
+
+    switch (event->key) {
+    case SDLK_GRAVE:
+        SDLCapture_RequestScreenshot();
+        break;
+
+    case SDLK_F10:
+        SDLCapture_ToggleRecording();
+        break;
+    }
+}
+
+static void handle_scale_mode_toggle(SDL_KeyboardEvent* event) {
+    if ((event->key == SDLK_F9) && event->down && !event->repeat) {
+        SDLScaler_CycleMode();
+    }
+}
+
+static void handle_heap_report_key(SDL_KeyboardEvent* event) {
+    if ((event->key == SDLK_F7) && event->down && !event->repeat) {
+        HeapMonitor_RequestReport();
     }
 }
 
@@ -129,6 +186,10 @@ bool SDLApp_PollEvents() {
     SDL_Event event;
     bool continue_running = true;
 
+    // Everything the OS has by now is stamped no later than this, see sdl_pad.c
+    SDL_PumpEvents();
+    const Uint64 input_deadline = SDL_GetTicksNS();
+
     while (SDL_PollEvent(&event)) {
         switch (event.type) {
         case SDL_EVENT_GAMEPAD_ADDED:
@@ -147,8 +208,10 @@ bool SDLApp_PollEvents() {
 
         case SDL_EVENT_KEY_DOWN:
         case SDL_EVENT_KEY_UP:
-            set_screenshot_flag_if_needed(&event.key);
+            handle_capture_keys(&event.key);
             handle_fullscreen_toggle(&event.key);
+            handle_scale_mode_toggle(&event.key);
+            handle_heap_report_key(&event.key);
             SDLPad_HandleKeyboardEvent(&event.key);
             break;
 
@@ -156,16 +219,13 @@ bool SDLApp_PollEvents() {
             handle_mouse_motion();
             break;
 
-        case SDL_EVENT_WINDOW_RESIZED:
-            create_screen_texture();
-            break;
-
         case SDL_EVENT_QUIT:
             continue_running = false;
             break;
         }
     }
 
+    SDLPad_SampleFrame(input_deadline);
     return continue_running;
 }
 
@@ -179,24 +239,6 @@ void SDLApp_BeginFrame() {
     SDLGameRenderer_BeginFrame();
 }
 
-static SDL_FRect get_letterbox_rect(int win_w, int win_h) {
-    float out_w = win_w;
-    float out_h = win_w / display_target_ratio;
-
-    if (out_h > win_h) {
-        out_h = win_h;
-        out_w = win_h * display_target_ratio;
-    }
-
-    SDL_FRect rect;
-    rect.w = out_w;
-    rect.h = out_h;
-    rect.x = (win_w - out_w) / 2;
-    rect.y = (win_h - out_h) / 2;
-
-    return rect;
-}
-
 static void note_frame_end_time() {
     frame_end_times[frame_end_times_index] = SDL_GetTicksNS();
     frame_end_times_index += 1;
@@ -224,14 +266,8 @@ static void update_fps() {
     fps = 1000 / average_frame_time_ms;
 }
 
-static void save_texture(SDL_Texture* texture, const char* filename) {
-    SDL_SetRenderTarget(renderer, texture);
-    const SDL_Surface* rendered_surface = SDL_RenderReadPixels(renderer, NULL);
-    SDL_SaveBMP(rendered_surface, filename);
-    SDL_DestroySurface(rendered_surface);
-}
-
-void SDLApp_EndFrame() {
+/// @brief Run what the game needs from the end of a frame: sound and the PS2 vertical blank.
+static void run_vblank() {
     // Run sound processing
     SDLADXSound_ProcessTracks();
 
@@ -241,33 +277,25 @@ void SDLApp_EndFrame() {
         ADXPS2_ExecVint(0);
         end_interrupt();
     }
+}
 
-    // Render
-
-    SDLGameRenderer_RenderFrame();
-
-    if (should_save_screenshot) {
-        save_texture(cps3_canvas, "screenshot_cps3.bmp");
-    }
+static void measure_frame() {
+    frame_counter += 1;
+    note_frame_end_time();
+    update_fps();
+}
 
-    SDL_SetRenderTarget(renderer, screen_texture);
+void SDLApp_EndFrame() {
+    run_vblank();
 
-    // Render window background
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // black bars
-    SDL_RenderClear(renderer);
+    // Render
 
-    // Render content
-    const SDL_FRect dst_rect = get_letterbox_rect(screen_texture->w, screen_texture->h);
-    SDL_RenderTexture(renderer, cps3_canvas, NULL, &dst_rect);
-    SDL_RenderTexture(renderer, message_canvas, NULL, &dst_rect);
+    SDLGameRenderer_RenderFrame();
 
-    // Render screen texture to screen
-    SDL_SetRenderTarget(renderer, NULL);
-    SDL_RenderTexture(renderer, screen_texture, NULL, NULL);
+    SDLMessageRenderer_Flush();
 
-    if (should_save_screenshot) {
-        save_texture(screen_texture, "screenshot_screen.bmp");
-    }
+    // Render content to the window. The window was cleared to black in SDLApp_BeginFrame
+    SDLScaler_Present(cps3_canvas, message_canvas);
 
     // Render metrics
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
@@ -276,38 +304,31 @@ void SDLApp_EndFrame() {
     SDL_SetRenderScale(renderer, 1, 1);
 
     SDL_RenderPresent(renderer);
+    SDLPad_NotePresented();
+
+    // The frame has been submitted, so reading it back doesn't flush anything
+    SDLCapture_CaptureFrame(cps3_canvas);
 
     // Cleanup
     SDLGameRenderer_EndFrame();
-    should_save_screenshot = false;
 
     // Handle cursor hiding
     hide_cursor_if_needed();
 
-    // Do frame pacing
-    Uint64 now = SDL_GetTicksNS();
-
-    if (frame_deadline == 0) {
-        frame_deadline = now + target_frame_time_ns;
-    }
-
-    if (now < frame_deadline) {
-        Uint64 sleep_time = frame_deadline - now;
-        SDL_DelayNS(sleep_time);
-        now = SDL_GetTicksNS();
+    // Do frame pacing. Headless runs are uncapped
+    if (!Bench_IsHeadless()) {
+        SDLFramePacer_WaitForNextFrame();
     }
 
-    frame_deadline += target_frame_time_ns;
+    measure_frame();
+}
 
-    // If we fell behind by more than one frame, resync to avoid spiraling
-    if (now > frame_deadline + target_frame_time_ns) {
-        frame_deadline = now + target_frame_time_ns;
-    }
+void SDLApp_EndUndrawnFrame() {
+    run_vblank();
 
-    // Measure
-    frame_counter += 1;
-    note_frame_end_time();
-    update_fps();
+    // Textures the game released during the frame are still destroyed here
+    SDLGameRenderer_EndFrame();
+    measure_frame();
 }
 
 void SDLApp_Exit() {
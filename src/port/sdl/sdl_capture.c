@@ -0,0 +1,521 @@
+#include "port/sdl/sdl_capture.h"
+#include "port/config.h"
+
+#include <SDL3/SDL.h>
+
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+
+#include "zlib.h"
+
+#include <time.h>
+
+// Screenshot and video capture with the expensive work off the game thread.
+//
+// The SDL renderer has no asynchronous readback: `SDL_RenderReadPixels` flushes the queued draws
+// and waits for the GPU to finish them. So a captured frame is read back once, right after
+// `SDL_RenderPresent` has submitted it, when there is nothing left to flush. What a captured frame
+// costs on the game thread is the wait for the GPU to finish that frame plus copying the canvas
+// (384x224, 336 KB) to memory. Frames that aren't captured cost nothing. The surface is handed to
+// a worker thread that does all pixel conversion and encoding (PNG for screenshots, libavcodec for
+// recordings).
+
+#define MAX_QUEUED_FRAMES 16
+#define CAPTURE_FPS_NUM 5959949
+#define CAPTURE_FPS_DEN 100000
+
+typedef enum JobType {
+    JOB_SCREENSHOT,
+    JOB_VIDEO_START,
+    JOB_VIDEO_FRAME,
+    JOB_VIDEO_STOP,
+    JOB_QUIT,
+} JobType;
+
+typedef struct Job {
+    JobType type;
+    SDL_Surface* surface;
+    Sint64 pts;
+    char* path;
+    struct Job* next;
+} Job;
+
+typedef struct VideoEncoder {
+    AVFormatContext* format;
+    AVCodecContext* codec;
+    AVStream* stream;
+    AVFrame* frame;
+    AVPacket* packet;
+} VideoEncoder;
+
+static SDL_Renderer* _renderer = NULL;
+static int capture_width = 0;
+static int capture_height = 0;
+
+// Game thread state
+static bool screenshot_requested = false;
+static bool recording = false;
+static Sint64 recording_pts = 0;
+static int dropped_frames = 0;
+
+// Shared with the worker
+static SDL_Thread* worker = NULL;
+static SDL_Mutex* queue_mutex = NULL;
+static SDL_Condition* queue_cond = NULL;
+static Job* queue_head = NULL;
+static Job* queue_tail = NULL;
+static int queued_frames = 0;
+
+// Paths
+
+static char* make_capture_path(const char* prefix, const char* extension) {
+    static int counter = 0;
+    char* base = SDL_GetPrefPath("CrowdedStreet", "3SX");
+    char* dir = NULL;
+    char* path = NULL;
+    char timestamp[32];
+
+    const time_t now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y%m%d-%H%M%S", localtime(&now));
+
+    SDL_asprintf(&dir, "%scaptures", base);
+    SDL_CreateDirectory(dir);
+    SDL_asprintf(&path, "%s/%s_%s_%d.%s", dir, prefix, timestamp, counter, extension);
+    counter += 1;
+
+    SDL_free(base);
+    SDL_free(dir);
+    return path;
+}
+
+// PNG
+
+static void put_u32_be(Uint8* dst, Uint32 value) {
+    dst[0] = value >> 24;
+    dst[1] = value >> 16;
+    dst[2] = value >> 8;
+    dst[3] = value;
+}
+
+static void write_png_chunk(SDL_IOStream* io, const char* type, const Uint8* data, Uint32 size) {
+    Uint8 header[8];
+    Uint8 footer[4];
+
+    put_u32_be(header, size);
+    SDL_memcpy(header + 4, type, 4);
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, header + 4, 4);
+
+    if (size > 0) {
+        crc = crc32(crc, data, size);
+    }
+
+    put_u32_be(footer, crc);
+
+    SDL_WriteIO(io, header, sizeof(header));
+    SDL_WriteIO(io, data, size);
+    SDL_WriteIO(io, footer, sizeof(footer));
+}
+
+static bool write_png(const char* path, SDL_Surface* surface) {
+    const int w = surface->w;
+    const int h = surface->h;
+    const int row_size = w * 4 + 1; // Each row starts with a filter type byte
+    const uLong raw_size = (uLong)row_size * h;
+    Uint8* raw = SDL_malloc(raw_size);
+
+    for (int y = 0; y < h; y++) {
+        Uint8* row = raw + y * row_size;
+        row[0] = 0; // No filter
+        SDL_ConvertPixels(w,
+                          1,
+                          surface->format,
+                          (Uint8*)surface->pixels + y * surface->pitch,
+                          surface->pitch,
+                          SDL_PIXELFORMAT_RGBA32,
+                          row + 1,
+                          w * 4);
+    }
+
+    uLongf compressed_size = raw_size + raw_size / 1000 + 64;
+    Uint8* compressed = SDL_malloc(compressed_size);
+    const bool compressed_ok = compress2(compressed, &compressed_size, raw, raw_size, 6) == Z_OK;
+    SDL_free(raw);
+
+    SDL_IOStream* io = compressed_ok ? SDL_IOFromFile(path, "wb") : NULL;
+
+    if (io == NULL) {
+        SDL_free(compressed);
+        return false;
+    }
+
+    static const Uint8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    Uint8 ihdr[13];
+    put_u32_be(ihdr, w);
+    put_u32_be(ihdr + 4, h);
+    ihdr[8] = 8;  // Bit depth
+    ihdr[9] = 6;  // Color type: RGBA
+    ihdr[10] = 0; // Compression
+    ihdr[11] = 0; // Filter
+    ihdr[12] = 0; // Interlace
+
+    SDL_WriteIO(io, signature, sizeof(signature));
+    write_png_chunk(io, "IHDR", ihdr, sizeof(ihdr));
+    write_png_chunk(io, "IDAT", compressed, compressed_size);
+    write_png_chunk(io, "IEND", NULL, 0);
+
+    SDL_free(compressed);
+    return SDL_CloseIO(io);
+}
+
+// Video
+
+static void print_av_error(const char* what, int errnum) {
+    char errbuf[AV_ERROR_MAX_STRING_SIZE] = { 0 };
+    av_strerror(errnum, errbuf, sizeof(errbuf));
+    SDL_Log("Capture: %s failed: %s", what, errbuf);
+}
+
+static void encoder_drain(VideoEncoder* encoder) {
+    while (avcodec_receive_packet(encoder->codec, encoder->packet) >= 0) {
+        av_packet_rescale_ts(encoder->packet, encoder->codec->time_base, encoder->stream->time_base);
+        encoder->packet->stream_index = encoder->stream->index;
+        av_interleaved_write_frame(encoder->format, encoder->packet);
+    }
+}
+
+static void encoder_close(VideoEncoder* encoder) {
+    if (encoder->codec != NULL) {
+        avcodec_send_frame(encoder->codec, NULL);
+        encoder_drain(encoder);
+    }
+
+    if ((encoder->format != NULL) && (encoder->format->pb != NULL)) {
+        av_write_trailer(encoder->format);
+        avio_closep(&encoder->format->pb);
+    }
+
+    av_frame_free(&encoder->frame);
+    av_packet_free(&encoder->packet);
+    avcodec_free_context(&encoder->codec);
+    avformat_free_context(encoder->format);
+    SDL_zerop(encoder);
+}
+
+static bool encoder_open(VideoEncoder* encoder, const char* path) {
+    const char* codec_name = Config_GetString("capture_codec", "ffv1");
+    const AVCodec* codec = avcodec_find_encoder_by_name(codec_name);
+    int ret;
+
+    SDL_zerop(encoder);
+
+    if (codec == NULL) {
+        SDL_Log("Capture: encoder \"%s\" is not available", codec_name);
+        return false;
+    }
+
+    if ((ret = avformat_alloc_output_context2(&encoder->format, NULL, NULL, path)) < 0) {
+        print_av_error("avformat_alloc_output_context2", ret);
+        return false;
+    }
+
+    encoder->stream = avformat_new_stream(encoder->format, NULL);
+    encoder->codec = avcodec_alloc_context3(codec);
+
+    if ((encoder->stream == NULL) || (encoder->codec == NULL)) {
+        SDL_Log("Capture: couldn't allocate the video stream");
+        encoder_close(encoder);
+        return false;
+    }
+
+    encoder->codec->width = capture_width;
+    encoder->codec->height = capture_height;
+    encoder->codec->time_base = (AVRational) { CAPTURE_FPS_DEN, CAPTURE_FPS_NUM };
+    encoder->codec->framerate = (AVRational) { CAPTURE_FPS_NUM, CAPTURE_FPS_DEN };
+    encoder->codec->pix_fmt = AV_PIX_FMT_BGRA;
+
+    if (encoder->format->oformat->flags & AVFMT_GLOBALHEADER) {
+        encoder->codec->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+
+    if ((ret = avcodec_open2(encoder->codec, codec, NULL)) < 0) {
+        print_av_error("avcodec_open2", ret);
+        encoder_close(encoder);
+        return false;
+    }
+
+    avcodec_parameters_from_context(encoder->stream->codecpar, encoder->codec);
+    encoder->stream->time_base = encoder->codec->time_base;
+
+    if ((ret = avio_open(&encoder->format->pb, path, AVIO_FLAG_WRITE)) < 0) {
+        print_av_error("avio_open", ret);
+        encoder_close(encoder);
+        return false;
+    }
+
+    if ((ret = avformat_write_header(encoder->format, NULL)) < 0) {
+        print_av_error("avformat_write_header", ret);
+        encoder_close(encoder);
+        return false;
+    }
+
+    encoder->packet = av_packet_alloc();
+    encoder->frame = av_frame_alloc();
+
+    if ((encoder->packet == NULL) || (encoder->frame == NULL)) {
+        SDL_Log("Capture: couldn't allocate the video frame");
+        encoder_close(encoder);
+        return false;
+    }
+
+    encoder->frame->format = encoder->codec->pix_fmt;
+    encoder->frame->width = capture_width;
+    encoder->frame->height = capture_height;
+
+    if ((ret = av_frame_get_buffer(encoder->frame, 0)) < 0) {
+        print_av_error("av_frame_get_buffer", ret);
+        encoder_close(encoder);
+        return false;
+    }
+
+    return true;
+}
+
+static void encoder_write(VideoEncoder* encoder, SDL_Surface* surface, Sint64 pts) {
+    int ret = av_frame_make_writable(encoder->frame);
+
+    if (ret < 0) {
+        print_av_error("av_frame_make_writable", ret);
+        return;
+    }
+
+    SDL_ConvertPixels(surface->w,
+                      surface->h,
+                      surface->format,
+                      surface->pixels,
+                      surface->pitch,
+                      SDL_PIXELFORMAT_BGRA32,
+                      encoder->frame->data[0],
+                      encoder->frame->linesize[0]);
+    encoder->frame->pts = pts;
+    ret = avcodec_send_frame(encoder->codec, encoder->frame);
+
+    if (ret < 0) {
+        print_av_error("avcodec_send_frame", ret);
+        return;
+    }
+
+    encoder_drain(encoder);
+}
+
+// Worker
+
+static void push_job(Job* job) {
+    SDL_LockMutex(queue_mutex);
+
+    if (queue_tail != NULL) {
+        queue_tail->next = job;
+    } else {
+        queue_head = job;
+    }
+
+    queue_tail = job;
+
+    if (job->surface != NULL) {
+        queued_frames += 1;
+    }
+
+    SDL_SignalCondition(queue_cond);
+    SDL_UnlockMutex(queue_mutex);
+}
+
+static Job* pop_job() {
+    SDL_LockMutex(queue_mutex);
+
+    while (queue_head == NULL) {
+        SDL_WaitCondition(queue_cond, queue_mutex);
+    }
+
+    Job* job = queue_head;
+    queue_head = job->next;
+
+    if (queue_head == NULL) {
+        queue_tail = NULL;
+    }
+
+    if (job->surface != NULL) {
+        queued_frames -= 1;
+    }
+
+    SDL_UnlockMutex(queue_mutex);
+    return job;
+}
+
+static int worker_main(void* data) {
+    VideoEncoder encoder = { 0 };
+    bool encoder_ready = false;
+    bool running = true;
+
+    while (running) {
+        Job* job = pop_job();
+
+        switch (job->type) {
+        case JOB_SCREENSHOT:
+            if (write_png(job->path, job->surface)) {
+                SDL_Log("Capture: saved %s", job->path);
+            } else {
+                SDL_Log("Capture: couldn't save %s", job->path);
+            }
+
+            break;
+
+        case JOB_VIDEO_START:
+            encoder_ready = encoder_open(&encoder, job->path);
+
+            if (encoder_ready) {
+                SDL_Log("Capture: recording to %s", job->path);
+            }
+
+            break;
+
+        case JOB_VIDEO_FRAME:
+            if (encoder_ready) {
+                encoder_write(&encoder, job->surface, job->pts);
+            }
+
+            break;
+
+        case JOB_VIDEO_STOP:
+            if (encoder_ready) {
+                encoder_close(&encoder);
+                encoder_ready = false;
+                SDL_Log("Capture: recording stopped");
+            }
+
+            break;
+
+        case JOB_QUIT:
+            running = false;
+            break;
+        }
+
+        SDL_DestroySurface(job->surface);
+        SDL_free(job->path);
+        SDL_free(job);
+    }
+
+    if (encoder_ready) {
+        encoder_close(&encoder);
+    }
+
+    return 0;
+}
+
+static void submit_job(JobType type, SDL_Surface* surface, Sint64 pts, char* path) {
+    Job* job = SDL_calloc(1, sizeof(Job));
+    job->type = type;
+    job->surface = surface;
+    job->pts = pts;
+    job->path = path;
+    push_job(job);
+}
+
+// Game thread
+
+/// @brief Hand `surface` to the worker as a video frame, or drop it if the worker is behind.
+static void submit_video_frame(SDL_Surface* surface) {
+    // Never let the encoder hold back the game. If it can't keep up, drop frames.
+    SDL_LockMutex(queue_mutex);
+    const bool queue_full = queued_frames >= MAX_QUEUED_FRAMES;
+    SDL_UnlockMutex(queue_mutex);
+
+    if (queue_full) {
+        dropped_frames += 1;
+        SDL_DestroySurface(surface);
+    } else {
+        submit_job(JOB_VIDEO_FRAME, surface, recording_pts, NULL);
+    }
+
+    recording_pts += 1;
+}
+
+void SDLCapture_Init(SDL_Renderer* renderer, int width, int height) {
+    _renderer = renderer;
+    capture_width = width;
+    capture_height = height;
+    queue_mutex = SDL_CreateMutex();
+    queue_cond = SDL_CreateCondition();
+    worker = SDL_CreateThread(worker_main, "capture", NULL);
+}
+
+void SDLCapture_Quit() {
+    if (recording) {
+        SDLCapture_ToggleRecording();
+    }
+
+    submit_job(JOB_QUIT, NULL, 0, NULL);
+    SDL_WaitThread(worker, NULL);
+    worker = NULL;
+
+    SDL_DestroyCondition(queue_cond);
+    SDL_DestroyMutex(queue_mutex);
+}
+
+void SDLCapture_RequestScreenshot() {
+    screenshot_requested = true;
+}
+
+void SDLCapture_ToggleRecording() {
+    if (!recording) {
+        recording = true;
+        recording_pts = 0;
+        dropped_frames = 0;
+        submit_job(JOB_VIDEO_START, NULL, 0, make_capture_path("recording", "mkv"));
+        return;
+    }
+
+    recording = false;
+    submit_job(JOB_VIDEO_STOP, NULL, 0, NULL);
+
+    if (dropped_frames > 0) {
+        SDL_Log("Capture: dropped %d frames because the encoder couldn't keep up", dropped_frames);
+    }
+}
+
+bool SDLCapture_IsRecording() {
+    return recording;
+}
+
+void SDLCapture_CaptureFrame(SDL_Texture* canvas) {
+    if (!screenshot_requested && !recording) {
+        return;
+    }
+
+    SDL_Texture* prev_target = SDL_GetRenderTarget(_renderer);
+    SDL_SetRenderTarget(_renderer, canvas);
+    SDL_Surface* surface = SDL_RenderReadPixels(_renderer, NULL);
+    SDL_SetRenderTarget(_renderer, prev_target);
+
+    if (surface == NULL) {
+        SDL_Log("Capture: couldn't read the frame back: %s", SDL_GetError());
+        screenshot_requested = false;
+        return;
+    }
+
+    if (screenshot_requested) {
+        SDL_Surface* copy = recording ? SDL_ConvertSurface(surface, surface->format) : surface;
+        screenshot_requested = false;
+
+        if (copy != NULL) {
+            submit_job(JOB_SCREENSHOT, copy, 0, make_capture_path("screenshot", "png"));
+        }
+
+        if (!recording) {
+            return;
+        }
+    }
+
+    submit_video_frame(surface);
+}
@@ -0,0 +1,241 @@
+#include "port/sdl/sdl_frame_pacer.h"
+#include "port/config.h"
+#include "port/sound/mixer.h"
+
+#include <SDL3/SDL.h>
+
+#include <math.h>
+
+// Frame pacing slaved to the audio device clock.
+//
+// The mixer output stream is pulled by the audio device, so the number of samples it has consumed is
+// the most stable clock we have. Every frame we compare it with the number of samples the game
+// should have produced by now and turn the difference into a small rate correction (at most
+// MAX_RATE_ADJUSTMENT). Without vsync the correction stretches the frame deadline. With vsync on a
+// fixed-refresh display the display is the master, so the correction resamples audio instead.
+
+#define SAMPLE_RATE MIXER_SAMPLE_RATE
+#define MAX_RATE_ADJUSTMENT 0.005
+#define CORRECTION_HORIZON_FRAMES 120
+#define DRIFT_SMOOTHING 0.05
+#define RESYNC_THRESHOLD_MS 250
+#define HISTOGRAM_BIN_NS 100000 // 0.1 ms
+#define HISTOGRAM_BINS 1000
+#define REFRESH_MATCH_TOLERANCE 0.01
+
+typedef enum PacingMode {
+    PACING_MODE_AUDIO, // Sleep towards a deadline nudged by the audio clock
+    PACING_MODE_DISPLAY, // Present blocks on vsync, audio is resampled to follow
+} PacingMode;
+
+static SDL_Renderer* _renderer = NULL;
+static PacingMode mode = PACING_MODE_AUDIO;
+static Uint64 target_frame_time_ns = 0;
+static double samples_per_frame = 0;
+
+// Clock tracking
+static Uint64 frame_deadline = 0;
+static bool clock_synced = false;
+static u32 base_played_samples = 0;
+static Uint64 frames_since_sync = 0;
+static double smoothed_drift = 0;
+static double rate_adjustment = 0;
+
+// Statistics
+static Uint64 last_frame_end = 0;
+static Uint64 stat_frames = 0;
+static Uint64 stat_late_frames = 0;
+static double stat_mean_ns = 0;
+static double stat_m2 = 0;
+static Uint64 stat_min_ns = UINT64_MAX;
+static Uint64 stat_max_ns = 0;
+static Uint32 histogram[HISTOGRAM_BINS] = { 0 };
+static Uint64 stats_log_interval_ns = 0;
+static Uint64 last_stats_log = 0;
+
+static bool display_matches_target(double target_fps) {
+    const SDL_DisplayID display = SDL_GetDisplayForWindow(SDL_GetRenderWindow(_renderer));
+    const SDL_DisplayMode* display_mode = SDL_GetCurrentDisplayMode(display);
+
+    if ((display_mode == NULL) || (display_mode->refresh_rate <= 0)) {
+        return false;
+    }
+
+    return fabs(display_mode->refresh_rate - target_fps) / target_fps < REFRESH_MATCH_TOLERANCE;
+}
+
+void SDLFramePacer_Init(SDL_Renderer* renderer, double target_fps) {
+    _renderer = renderer;
+    target_frame_time_ns = SDL_NS_PER_SECOND / target_fps;
+    samples_per_frame = SAMPLE_RATE / target_fps;
+    stats_log_interval_ns = (Uint64)Config_GetInt("frame_stats_interval", 0) * SDL_NS_PER_SECOND;
+
+    const bool vsync = Config_GetBool("vsync", false);
+    const bool vrr = Config_GetBool("vrr", false);
+
+    mode = PACING_MODE_AUDIO;
+
+    if (vsync && SDL_SetRenderVSync(renderer, 1)) {
+        // A VRR display refreshes whenever we present, so we keep pacing ourselves.
+        // A fixed-refresh display close to the arcade rate can drive the game directly.
+        if (!vrr && display_matches_target(target_fps)) {
+            mode = PACING_MODE_DISPLAY;
+        }
+    }
+
+    SDLFramePacer_Resync();
+}
+
+void SDLFramePacer_Resync() {
+    clock_synced = false;
+    frame_deadline = 0;
+    smoothed_drift = 0;
+    rate_adjustment = 0;
+    Mixer_SetRateRatio(1.0f);
+}
+
+static void update_audio_clock() {
+    const u32 played_samples = Mixer_GetPlayedSamples();
+
+    if (!clock_synced) {
+        base_played_samples = played_samples;
+        frames_since_sync = 0;
+        clock_synced = true;
+        return;
+    }
+
+    frames_since_sync += 1;
+
+    const double expected = frames_since_sync * samples_per_frame;
+    const double actual = (u32)(played_samples - base_played_samples);
+    const double drift = actual - expected;
+
+    if (fabs(drift) > (SAMPLE_RATE * RESYNC_THRESHOLD_MS / 1000.0)) {
+        // Audio device stalled or the game hitched. Chasing that would take seconds,
+        // so start over from the current position.
+        SDLFramePacer_Resync();
+        return;
+    }
+
+    // The device consumes audio in bursts of its buffer size. Smooth that out before reacting.
+    smoothed_drift += (drift - smoothed_drift) * DRIFT_SMOOTHING;
+    rate_adjustment = smoothed_drift / (samples_per_frame * CORRECTION_HORIZON_FRAMES);
+    rate_adjustment = SDL_clamp(rate_adjustment, -MAX_RATE_ADJUSTMENT, MAX_RATE_ADJUSTMENT);
+}
+
+static void record_frame_time(Uint64 now) {
+    if (last_frame_end == 0) {
+        last_frame_end = now;
+        last_stats_log = now;
+        return;
+    }
+
+    const Uint64 frame_time = now - last_frame_end;
+    last_frame_end = now;
+
+    stat_frames += 1;
+
+    const double delta = frame_time - stat_mean_ns;
+    stat_mean_ns += delta / stat_frames;
+    stat_m2 += delta * (frame_time - stat_mean_ns);
+
+    stat_min_ns = SDL_min(stat_min_ns, frame_time);
+    stat_max_ns = SDL_max(stat_max_ns, frame_time);
+
+    if (frame_time > target_frame_time_ns * 3 / 2) {
+        stat_late_frames += 1;
+    }
+
+    const Uint64 bin = SDL_min(frame_time / HISTOGRAM_BIN_NS, HISTOGRAM_BINS - 1);
+    histogram[bin] += 1;
+
+    if ((stats_log_interval_ns > 0) && (now - last_stats_log >= stats_log_interval_ns)) {
+        SDLFramePacer_LogStats();
+        last_stats_log = now;
+    }
+}
+
+void SDLFramePacer_WaitForNextFrame() {
+    update_audio_clock();
+
+    Uint64 now = SDL_GetTicksNS();
+
+    switch (mode) {
+    case PACING_MODE_AUDIO: {
+        const Uint64 frame_time = target_frame_time_ns * (1.0 - rate_adjustment);
+
+        if (frame_deadline == 0) {
+            frame_deadline = now + frame_time;
+        }
+
+        if (now < frame_deadline) {
+            SDL_DelayPrecise(frame_deadline - now);
+            now = SDL_GetTicksNS();
+        }
+
+        frame_deadline += frame_time;
+
+        // If we fell behind by more than one frame, resync to avoid spiraling
+        if (now > frame_deadline + frame_time) {
+            frame_deadline = now + frame_time;
+        }
+
+        break;
+    }
+
+    case PACING_MODE_DISPLAY:
+        // SDL_RenderPresent already waited for vsync. Make audio follow the display instead.
+        Mixer_SetRateRatio(1.0f - rate_adjustment);
+        break;
+    }
+
+    record_frame_time(now);
+}
+
+void SDLFramePacer_GetStats(SDLFramePacer_Stats* stats) {
+    SDL_zerop(stats);
+
+    stats->frames = stat_frames;
+    stats->late_frames = stat_late_frames;
+    stats->audio_drift_ms = smoothed_drift * 1000 / SAMPLE_RATE;
+    stats->rate_adjustment = rate_adjustment;
+
+    if (stat_frames == 0) {
+        return;
+    }
+
+    stats->mean_ms = stat_mean_ns / 1e6;
+    stats->stddev_ms = sqrt(stat_m2 / stat_frames) / 1e6;
+    stats->min_ms = stat_min_ns / 1e6;
+    stats->max_ms = stat_max_ns / 1e6;
+
+    const Uint64 p99_count = (stat_frames * 99 + 99) / 100;
+    Uint64 count = 0;
+
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        count += histogram[i];
+
+        if (count >= p99_count) {
+            stats->p99_ms = (double)(i + 1) * HISTOGRAM_BIN_NS / 1e6;
+            break;
+        }
+    }
+}
+
+void SDLFramePacer_LogStats() {
+    SDLFramePacer_Stats stats;
+    SDLFramePacer_GetStats(&stats);
+
+    SDL_Log("Frame pacing (%s): %llu frames, mean %.3f ms, stddev %.3f ms, min %.3f ms, max %.3f ms, p99 %.1f ms, "
+            "late %llu, audio drift %.2f ms, rate adjustment %+.3f%%",
+            (mode == PACING_MODE_DISPLAY) ? "display" : "audio",
+            (unsigned long long)stats.frames,
+            stats.mean_ms,
+            stats.stddev_ms,
+            stats.min_ms,
+            stats.max_ms,
+            stats.p99_ms,
+            (unsigned long long)stats.late_frames,
+            stats.audio_drift_ms,
+            stats.rate_adjustment * 100);
+}
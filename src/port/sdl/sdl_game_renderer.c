@@ -1,5 +1,6 @@
 #include "port/sdl/sdl_game_renderer.h"
 #include "common.h"
+#include "port/config.h"
 #include "sf33rd/AcrSDK/ps2/flps2etc.h"
 #include "sf33rd/AcrSDK/ps2/flps2render.h"
 #include "sf33rd/AcrSDK/ps2/foundaps2.h"
@@ -12,6 +13,39 @@
 #include <stdlib.h>
 
 #define RENDER_TASK_MAX 1024
+#define LAYER_SIZE 1024
+#define LAYER_CELL_SIZE 128
+#define LAYER_CELLS_PER_ROW (LAYER_SIZE / LAYER_CELL_SIZE)
+#define LAYER_CELL_DEPS_MAX 16
+#define TEXTURE_SERIAL_PROPERTY "3sx.texture_serial"
+
+// Textures that have a cached variant for a palette. Lets palette updates evict
+// only those textures instead of scanning the whole cache.
+typedef struct PaletteUsers {
+    Uint16* texture_indices;
+    int count;
+    int capacity;
+} PaletteUsers;
+
+// A texture a layer cell was drawn with. The serial changes whenever the texture is recreated,
+// e.g. after its palette changed.
+typedef struct LayerCellDep {
+    unsigned int tex_code;
+    Sint64 serial;
+} LayerCellDep;
+
+typedef struct LayerCell {
+    bool valid;
+    bool cacheable;
+    Uint64 key;
+    int dep_count;
+    LayerCellDep deps[LAYER_CELL_DEPS_MAX];
+} LayerCell;
+
+typedef struct Layer {
+    SDL_Texture* texture;
+    LayerCell cells[LAYER_CELLS_PER_ROW * LAYER_CELLS_PER_ROW];
+} Layer;
 
 typedef struct RenderTask {
     SDL_Texture* texture;
@@ -31,10 +65,25 @@ static SDL_Palette* palettes[FL_PALETTE_MAX] = { NULL };
 static SDL_Texture* textures[FL_PALETTE_MAX] = { NULL };
 static int texture_count = 0;
 static SDL_Texture* texture_cache[FL_TEXTURE_MAX][FL_PALETTE_MAX + 1] = { { NULL } };
+static PaletteUsers palette_users[FL_PALETTE_MAX + 1] = { { 0 } };
+static bool palette_user_linked[FL_TEXTURE_MAX][FL_PALETTE_MAX + 1] = { { false } };
+static bool palette_dirty[FL_PALETTE_MAX] = { false };
 static SDL_Texture* textures_to_destroy[1024] = { NULL };
 static int textures_to_destroy_count = 0;
 static RenderTask render_tasks[RENDER_TASK_MAX] = { 0 };
 static int render_task_count = 0;
+static Sint64 next_texture_serial = 1;
+static unsigned int current_tex_code = 0;
+static bool is_draw_enabled = true;
+
+// Background layer cache
+static bool layer_cache_enabled = true;
+static Layer layers[SDL_GAME_RENDERER_LAYER_COUNT] = { 0 };
+static Layer* capture_layer = NULL;
+static LayerCell* capture_cell = NULL;
+static float capture_origin_x = 0;
+static float capture_origin_y = 0;
+static SDL_Texture* capture_prev_target = NULL;
 
 // Debugging
 
@@ -156,6 +205,44 @@ static int compare_render_tasks(const RenderTask* a, const RenderTask* b) {
     }
 }
 
+// Palette users
+
+static void link_palette_user(int texture_index, int palette_handle) {
+    PaletteUsers* users = &palette_users[palette_handle];
+
+    if (palette_user_linked[texture_index][palette_handle]) {
+        return;
+    }
+
+    if (users->count == users->capacity) {
+        users->capacity = SDL_max(users->capacity * 2, 8);
+        users->texture_indices = SDL_realloc(users->texture_indices, users->capacity * sizeof(Uint16));
+    }
+
+    users->texture_indices[users->count] = texture_index;
+    users->count += 1;
+    palette_user_linked[texture_index][palette_handle] = true;
+}
+
+static void evict_palette_users(int palette_handle) {
+    PaletteUsers* users = &palette_users[palette_handle];
+
+    for (int i = 0; i < users->count; i++) {
+        const int texture_index = users->texture_indices[i];
+        SDL_Texture** texture_p = &texture_cache[texture_index][palette_handle];
+
+        // The texture may have been destroyed since it was linked
+        if (*texture_p != NULL) {
+            push_texture_to_destroy(*texture_p);
+            *texture_p = NULL;
+        }
+
+        palette_user_linked[texture_index][palette_handle] = false;
+    }
+
+    users->count = 0;
+}
+
 // Colors
 
 #define clut_shuf(x) (((x) & ~0x18) | ((((x) & 0x08) << 1) | (((x) & 0x10) >> 1)))
@@ -216,6 +303,7 @@ void SDLGameRenderer_Init(SDL_Renderer* renderer) {
     cps3_canvas =
         SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, cps3_width, cps3_height);
     SDL_SetTextureScaleMode(cps3_canvas, SDL_SCALEMODE_NEAREST);
+    layer_cache_enabled = Config_GetBool("bg_layer_cache", true);
 }
 
 void SDLGameRenderer_BeginFrame() {
@@ -274,11 +362,11 @@ void SDLGameRenderer_EndFrame() {
 
 void SDLGameRenderer_UnlockPalette(unsigned int ph) {
     const int palette_handle = ph;
-    if ((palette_handle > 0) && (palette_handle < FL_PALETTE_MAX)) {
-        const FLTexture* fl_palette = &flPalette[palette_handle - 1];
 
-        SDLGameRenderer_DestroyPalette(palette_handle);
-        SDLGameRenderer_CreatePalette(ph << 16);
+    // Palettes are often unlocked every frame without changing, and some are unlocked several
+    // times per frame. Defer the work until a texture actually uses the palette.
+    if ((palette_handle > 0) && (palette_handle < FL_PALETTE_MAX) && (palettes[palette_handle - 1] != NULL)) {
+        palette_dirty[palette_handle - 1] = true;
     }
 }
 
@@ -347,18 +435,21 @@ void SDLGameRenderer_DestroyTexture(unsigned int texture_handle) {
     surfaces[texture_index] = NULL;
 }
 
-void SDLGameRenderer_CreatePalette(unsigned int ph) {
-    const int palette_index = HI_16_BITS(ph) - 1;
+void SDLGameRenderer_RelocateTextures() {
+    // Surfaces wrap the pixels in system memory without copying them
+    for (int i = 0; i < FL_TEXTURE_MAX; i++) {
+        if (surfaces[i] != NULL) {
+            surfaces[i]->pixels = flPS2GetSystemBuffAdrs(flTexture[i].mem_handle);
+        }
+    }
+}
+
+static int read_palette_colors(int palette_index, SDL_Color* colors) {
     const FLTexture* fl_palette = &flPalette[palette_index];
     const void* pixels = flPS2GetSystemBuffAdrs(fl_palette->mem_handle);
     const int color_count = fl_palette->width * fl_palette->height;
-    SDL_Color colors[256];
     size_t color_size = 0;
 
-    if (palettes[palette_index] != NULL) {
-        fatal_error("Overwriting an existing palette");
-    }
-
     switch (fl_palette->format) {
     case SCE_GS_PSMCT32:
         color_size = 4;
@@ -394,35 +485,73 @@ void SDLGameRenderer_CreatePalette(unsigned int ph) {
         break;
     }
 
-    SDL_Palette* palette = SDL_CreatePalette(color_count);
-    SDL_SetPaletteColors(palette, colors, 0, color_count);
-    palettes[palette_index] = palette;
+    return color_count;
 }
 
-void SDLGameRenderer_DestroyPalette(unsigned int palette_handle) {
+static void update_palette_if_dirty(int palette_handle) {
     const int palette_index = palette_handle - 1;
+    SDL_Palette* palette = palettes[palette_index];
+    SDL_Color colors[256];
 
-    for (int i = 0; i < FL_TEXTURE_MAX; i++) {
-        SDL_Texture** texture_p = &texture_cache[i][palette_handle];
+    if (!palette_dirty[palette_index]) {
+        return;
+    }
 
-        if (*texture_p == NULL) {
-            continue;
-        }
+    palette_dirty[palette_index] = false;
+    const int color_count = read_palette_colors(palette_index, colors);
 
-        push_texture_to_destroy(*texture_p);
-        *texture_p = NULL;
+    const size_t colors_size = color_count * sizeof(SDL_Color);
+
+    if ((color_count == palette->ncolors) && (SDL_memcmp(colors, palette->colors, colors_size) == 0)) {
+        return;
+    }
+
+    SDL_SetPaletteColors(palette, colors, 0, color_count);
+    evict_palette_users(palette_handle);
+}
+
+void SDLGameRenderer_CreatePalette(unsigned int ph) {
+    const int palette_index = HI_16_BITS(ph) - 1;
+    SDL_Color colors[256];
+
+    if (palettes[palette_index] != NULL) {
+        fatal_error("Overwriting an existing palette");
     }
 
+    const int color_count = read_palette_colors(palette_index, colors);
+    SDL_Palette* palette = SDL_CreatePalette(color_count);
+    SDL_SetPaletteColors(palette, colors, 0, color_count);
+    palettes[palette_index] = palette;
+    palette_dirty[palette_index] = false;
+}
+
+void SDLGameRenderer_DestroyPalette(unsigned int palette_handle) {
+    const int palette_index = palette_handle - 1;
+
+    evict_palette_users(palette_handle);
     SDL_DestroyPalette(palettes[palette_index]);
     palettes[palette_index] = NULL;
+    palette_dirty[palette_index] = false;
+}
+
+void SDLGameRenderer_SetDrawEnabled(bool enabled) {
+    is_draw_enabled = enabled;
 }
 
 void SDLGameRenderer_SetTexture(unsigned int th) {
+    if (!is_draw_enabled) {
+        return;
+    }
+
     const int texture_handle = LO_16_BITS(th);
     const SDL_Surface* surface = surfaces[texture_handle - 1];
     const int palette_handle = HI_16_BITS(th);
     const SDL_Palette* palette = palette_handle != 0 ? palettes[palette_handle - 1] : NULL;
 
+    if (palette != NULL) {
+        update_palette_if_dirty(palette_handle);
+    }
+
     if (dump_textures) {
         save_texture(surface, palette);
     }
@@ -440,13 +569,68 @@ void SDLGameRenderer_SetTexture(unsigned int th) {
         texture = SDL_CreateTextureFromSurface(_renderer, surface);
         SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
         SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        SDL_SetNumberProperty(SDL_GetTextureProperties(texture), TEXTURE_SERIAL_PROPERTY, next_texture_serial);
+        next_texture_serial += 1;
         texture_cache[texture_handle - 1][palette_handle] = texture;
+
+        if (palette_handle != 0) {
+            link_palette_user(texture_handle - 1, palette_handle);
+        }
     }
 
     push_texture(texture);
+    current_tex_code = th;
+}
+
+static void capture_quad(RenderTask* task) {
+    LayerCell* cell = capture_cell;
+
+    if (task->texture != NULL) {
+        bool known = false;
+
+        for (int i = 0; i < cell->dep_count; i++) {
+            if (cell->deps[i].tex_code == current_tex_code) {
+                known = true;
+                break;
+            }
+        }
+
+        if (!known && (cell->dep_count < LAYER_CELL_DEPS_MAX)) {
+            LayerCellDep* dep = &cell->deps[cell->dep_count];
+            dep->tex_code = current_tex_code;
+            dep->serial = SDL_GetNumberProperty(SDL_GetTextureProperties(task->texture), TEXTURE_SERIAL_PROPERTY, 0);
+            cell->dep_count += 1;
+        } else if (!known) {
+            // Too many textures to track, redraw this cell every frame
+            cell->cacheable = false;
+        }
+    }
+
+    for (int i = 0; i < 4; i++) {
+        task->vertices[i].position.x += capture_origin_x;
+        task->vertices[i].position.y += capture_origin_y;
+    }
+
+    // Copy texels as they are, blending happens when the layer is drawn
+    const int indices[] = { 0, 1, 2, 1, 2, 3 };
+    SDL_SetRenderTarget(_renderer, capture_layer->texture);
+
+    if (task->texture != NULL) {
+        SDL_SetTextureBlendMode(task->texture, SDL_BLENDMODE_NONE);
+    }
+
+    SDL_RenderGeometry(_renderer, task->texture, task->vertices, 4, indices, 6);
+
+    if (task->texture != NULL) {
+        SDL_SetTextureBlendMode(task->texture, SDL_BLENDMODE_BLEND);
+    }
 }
 
 static void draw_quad(const SDLGameRenderer_Vertex* vertices, bool textured) {
+    if (!is_draw_enabled) {
+        return;
+    }
+
     RenderTask task;
     task.index = render_task_count;
     task.texture = textured ? get_texture() : NULL;
@@ -466,6 +650,11 @@ static void draw_quad(const SDLGameRenderer_Vertex* vertices, bool textured) {
         read_rgba32_fcolor(vertices[i].color, &task.vertices[i].color);
     }
 
+    if (capture_cell != NULL) {
+        capture_quad(&task);
+        return;
+    }
+
     push_render_task(&task);
 }
 
@@ -529,3 +718,96 @@ void SDLGameRenderer_DrawSprite2(const SDLGameRenderer_Sprite2* sprite2) {
 
     SDLGameRenderer_DrawSprite(&sprite, sprite2->vertex_color);
 }
+
+// Background layers
+
+static bool layer_cell_is_current(const LayerCell* cell) {
+    for (int i = 0; i < cell->dep_count; i++) {
+        const LayerCellDep* dep = &cell->deps[i];
+        const int texture_handle = LO_16_BITS(dep->tex_code);
+        const int palette_handle = HI_16_BITS(dep->tex_code);
+
+        if ((palette_handle != 0) && (palettes[palette_handle - 1] != NULL)) {
+            update_palette_if_dirty(palette_handle);
+        }
+
+        SDL_Texture* texture = texture_cache[texture_handle - 1][palette_handle];
+
+        if (texture == NULL) {
+            return false;
+        }
+
+        if (SDL_GetNumberProperty(SDL_GetTextureProperties(texture), TEXTURE_SERIAL_PROPERTY, 0) != dep->serial) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SDLGameRenderer_IsLayerCacheEnabled() {
+    return layer_cache_enabled;
+}
+
+bool SDLGameRenderer_BeginLayerCell(int layer_index, int cell_x, int cell_y, Uint64 key) {
+    Layer* layer = &layers[layer_index];
+    LayerCell* cell = &layer->cells[cell_y * LAYER_CELLS_PER_ROW + cell_x];
+
+    if (!is_draw_enabled) {
+        return false;
+    }
+
+    if (cell->valid && (cell->key == key) && layer_cell_is_current(cell)) {
+        return false;
+    }
+
+    if (layer->texture == NULL) {
+        layer->texture =
+            SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, LAYER_SIZE, LAYER_SIZE);
+        SDL_SetTextureScaleMode(layer->texture, SDL_SCALEMODE_NEAREST);
+        SDL_SetTextureBlendMode(layer->texture, SDL_BLENDMODE_BLEND);
+    }
+
+    cell->valid = false;
+    cell->cacheable = true;
+    cell->key = key;
+    cell->dep_count = 0;
+
+    capture_layer = layer;
+    capture_cell = cell;
+    capture_origin_x = cell_x * LAYER_CELL_SIZE;
+    capture_origin_y = cell_y * LAYER_CELL_SIZE;
+    capture_prev_target = SDL_GetRenderTarget(_renderer);
+
+    // Clear the cell to transparent
+    SDL_BlendMode prev_blend_mode;
+    const SDL_FRect cell_rect = {
+        .x = capture_origin_x, .y = capture_origin_y, .w = LAYER_CELL_SIZE, .h = LAYER_CELL_SIZE
+    };
+    SDL_GetRenderDrawBlendMode(_renderer, &prev_blend_mode);
+    SDL_SetRenderTarget(_renderer, layer->texture);
+    SDL_SetRenderDrawBlendMode(_renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(_renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+    SDL_RenderFillRect(_renderer, &cell_rect);
+    SDL_SetRenderDrawBlendMode(_renderer, prev_blend_mode);
+
+    return true;
+}
+
+void SDLGameRenderer_EndLayerCell() {
+    capture_cell->valid = capture_cell->cacheable;
+    capture_cell = NULL;
+    capture_layer = NULL;
+    SDL_SetRenderTarget(_renderer, capture_prev_target);
+}
+
+void SDLGameRenderer_DrawLayer(int layer_index, const SDLGameRenderer_Sprite* sprite) {
+    const Layer* layer = &layers[layer_index];
+
+    if (!is_draw_enabled || (layer->texture == NULL)) {
+        return;
+    }
+
+    push_texture(layer->texture);
+    SDLGameRenderer_DrawSprite(sprite, 0xFFFFFFFF);
+}
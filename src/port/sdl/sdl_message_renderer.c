@@ -2,15 +2,47 @@
 
 #include <SDL3/SDL.h>
 
+// Text is drawn from a glyph atlas. knjsub uploads every glyph image each time it is drawn, so
+// glyphs are keyed by their font index and only converted the first time they are seen. All glyphs
+// of a frame go into one vertex buffer that is drawn with a single SDL_RenderGeometry call.
+
+#define ATLAS_SIZE 1024
+#define ATLAS_CELL_SIZE 32
+#define ATLAS_CELLS_PER_ROW (ATLAS_SIZE / ATLAS_CELL_SIZE)
+#define ATLAS_CELL_COUNT (ATLAS_CELLS_PER_ROW * ATLAS_CELLS_PER_ROW)
+#define GLYPH_TABLE_SIZE (ATLAS_CELL_COUNT * 2)
+#define BATCH_QUADS_MAX 1024
+#define NO_GLYPH 0xFFFFFFFF
+
+typedef struct GlyphEntry {
+    unsigned int key;
+    int cell;
+    int width;
+    int height;
+} GlyphEntry;
+
 SDL_Texture* message_canvas = NULL;
 
 static const int canvas_width = 512;
 static const int canvas_height = 448;
 
 static SDL_Renderer* _renderer = NULL;
-static SDL_Texture* knjsub_texture = NULL;
 static SDL_Palette* knjsub_palette = NULL;
-static int knjsub_palette_count = 0;
+
+// Atlas
+static SDL_Texture* atlas_texture = NULL;
+static GlyphEntry glyph_table[GLYPH_TABLE_SIZE];
+static int atlas_cells_used = 0;
+static unsigned int current_key = NO_GLYPH;
+static int current_cell = -1;
+static int current_width = 0;
+static int current_height = 0;
+
+// Batch
+static SDL_Vertex batch_vertices[BATCH_QUADS_MAX * 4];
+static int batch_indices[BATCH_QUADS_MAX * 6];
+static int batch_quads = 0;
+static bool is_draw_enabled = true;
 
 static const SDL_Color knjsub_palette_colors[4] = {
     { .r = 255, .g = 255, .b = 255, .a = 0 },
@@ -30,41 +62,146 @@ void SDLMessageRenderer_Initialize(SDL_Renderer* renderer) {
     // Initialize knjsub palette
     knjsub_palette = SDL_CreatePalette(4);
     SDL_SetPaletteColors(knjsub_palette, knjsub_palette_colors, 0, 4);
+
+    // Initialize glyph atlas
+    atlas_texture =
+        SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, ATLAS_SIZE, ATLAS_SIZE);
+    SDL_SetTextureScaleMode(atlas_texture, SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureBlendMode(atlas_texture, SDL_BLENDMODE_BLEND);
+    SDLMessageRenderer_ResetGlyphs();
+
+    // Every quad uses the same index pattern
+    for (int i = 0; i < BATCH_QUADS_MAX; i++) {
+        int* indices = &batch_indices[i * 6];
+        const int base = i * 4;
+
+        indices[0] = base;
+        indices[1] = base + 1;
+        indices[2] = base + 2;
+        indices[3] = base + 2;
+        indices[4] = base + 1;
+        indices[5] = base + 3;
+    }
 }
 
 void SDLMessageRenderer_BeginFrame() {
+    batch_quads = 0;
+
     // Clear canvas
     SDL_SetRenderDrawColor(_renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
     SDL_SetRenderTarget(_renderer, message_canvas);
     SDL_RenderClear(_renderer);
 }
 
-void SDLMessageRenderer_CreateTexture(int width, int height, void* pixels, int format) {
-    if (knjsub_texture != NULL) {
-        SDL_DestroyTexture(knjsub_texture);
+void SDLMessageRenderer_Flush() {
+    if (batch_quads == 0) {
+        return;
+    }
+
+    SDL_SetRenderTarget(_renderer, message_canvas);
+    SDL_RenderGeometry(_renderer, atlas_texture, batch_vertices, batch_quads * 4, batch_indices, batch_quads * 6);
+    batch_quads = 0;
+}
+
+void SDLMessageRenderer_ResetGlyphs() {
+    // Glyphs already in the batch still point at the old cells
+    SDLMessageRenderer_Flush();
+
+    for (int i = 0; i < GLYPH_TABLE_SIZE; i++) {
+        glyph_table[i].key = NO_GLYPH;
+    }
+
+    atlas_cells_used = 0;
+    current_key = NO_GLYPH;
+    current_cell = -1;
+}
+
+static GlyphEntry* find_glyph_entry(unsigned int key) {
+    unsigned int slot = (key * 0x9E3779B1) % GLYPH_TABLE_SIZE;
+
+    // The table is never more than half full, so this always finds the key or an empty slot
+    while ((glyph_table[slot].key != NO_GLYPH) && (glyph_table[slot].key != key)) {
+        slot = (slot + 1) % GLYPH_TABLE_SIZE;
+    }
+
+    return &glyph_table[slot];
+}
+
+void SDLMessageRenderer_SetGlyph(unsigned int key) {
+    current_key = key;
+    current_cell = -1;
+
+    const GlyphEntry* entry = find_glyph_entry(key);
+
+    if (entry->key == key) {
+        current_cell = entry->cell;
+        current_width = entry->width;
+        current_height = entry->height;
+    }
+}
+
+void SDLMessageRenderer_UploadGlyph(int width, int height, void* pixels) {
+    if ((current_cell >= 0) || (current_key == NO_GLYPH)) {
+        return;
+    }
+
+    if ((width > ATLAS_CELL_SIZE) || (height > ATLAS_CELL_SIZE)) {
+        SDL_Log("Glyph of size %dx%d doesn't fit an atlas cell", width, height);
+        return;
+    }
+
+    if (atlas_cells_used >= ATLAS_CELL_COUNT) {
+        const unsigned int key = current_key;
+        SDLMessageRenderer_ResetGlyphs();
+        current_key = key;
     }
 
     SDL_Surface* surface = SDL_CreateSurfaceFrom(width, height, SDL_PIXELFORMAT_INDEX4LSB, pixels, width / 2);
     SDL_SetSurfacePalette(surface, knjsub_palette);
-    knjsub_texture = SDL_CreateTextureFromSurface(_renderer, surface);
+    SDL_Surface* converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA8888);
     SDL_DestroySurface(surface);
 
-    SDL_SetTextureScaleMode(knjsub_texture, SDL_SCALEMODE_NEAREST);
-    SDL_SetTextureBlendMode(knjsub_texture, SDL_BLENDMODE_BLEND);
+    if (converted == NULL) {
+        return;
+    }
+
+    const int cell = atlas_cells_used;
+    const SDL_Rect rect = { .x = (cell % ATLAS_CELLS_PER_ROW) * ATLAS_CELL_SIZE,
+                            .y = (cell / ATLAS_CELLS_PER_ROW) * ATLAS_CELL_SIZE,
+                            .w = width,
+                            .h = height };
+    SDL_UpdateTexture(atlas_texture, &rect, converted->pixels, converted->pitch);
+    SDL_DestroySurface(converted);
+
+    GlyphEntry* entry = find_glyph_entry(current_key);
+    entry->key = current_key;
+    entry->cell = cell;
+    entry->width = width;
+    entry->height = height;
+    atlas_cells_used += 1;
+    current_cell = cell;
+    current_width = width;
+    current_height = height;
 }
 
-static int adjust_coordinate(int coordinate, bool is_x, bool is_uv) {
-    coordinate >>= 4;
+static int adjust_coordinate(int coordinate, bool is_x) {
+    const int display_size = is_x ? canvas_width : canvas_height;
+    return (coordinate >> 4) - (4096 - display_size) / 2;
+}
 
-    if (!is_uv) {
-        const int display_size = is_x ? canvas_width : canvas_height;
-        coordinate -= (4096 - display_size) / 2;
-    }
+/// @brief Convert a 12.4 texel coordinate of the current glyph to an atlas coordinate.
+/// GS coordinates may point half a texel past the glyph (knjsub's background quads use +8), which
+/// in the atlas is the neighbouring cell, so they are kept half a texel inside the glyph.
+static float adjust_uv(int coordinate, int cell_origin, int glyph_size) {
+    const float texel = SDL_clamp(coordinate / 16.0f, 0.5f, glyph_size - 0.5f);
+    return (cell_origin + texel) / ATLAS_SIZE;
+}
 
-    return coordinate;
+void SDLMessageRenderer_SetDrawEnabled(bool enabled) {
+    is_draw_enabled = enabled;
 }
 
-static Uint8 scale_color_value(Uint8 value) {
+static float scale_color_value(Uint8 value) {
     int temp = value;
     temp *= 2;
 
@@ -72,41 +209,42 @@ static Uint8 scale_color_value(Uint8 value) {
         temp = 0xFF;
     }
 
-    return (Uint8)temp;
+    return temp / 255.0f;
 }
 
 void SDLMessageRenderer_DrawTexture(int x0, int y0, int x1, int y1, int u0, int v0, int u1, int v1,
                                     unsigned int color) {
-    x0 = adjust_coordinate(x0, true, false);
-    y0 = adjust_coordinate(y0, false, false);
-    x1 = adjust_coordinate(x1, true, false);
-    y1 = adjust_coordinate(y1, false, false);
-
-    u0 = adjust_coordinate(u0, true, true);
-    v0 = adjust_coordinate(v0, false, true);
-    u1 = adjust_coordinate(u1, true, true);
-    v1 = adjust_coordinate(v1, false, true);
-
-    SDL_FRect src_rect;
-    src_rect.x = u0;
-    src_rect.y = v0;
-    src_rect.w = u1 - u0;
-    src_rect.h = v1 - v0;
-
-    SDL_FRect dst_rect;
-    dst_rect.x = x0;
-    dst_rect.y = y0;
-    dst_rect.w = x1 - x0;
-    dst_rect.h = y1 - y0;
-
-    const Uint8 r = scale_color_value(color & 0xFF);
-    const Uint8 g = scale_color_value((color >> 8) & 0xFF);
-    const Uint8 b = scale_color_value((color >> 16) & 0xFF);
-    const Uint8 a = scale_color_value(color >> 24);
-
-    SDL_SetTextureColorMod(knjsub_texture, r, g, b);
-    SDL_SetTextureAlphaMod(knjsub_texture, a);
+    if (!is_draw_enabled || (current_cell < 0)) {
+        return;
+    }
 
-    SDL_SetRenderTarget(_renderer, message_canvas);
-    SDL_RenderTexture(_renderer, knjsub_texture, &src_rect, &dst_rect);
+    if (batch_quads >= BATCH_QUADS_MAX) {
+        SDLMessageRenderer_Flush();
+    }
+
+    x0 = adjust_coordinate(x0, true);
+    y0 = adjust_coordinate(y0, false);
+    x1 = adjust_coordinate(x1, true);
+    y1 = adjust_coordinate(y1, false);
+
+    const int cell_x = (current_cell % ATLAS_CELLS_PER_ROW) * ATLAS_CELL_SIZE;
+    const int cell_y = (current_cell / ATLAS_CELLS_PER_ROW) * ATLAS_CELL_SIZE;
+    const float tu0 = adjust_uv(u0, cell_x, current_width);
+    const float tv0 = adjust_uv(v0, cell_y, current_height);
+    const float tu1 = adjust_uv(u1, cell_x, current_width);
+    const float tv1 = adjust_uv(v1, cell_y, current_height);
+
+    const SDL_FColor vertex_color = { .r = scale_color_value(color & 0xFF),
+                                      .g = scale_color_value((color >> 8) & 0xFF),
+                                      .b = scale_color_value((color >> 16) & 0xFF),
+                                      .a = scale_color_value(color >> 24) };
+
+    SDL_Vertex* vertices = &batch_vertices[batch_quads * 4];
+
+    vertices[0] = (SDL_Vertex) { .position = { x0, y0 }, .color = vertex_color, .tex_coord = { tu0, tv0 } };
+    vertices[1] = (SDL_Vertex) { .position = { x1, y0 }, .color = vertex_color, .tex_coord = { tu1, tv0 } };
+    vertices[2] = (SDL_Vertex) { .position = { x0, y1 }, .color = vertex_color, .tex_coord = { tu0, tv1 } };
+    vertices[3] = (SDL_Vertex) { .position = { x1, y1 }, .color = vertex_color, .tex_coord = { tu1, tv1 } };
+
+    batch_quads += 1;
 }
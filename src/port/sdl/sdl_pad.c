@@ -1,8 +1,27 @@
 #include "port/sdl/sdl_pad.h"
+#include "port/bench.h"
+#include "port/config.h"
 
 #include <SDL3/SDL.h>
 
+// Pad state is sampled once per frame at a fixed point, the frame's sampling deadline, which is
+// the moment SDLApp_PollEvents has pumped the OS queue. Input events carry the time they happened.
+// Handlers keep them in a ring of timestamped states, and `SDLPad_SampleFrame` applies only the
+// ones up to the deadline. Later events wait for the next frame, whatever order they are handled in.
+//
+// Gamepads are normally read only when events are pumped, once per frame, so every press would
+// be stamped with the frame it was noticed in. A sampler thread updates them at `input_poll_hz`
+// (1000 by default) instead. It sleeps between samples rather than spinning, so a sample can come
+// a fraction of a millisecond late, which is far below a frame. Keyboard events are stamped by the OS.
+//
+// The time from each press to the frame that simulates it and to the frame that presents it is
+// collected in two histograms, logged on exit.
+
 #define INPUT_SOURCES_MAX 2
+#define EVENTS_MAX 64
+#define PRESSES_MAX 32
+#define LATENCY_BIN_NS 250000 // 0.25 ms
+#define LATENCY_BINS 800
 
 typedef enum SDLPad_InputType { SDLPAD_INPUT_NONE = 0, SDLPAD_INPUT_GAMEPAD, SDLPAD_INPUT_KEYBOARD } SDLPad_InputType;
 
@@ -21,10 +40,49 @@ typedef union SDLPad_InputSource {
     SDLPad_KeyboardInputSource keyboard;
 } SDLPad_InputSource;
 
+typedef struct TimedState {
+    Uint64 timestamp;
+    SDLPad_ButtonState state;
+} TimedState;
+
+typedef struct EventRing {
+    TimedState events[EVENTS_MAX];
+    int head;
+    int count;
+} EventRing;
+
+typedef struct Press {
+    Uint64 timestamp;
+    bool is_simulated;
+} Press;
+
+typedef struct LatencyHistogram {
+    const char* name;
+    Uint64 count;
+    Uint64 total_ns;
+    Uint64 max_ns;
+    Uint32 bins[LATENCY_BINS];
+} LatencyHistogram;
+
 static SDLPad_InputSource input_sources[INPUT_SOURCES_MAX] = { 0 };
 static int connected_input_sources = 0;
+
+// State as of the last sampling deadline, which is what the game sees
 static SDLPad_ButtonState button_state[INPUT_SOURCES_MAX] = { 0 };
 
+// State after every event handled so far, and the changes since the deadline
+static SDLPad_ButtonState latest_state[INPUT_SOURCES_MAX] = { 0 };
+static EventRing event_rings[INPUT_SOURCES_MAX] = { 0 };
+
+static SDL_Thread* sampler_thread = NULL;
+static SDL_AtomicInt is_sampler_running = { 0 };
+static Uint64 sampler_period_ns = 0;
+
+static Press presses[PRESSES_MAX];
+static int press_count = 0;
+static LatencyHistogram sim_latency = { .name = "simulation" };
+static LatencyHistogram present_latency = { .name = "present" };
+
 static int input_source_index_from_joystick_id(SDL_JoystickID id) {
     for (int i = 0; i < INPUT_SOURCES_MAX; i++) {
         const SDLPad_InputSource* input_source = &input_sources[i];
@@ -75,13 +133,84 @@ static void handle_gamepad_removed_event(SDL_GamepadDeviceEvent* event) {
     SDLPad_InputSource* input_source = &input_sources[index];
     SDL_CloseGamepad(input_source->gamepad.gamepad);
     input_source->type = SDLPAD_INPUT_NONE;
+    memset(&latest_state[index], 0, sizeof(SDLPad_ButtonState));
     memset(&button_state[index], 0, sizeof(SDLPad_ButtonState));
+    event_rings[index].count = 0;
     connected_input_sources -= 1;
 }
 
+static int sampler_main(void* data) {
+    Uint64 next_sample = SDL_GetTicksNS();
+
+    SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    while (SDL_GetAtomicInt(&is_sampler_running)) {
+        // Reads the devices and queues events stamped with the current time
+        SDL_UpdateGamepads();
+
+        const Uint64 now = SDL_GetTicksNS();
+        next_sample += sampler_period_ns;
+
+        // SDL_DelayPrecise would spin through the last part of every period and keep a core busy
+        if (next_sample > now) {
+            SDL_DelayNS(next_sample - now);
+        } else {
+            next_sample = now;
+        }
+    }
+
+    return 0;
+}
+
 void SDLPad_Init() {
     input_sources[0].type = SDLPAD_INPUT_KEYBOARD;
     connected_input_sources += 1;
+
+    const int poll_hz = Config_GetInt("input_poll_hz", 1000);
+
+    // Headless runs have no pads, and the batch runner forks, which a running thread wouldn't survive
+    if ((poll_hz <= 0) || Bench_IsHeadless()) {
+        return;
+    }
+
+    sampler_period_ns = SDL_NS_PER_SECOND / poll_hz;
+    SDL_SetAtomicInt(&is_sampler_running, 1);
+    sampler_thread = SDL_CreateThread(sampler_main, "pad sampler", NULL);
+
+    if (sampler_thread == NULL) {
+        SDL_Log("Couldn't start pad sampler: %s", SDL_GetError());
+        SDL_SetAtomicInt(&is_sampler_running, 0);
+    }
+}
+
+void SDLPad_Quit() {
+    if (sampler_thread != NULL) {
+        SDL_SetAtomicInt(&is_sampler_running, 0);
+        SDL_WaitThread(sampler_thread, NULL);
+        sampler_thread = NULL;
+    }
+}
+
+static void push_state(int index, Uint64 timestamp) {
+    EventRing* ring = &event_rings[index];
+    const TimedState* newest = (ring->count > 0) ? &ring->events[(ring->head + ring->count - 1) % EVENTS_MAX] : NULL;
+    const SDLPad_ButtonState* previous = (newest != NULL) ? &newest->state : &button_state[index];
+
+    if (memcmp(previous, &latest_state[index], sizeof(SDLPad_ButtonState)) == 0) {
+        return;
+    }
+
+    if (ring->count == EVENTS_MAX) {
+        // Older than anything else in the ring, so it would be applied at the next deadline anyway
+        button_state[index] = ring->events[ring->head].state;
+        ring->head = (ring->head + 1) % EVENTS_MAX;
+        ring->count -= 1;
+    }
+
+    TimedState* event = &ring->events[(ring->head + ring->count) % EVENTS_MAX];
+    event->timestamp = timestamp;
+    event->state = latest_state[index];
+    ring->count += 1;
 }
 
 void SDLPad_HandleGamepadDeviceEvent(SDL_GamepadDeviceEvent* event) {
@@ -107,7 +236,7 @@ void SDLPad_HandleGamepadButtonEvent(SDL_GamepadButtonEvent* event) {
         return;
     }
 
-    SDLPad_ButtonState* state = &button_state[index];
+    SDLPad_ButtonState* state = &latest_state[index];
 
     switch (event->button) {
     case SDL_GAMEPAD_BUTTON_SOUTH:
@@ -166,6 +295,8 @@ void SDLPad_HandleGamepadButtonEvent(SDL_GamepadButtonEvent* event) {
         state->dpad_right = event->down;
         break;
     }
+
+    push_state(index, event->timestamp);
 }
 
 void SDLPad_HandleGamepadAxisMotionEvent(SDL_GamepadAxisEvent* event) {
@@ -175,7 +306,7 @@ void SDLPad_HandleGamepadAxisMotionEvent(SDL_GamepadAxisEvent* event) {
         return;
     }
 
-    SDLPad_ButtonState* state = &button_state[index];
+    SDLPad_ButtonState* state = &latest_state[index];
 
     switch (event->axis) {
     case SDL_GAMEPAD_AXIS_LEFT_TRIGGER:
@@ -186,10 +317,12 @@ void SDLPad_HandleGamepadAxisMotionEvent(SDL_GamepadAxisEvent* event) {
         state->right_trigger = event->value;
         break;
     }
+
+    push_state(index, event->timestamp);
 }
 
 void SDLPad_HandleKeyboardEvent(SDL_KeyboardEvent* event) {
-    SDLPad_ButtonState* state = &button_state[0];
+    SDLPad_ButtonState* state = &latest_state[0];
 
     switch (event->key) {
     case SDLK_W:
@@ -256,14 +389,129 @@ void SDLPad_HandleKeyboardEvent(SDL_KeyboardEvent* event) {
         state->start = event->down;
         break;
     }
+
+    push_state(0, event->timestamp);
 }
 
 bool SDLPad_IsGamepadConnected(int id) {
     return input_sources[id].type != SDLPAD_INPUT_NONE;
 }
 
+static Uint32 get_held_mask(const SDLPad_ButtonState* state) {
+    const bool held[] = {
+        state->south,         state->east,           state->west,           state->north,
+        state->back,          state->start,          state->left_stick,     state->right_stick,
+        state->left_shoulder, state->right_shoulder, state->dpad_up,        state->dpad_down,
+        state->dpad_left,     state->dpad_right,     state->left_trigger > 0, state->right_trigger > 0,
+    };
+    Uint32 mask = 0;
+
+    for (int i = 0; i < (int)SDL_arraysize(held); i++) {
+        mask |= held[i] << i;
+    }
+
+    return mask;
+}
+
+static void note_press(Uint64 timestamp) {
+    if (press_count == PRESSES_MAX) {
+        return;
+    }
+
+    presses[press_count].timestamp = timestamp;
+    presses[press_count].is_simulated = false;
+    press_count += 1;
+}
+
+void SDLPad_SampleFrame(Uint64 deadline) {
+    for (int i = 0; i < INPUT_SOURCES_MAX; i++) {
+        EventRing* ring = &event_rings[i];
+
+        while ((ring->count > 0) && (ring->events[ring->head].timestamp <= deadline)) {
+            const TimedState* event = &ring->events[ring->head];
+
+            if ((get_held_mask(&event->state) & ~get_held_mask(&button_state[i])) != 0) {
+                note_press(event->timestamp);
+            }
+
+            button_state[i] = event->state;
+            ring->head = (ring->head + 1) % EVENTS_MAX;
+            ring->count -= 1;
+        }
+    }
+}
+
+static void add_latency(LatencyHistogram* histogram, Uint64 timestamp, Uint64 now) {
+    const Uint64 latency = (now > timestamp) ? now - timestamp : 0;
+
+    histogram->count += 1;
+    histogram->total_ns += latency;
+    histogram->max_ns = SDL_max(histogram->max_ns, latency);
+    histogram->bins[SDL_min(latency / LATENCY_BIN_NS, LATENCY_BINS - 1)] += 1;
+}
+
 void SDLPad_GetButtonState(int id, SDLPad_ButtonState* state) {
     memcpy(state, &button_state[id], sizeof(SDLPad_ButtonState));
+
+    // The first read after the deadline is the frame that acts on the presses
+    const Uint64 now = SDL_GetTicksNS();
+
+    for (int i = 0; i < press_count; i++) {
+        if (!presses[i].is_simulated) {
+            add_latency(&sim_latency, presses[i].timestamp, now);
+            presses[i].is_simulated = true;
+        }
+    }
+}
+
+void SDLPad_NotePresented() {
+    const Uint64 now = SDL_GetTicksNS();
+    int kept = 0;
+
+    for (int i = 0; i < press_count; i++) {
+        if (presses[i].is_simulated) {
+            add_latency(&present_latency, presses[i].timestamp, now);
+        } else {
+            presses[kept] = presses[i];
+            kept += 1;
+        }
+    }
+
+    press_count = kept;
+}
+
+static double get_percentile_ms(const LatencyHistogram* histogram, int percentile) {
+    const Uint64 target = (histogram->count * percentile + 99) / 100;
+    Uint64 count = 0;
+
+    for (int i = 0; i < LATENCY_BINS; i++) {
+        count += histogram->bins[i];
+
+        if (count >= target) {
+            return (double)(i + 1) * LATENCY_BIN_NS / 1e6;
+        }
+    }
+
+    return (double)LATENCY_BINS * LATENCY_BIN_NS / 1e6;
+}
+
+static void log_latency(const LatencyHistogram* histogram) {
+    if (histogram->count == 0) {
+        return;
+    }
+
+    SDL_Log("Input latency, press to %s: %llu presses, mean %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms",
+            histogram->name,
+            (unsigned long long)histogram->count,
+            (double)histogram->total_ns / histogram->count / 1e6,
+            get_percentile_ms(histogram, 50),
+            get_percentile_ms(histogram, 99),
+            histogram->max_ns / 1e6);
+}
+
+void SDLPad_LogLatency() {
+    log_latency(&sim_latency);
+    log_latency(&present_latency);
 }
 
 void SDLPad_RumblePad(int id, bool low_freq_enabled, Uint8 high_freq_rumble) {
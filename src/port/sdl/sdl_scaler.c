@@ -0,0 +1,287 @@
+#include "port/sdl/sdl_scaler.h"
+#include "port/config.h"
+
+#include <SDL3/SDL.h>
+
+// Scales the game canvases to the window.
+//
+// Canvases are drawn straight to the backbuffer. The only intermediate target is the prescale
+// texture of the sharp bilinear mode, which is a whole multiple of the game canvas size and never
+// larger than the window.
+//
+// The old path scaled with nearest filtering into a target twice the window size and filtered that
+// down. Sharp bilinear is the mode that looks closest to it, so it's the default. Plain linear is a
+// single bilinear pass and noticeably softer.
+
+static const char* mode_names[SDL_SCALER_MODE_COUNT] = { "linear", "integer", "sharp" };
+
+static SDL_Renderer* _renderer = NULL;
+static float _display_ratio = 4.0f / 3.0f;
+static SDLScaler_Mode mode = SDL_SCALER_MODE_SHARP_BILINEAR;
+static SDL_Texture* prescale_texture = NULL;
+
+// Benchmark accounting
+static Uint64 pixels_filled = 0;
+
+static void draw_texture(SDL_Texture* texture, const SDL_FRect* dst_rect) {
+    SDL_RenderTexture(_renderer, texture, NULL, dst_rect);
+
+    if (dst_rect != NULL) {
+        pixels_filled += (Uint64)(dst_rect->w * dst_rect->h);
+    } else {
+        int w, h;
+        SDL_GetCurrentRenderOutputSize(_renderer, &w, &h);
+        pixels_filled += (Uint64)w * h;
+    }
+}
+
+static SDL_FRect get_letterbox_rect(int win_w, int win_h) {
+    float out_w = win_w;
+    float out_h = win_w / _display_ratio;
+
+    if (out_h > win_h) {
+        out_h = win_h;
+        out_w = win_h * _display_ratio;
+    }
+
+    SDL_FRect rect;
+    rect.w = out_w;
+    rect.h = out_h;
+    rect.x = (win_w - out_w) / 2;
+    rect.y = (win_h - out_h) / 2;
+
+    return rect;
+}
+
+static SDL_FRect get_integer_rect(int win_w, int win_h, const SDL_Texture* canvas) {
+    // The game has non-square pixels, so only the height can be a whole multiple.
+    // The width follows from the display ratio.
+    int scale = SDL_max(win_h / canvas->h, 1);
+
+    while ((scale > 1) && (canvas->h * scale * _display_ratio > win_w)) {
+        scale -= 1;
+    }
+
+    SDL_FRect rect;
+    rect.h = canvas->h * scale;
+    rect.w = SDL_floorf(rect.h * _display_ratio);
+    rect.x = SDL_floorf((win_w - rect.w) / 2);
+    rect.y = SDL_floorf((win_h - rect.h) / 2);
+
+    return rect;
+}
+
+static SDL_Texture* get_prescale_texture(const SDL_Texture* canvas, const SDL_FRect* dst_rect) {
+    const int scale_x = SDL_max((int)(dst_rect->w / canvas->w), 1);
+    const int scale_y = SDL_max((int)(dst_rect->h / canvas->h), 1);
+    const int width = canvas->w * scale_x;
+    const int height = canvas->h * scale_y;
+
+    if ((prescale_texture != NULL) && (prescale_texture->w == width) && (prescale_texture->h == height)) {
+        return prescale_texture;
+    }
+
+    if (prescale_texture != NULL) {
+        SDL_DestroyTexture(prescale_texture);
+    }
+
+    prescale_texture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    SDL_SetTextureScaleMode(prescale_texture, SDL_SCALEMODE_LINEAR);
+    SDL_SetTextureBlendMode(prescale_texture, SDL_BLENDMODE_NONE);
+    return prescale_texture;
+}
+
+static SDLScaler_Mode parse_mode(const char* name) {
+    for (int i = 0; i < SDL_SCALER_MODE_COUNT; i++) {
+        if (SDL_strcasecmp(name, mode_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    SDL_Log("Unknown scale mode \"%s\", using sharp", name);
+    return SDL_SCALER_MODE_SHARP_BILINEAR;
+}
+
+void SDLScaler_Init(SDL_Renderer* renderer, float display_ratio) {
+    _renderer = renderer;
+    _display_ratio = display_ratio;
+    SDLScaler_SetMode(parse_mode(Config_GetString("scale_mode", "sharp")));
+}
+
+void SDLScaler_Quit() {
+    if (prescale_texture != NULL) {
+        SDL_DestroyTexture(prescale_texture);
+        prescale_texture = NULL;
+    }
+}
+
+void SDLScaler_SetMode(SDLScaler_Mode new_mode) {
+    mode = new_mode;
+
+    if ((mode != SDL_SCALER_MODE_SHARP_BILINEAR) && (prescale_texture != NULL)) {
+        SDL_DestroyTexture(prescale_texture);
+        prescale_texture = NULL;
+    }
+}
+
+SDLScaler_Mode SDLScaler_GetMode() {
+    return mode;
+}
+
+void SDLScaler_CycleMode() {
+    SDLScaler_SetMode((mode + 1) % SDL_SCALER_MODE_COUNT);
+    SDL_Log("Scale mode: %s", mode_names[mode]);
+}
+
+void SDLScaler_Present(SDL_Texture* game_canvas, SDL_Texture* message_canvas) {
+    int win_w, win_h;
+    SDL_SetRenderTarget(_renderer, NULL);
+    SDL_GetCurrentRenderOutputSize(_renderer, &win_w, &win_h);
+
+    switch (mode) {
+    case SDL_SCALER_MODE_LINEAR: {
+        const SDL_FRect dst_rect = get_letterbox_rect(win_w, win_h);
+        SDL_SetTextureScaleMode(game_canvas, SDL_SCALEMODE_LINEAR);
+        SDL_SetTextureScaleMode(message_canvas, SDL_SCALEMODE_LINEAR);
+        draw_texture(game_canvas, &dst_rect);
+        draw_texture(message_canvas, &dst_rect);
+        break;
+    }
+
+    case SDL_SCALER_MODE_INTEGER: {
+        const SDL_FRect dst_rect = get_integer_rect(win_w, win_h, game_canvas);
+        SDL_SetTextureScaleMode(game_canvas, SDL_SCALEMODE_NEAREST);
+        SDL_SetTextureScaleMode(message_canvas, SDL_SCALEMODE_NEAREST);
+        draw_texture(game_canvas, &dst_rect);
+        draw_texture(message_canvas, &dst_rect);
+        break;
+    }
+
+    case SDL_SCALER_MODE_SHARP_BILINEAR: {
+        const SDL_FRect dst_rect = get_letterbox_rect(win_w, win_h);
+        SDL_Texture* prescaled = get_prescale_texture(game_canvas, &dst_rect);
+
+        SDL_SetRenderTarget(_renderer, prescaled);
+        SDL_SetTextureScaleMode(game_canvas, SDL_SCALEMODE_NEAREST);
+        draw_texture(game_canvas, NULL);
+        SDL_SetRenderTarget(_renderer, NULL);
+
+        // Message text is already drawn at twice the game resolution, plain bilinear is enough
+        SDL_SetTextureScaleMode(message_canvas, SDL_SCALEMODE_LINEAR);
+        draw_texture(prescaled, &dst_rect);
+        draw_texture(message_canvas, &dst_rect);
+        break;
+    }
+
+    case SDL_SCALER_MODE_COUNT:
+        break;
+    }
+}
+
+// Benchmark
+
+typedef struct BenchmarkResult {
+    const char* name;
+    Uint64 target_bytes;
+    Uint64 pixels_per_frame;
+    double ms_per_frame;
+} BenchmarkResult;
+
+// The path this module replaced: composite into a target twice the window size, then downsample.
+static Uint64 present_supersampled(SDL_Texture* screen_texture, SDL_Texture* game_canvas, SDL_Texture* message_canvas) {
+    SDL_SetRenderTarget(_renderer, screen_texture);
+    SDL_SetRenderDrawColor(_renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+    SDL_RenderClear(_renderer);
+    pixels_filled += (Uint64)screen_texture->w * screen_texture->h;
+
+    const SDL_FRect dst_rect = get_letterbox_rect(screen_texture->w, screen_texture->h);
+    SDL_SetTextureScaleMode(game_canvas, SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureScaleMode(message_canvas, SDL_SCALEMODE_NEAREST);
+    draw_texture(game_canvas, &dst_rect);
+    draw_texture(message_canvas, &dst_rect);
+
+    SDL_SetRenderTarget(_renderer, NULL);
+    draw_texture(screen_texture, NULL);
+
+    return (Uint64)screen_texture->w * screen_texture->h * 4;
+}
+
+static void finish_gpu_work() {
+    // Reading a pixel back waits for everything queued before it
+    const SDL_Rect rect = { 0, 0, 1, 1 };
+    SDL_DestroySurface(SDL_RenderReadPixels(_renderer, &rect));
+}
+
+static BenchmarkResult run_benchmark_pass(int pass, SDL_Texture* game_canvas, SDL_Texture* message_canvas, int frames) {
+    BenchmarkResult result = { 0 };
+    SDL_Texture* screen_texture = NULL;
+    int win_w, win_h;
+
+    SDL_SetRenderTarget(_renderer, NULL);
+    SDL_GetCurrentRenderOutputSize(_renderer, &win_w, &win_h);
+
+    if (pass == SDL_SCALER_MODE_COUNT) {
+        result.name = "supersampled 2x";
+        screen_texture =
+            SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_ARGB32, SDL_TEXTUREACCESS_TARGET, win_w * 2, win_h * 2);
+        SDL_SetTextureScaleMode(screen_texture, SDL_SCALEMODE_LINEAR);
+    } else {
+        result.name = mode_names[pass];
+        SDLScaler_SetMode(pass);
+    }
+
+    finish_gpu_work();
+    pixels_filled = 0;
+    const Uint64 start = SDL_GetTicksNS();
+
+    for (int i = 0; i < frames; i++) {
+        SDL_SetRenderDrawColor(_renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+        SDL_RenderClear(_renderer);
+        pixels_filled += (Uint64)win_w * win_h;
+
+        if (screen_texture != NULL) {
+            result.target_bytes = present_supersampled(screen_texture, game_canvas, message_canvas);
+        } else {
+            SDLScaler_Present(game_canvas, message_canvas);
+        }
+
+        SDL_RenderPresent(_renderer);
+    }
+
+    finish_gpu_work();
+    const Uint64 elapsed = SDL_GetTicksNS() - start;
+
+    if (screen_texture != NULL) {
+        SDL_DestroyTexture(screen_texture);
+    } else if (prescale_texture != NULL) {
+        result.target_bytes = (Uint64)prescale_texture->w * prescale_texture->h * 4;
+    }
+
+    result.pixels_per_frame = pixels_filled / frames;
+    result.ms_per_frame = elapsed / 1e6 / frames;
+    return result;
+}
+
+void SDLScaler_RunBenchmark(SDL_Texture* game_canvas, SDL_Texture* message_canvas, int frames) {
+    const SDLScaler_Mode saved_mode = mode;
+    int win_w, win_h;
+
+    if (frames <= 0) {
+        return;
+    }
+
+    SDL_GetCurrentRenderOutputSize(_renderer, &win_w, &win_h);
+    SDL_Log("Scaler benchmark: %d frames at %dx%d", frames, win_w, win_h);
+
+    for (int pass = 0; pass <= SDL_SCALER_MODE_COUNT; pass++) {
+        const BenchmarkResult result = run_benchmark_pass(pass, game_canvas, message_canvas, frames);
+
+        SDL_Log("  %-16s %8.2f MB targets, %6.2f Mpx filled/frame, %7.3f ms/frame",
+                result.name,
+                result.target_bytes / (1024.0 * 1024.0),
+                result.pixels_per_frame / 1e6,
+                result.ms_per_frame);
+    }
+
+    SDLScaler_SetMode(saved_mode);
+}
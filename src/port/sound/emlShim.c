@@ -2,6 +2,7 @@
 
 #include "common.h"
 #include "port/sound/list.h"
+#include "port/sound/mixer.h"
 #include "port/sound/spu.h"
 #include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/emlSndDrv.h"
 #include <stdio.h>
@@ -54,8 +55,6 @@ struct VWork {
     struct list_head list;
 };
 
-static short masterVolume;
-static short assignedBankVolume[16];
 static short bankVolume[16];
 
 static struct VWork vpool[48];
@@ -201,10 +200,8 @@ void emlShimInit() {
 
     SDL_LockMutex(soundLock);
 
-    masterVolume = 0x3fff;
     for (int i = 0; i < 16; i++) {
         bankVolume[i] = 0x3fff;
-        assignedBankVolume[i] = 0x3fff;
     }
 
     for (int i = 0; i < 48; i++) {
@@ -486,13 +483,10 @@ void emlShimSysSetVolume(CSE_SYS_PARAM_BANKVOL* param) {
     SDL_LockMutex(soundLock);
 
     if (param->bank == 0xff) {
-        masterVolume = param->vol ? (param->vol * 0x3fff) / 0x7f : 0;
+        // Master volume is applied by the mixer on the whole SE bus
+        Mixer_SetBusGain(MIXER_BUS_SE, (float)param->vol / 0x7f);
     } else {
-        assignedBankVolume[param->bank] = param->vol ? (param->vol * 0x3fff) / 0x7f : 0;
-    }
-
-    for (int i = 0; i < 16; i++) {
-        bankVolume[i] = (masterVolume * assignedBankVolume[i]) / 0x3fff;
+        bankVolume[param->bank] = param->vol ? (param->vol * 0x3fff) / 0x7f : 0;
     }
 
     SDL_UnlockMutex(soundLock);
@@ -0,0 +1,153 @@
+#include "port/sound/mixer.h"
+#include "port/config.h"
+#include "port/sound/spu.h"
+
+#include <SDL3/SDL.h>
+
+#define FRAME_SIZE (MIXER_CHANNELS * sizeof(s16))
+#define BATCH_FRAMES 1024
+#define DEFAULT_BUFFER_FRAMES 512
+#define GAIN_UNITY 0x8000
+
+#define clamp(val, min, max) (((val) > (max)) ? (max) : (((val) < (min)) ? (min) : (val)))
+
+// Gain and pause are set on the main thread and read by the audio callback, hence atomics.
+// The gain is kept in Q15, the format the mixer works in.
+typedef struct Bus {
+    SDL_AudioStream* stream;
+    SDL_AtomicInt gain_q15;
+    SDL_AtomicInt paused;
+} Bus;
+
+static SDL_AudioStream* device_stream = NULL;
+static Bus buses[MIXER_BUS_COUNT] = { 0 };
+static SDL_AtomicU32 played_samples;
+
+static void mix_bus(const s16* src, int frames, s32 gain_q15, s32* acc) {
+    for (int i = 0; i < frames * MIXER_CHANNELS; i++) {
+        acc[i] += (src[i] * gain_q15) >> 15;
+    }
+}
+
+static void mixer_callback(void* user, SDL_AudioStream* stream, int additional_amount, int total_amount) {
+    static s16 bus_buf[BATCH_FRAMES * MIXER_CHANNELS];
+    static s32 acc[BATCH_FRAMES * MIXER_CHANNELS];
+    static s16 out_buf[BATCH_FRAMES * MIXER_CHANNELS];
+    int frames_left = additional_amount / FRAME_SIZE;
+
+    SDL_SetAtomicU32(&played_samples, SDL_GetAtomicU32(&played_samples) + frames_left);
+
+    while (frames_left > 0) {
+        const int frames = SDL_min(frames_left, BATCH_FRAMES);
+        SDL_memset(acc, 0, frames * FRAME_SIZE * 2);
+
+        // SE voices. The SPU has to run even while the bus is paused, its timer drives the sound driver.
+        SPU_Render(bus_buf, frames);
+
+        if (!SDL_GetAtomicInt(&buses[MIXER_BUS_SE].paused)) {
+            mix_bus(bus_buf, frames, SDL_GetAtomicInt(&buses[MIXER_BUS_SE].gain_q15), acc);
+        }
+
+        // Streamed buses
+        for (int i = 0; i < MIXER_BUS_COUNT; i++) {
+            Bus* bus = &buses[i];
+
+            if ((bus->stream == NULL) || SDL_GetAtomicInt(&bus->paused)) {
+                continue;
+            }
+
+            const int bytes = SDL_GetAudioStreamData(bus->stream, bus_buf, frames * FRAME_SIZE);
+
+            if (bytes > 0) {
+                mix_bus(bus_buf, bytes / FRAME_SIZE, SDL_GetAtomicInt(&bus->gain_q15), acc);
+            }
+        }
+
+        for (int i = 0; i < frames * MIXER_CHANNELS; i++) {
+            out_buf[i] = clamp(acc[i], INT16_MIN, INT16_MAX);
+        }
+
+        SDL_PutAudioStreamData(stream, out_buf, frames * FRAME_SIZE);
+        frames_left -= frames;
+    }
+}
+
+void Mixer_Init() {
+    if (device_stream != NULL) {
+        return;
+    }
+
+    const SDL_AudioSpec spec = { .format = SDL_AUDIO_S16, .channels = MIXER_CHANNELS, .freq = MIXER_SAMPLE_RATE };
+
+    for (int i = 0; i < MIXER_BUS_COUNT; i++) {
+        SDL_SetAtomicInt(&buses[i].gain_q15, GAIN_UNITY);
+        SDL_SetAtomicInt(&buses[i].paused, false);
+    }
+
+    buses[MIXER_BUS_BGM].stream = SDL_CreateAudioStream(&spec, &spec);
+
+    // Device buffer size in sample frames. Smaller is lower latency, but too small will crackle.
+    const int buffer_frames = SDL_max(Config_GetInt("audio_buffer_frames", DEFAULT_BUFFER_FRAMES), 64);
+    char buffer_frames_str[16];
+    SDL_snprintf(buffer_frames_str, sizeof(buffer_frames_str), "%d", buffer_frames);
+    SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, buffer_frames_str);
+
+    device_stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, mixer_callback, NULL);
+
+    if (device_stream == NULL) {
+        SDL_Log("Couldn't create SDL audio stream: %s", SDL_GetError());
+        return;
+    }
+
+    SDL_ResumeAudioStreamDevice(device_stream);
+}
+
+void Mixer_Exit() {
+    SDL_DestroyAudioStream(device_stream);
+    device_stream = NULL;
+
+    for (int i = 0; i < MIXER_BUS_COUNT; i++) {
+        if (buses[i].stream != NULL) {
+            SDL_DestroyAudioStream(buses[i].stream);
+            buses[i].stream = NULL;
+        }
+    }
+}
+
+SDL_AudioStream* Mixer_GetBusStream(MixerBus bus) {
+    return buses[bus].stream;
+}
+
+void Mixer_SetBusGain(MixerBus bus, float gain) {
+    SDL_SetAtomicInt(&buses[bus].gain_q15, gain * GAIN_UNITY);
+}
+
+void Mixer_SetBusPaused(MixerBus bus, bool paused) {
+    SDL_SetAtomicInt(&buses[bus].paused, paused);
+}
+
+bool Mixer_IsBusPaused(MixerBus bus) {
+    return SDL_GetAtomicInt(&buses[bus].paused);
+}
+
+u32 Mixer_GetPlayedSamples() {
+    return SDL_GetAtomicU32(&played_samples);
+}
+
+void Mixer_SetRateRatio(float ratio) {
+    if (device_stream != NULL) {
+        SDL_SetAudioStreamFrequencyRatio(device_stream, ratio);
+    }
+}
+
+void Mixer_PauseDevice(bool paused) {
+    if (device_stream == NULL) {
+        return;
+    }
+
+    if (paused) {
+        SDL_PauseAudioStreamDevice(device_stream);
+    } else {
+        SDL_ResumeAudioStreamDevice(device_stream);
+    }
+}
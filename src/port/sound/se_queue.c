@@ -0,0 +1,195 @@
+#include "port/sound/se_queue.h"
+#include "port/config.h"
+#include "port/sound/spu.h"
+#include "port/state_hash.h"
+#include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/emlTSB.h"
+
+#include <SDL3/SDL.h>
+
+// Sound effect request queue.
+//
+// A multi-hit super can trigger the same effect several times in one frame, and each request used
+// to run the whole TSB program (key on, echo setup, pan and volume) on the spot, taking the sound
+// lock for every voice it started. Requests are now queued and the queue is run once per tick
+// from `cseExecServer`, before the echo work of that tick, with the sound lock held throughout.
+// Requests still run in the order they were made, so with coalescing off the result is the same.
+//
+// Coalescing policies:
+//
+//     off        every request runs (default)
+//     identical  a request equal to one already queued (bank, code and all arguments) is dropped
+//     position   same, but only bank, code and pan are compared
+//
+// The trace has one line per queued request, `<frame> <bank> <code> <times> <args...>`, where
+// `times` counts the requests merged into it, and a summary line per tick.
+
+#define QUEUE_SIZE 64
+#define RTPC_COUNT 10
+#define RTPC_PAN 6
+
+typedef enum CoalescePolicy {
+    COALESCE_OFF,
+    COALESCE_IDENTICAL,
+    COALESCE_POSITION,
+} CoalescePolicy;
+
+typedef struct SERequest {
+    u16 bank;
+    u16 code;
+    s32 rtpc[RTPC_COUNT];
+    int times;
+} SERequest;
+
+static SERequest queue[QUEUE_SIZE];
+static int queue_count = 0;
+static int merged_count = 0;
+
+static bool is_configured = false;
+static CoalescePolicy policy = COALESCE_OFF;
+static SDL_IOStream* trace_io = NULL;
+static Uint32 trace_first = 0;
+static Uint32 trace_last = 0;
+
+static CoalescePolicy parse_policy(const char* name) {
+    if (SDL_strcmp(name, "identical") == 0) {
+        return COALESCE_IDENTICAL;
+    } else if (SDL_strcmp(name, "position") == 0) {
+        return COALESCE_POSITION;
+    } else if (SDL_strcmp(name, "off") != 0) {
+        SDL_Log("Unknown se_coalesce policy %s, using off", name);
+    }
+
+    return COALESCE_OFF;
+}
+
+static void open_trace() {
+    char* path = Config_GetPath("se_trace");
+
+    if (path == NULL) {
+        return;
+    }
+
+    trace_io = SDL_IOFromFile(path, "w");
+
+    if (trace_io == NULL) {
+        SDL_Log("Couldn't open SE trace %s: %s", path, SDL_GetError());
+        SDL_free(path);
+        return;
+    }
+
+    trace_first = Config_GetInt("se_trace_first", 0);
+    trace_last = Config_GetInt("se_trace_last", SDL_MAX_SINT32);
+    SDL_IOprintf(trace_io, "# frame bank code times args\n");
+    SDL_Log("Tracing sound effects of frames %u-%u to %s", trace_first, trace_last, path);
+    SDL_free(path);
+}
+
+static void configure() {
+    policy = parse_policy(Config_GetString("se_coalesce", "off"));
+    open_trace();
+    is_configured = true;
+}
+
+static bool can_merge(const SERequest* queued, u16 bank, u16 code, const s32* rtpc) {
+    if ((queued->bank != bank) || (queued->code != code)) {
+        return false;
+    }
+
+    switch (policy) {
+    case COALESCE_IDENTICAL:
+        return SDL_memcmp(queued->rtpc, rtpc, sizeof(queued->rtpc)) == 0;
+
+    case COALESCE_POSITION:
+        return queued->rtpc[RTPC_PAN] == rtpc[RTPC_PAN];
+
+    case COALESCE_OFF:
+    default:
+        return false;
+    }
+}
+
+void SEQueue_Push(u16 bank, u16 code, const s32* rtpc) {
+    if (!is_configured) {
+        configure();
+    }
+
+    for (int i = 0; i < queue_count; i++) {
+        if (can_merge(&queue[i], bank, code, rtpc)) {
+            queue[i].times += 1;
+            merged_count += 1;
+            return;
+        }
+    }
+
+    if (queue_count == QUEUE_SIZE) {
+        SEQueue_Flush();
+    }
+
+    SERequest* request = &queue[queue_count];
+    request->bank = bank;
+    request->code = code;
+    SDL_memcpy(request->rtpc, rtpc, sizeof(request->rtpc));
+    request->times = 1;
+    queue_count += 1;
+}
+
+static void trace(Uint32 frame, Uint64 elapsed_ns) {
+    for (int i = 0; i < queue_count; i++) {
+        const SERequest* request = &queue[i];
+
+        SDL_IOprintf(trace_io, "%u %u %u %d", frame, request->bank, request->code, request->times);
+
+        for (int j = 0; j < RTPC_COUNT; j++) {
+            SDL_IOprintf(trace_io, " %d", request->rtpc[j]);
+        }
+
+        SDL_IOprintf(trace_io, "\n");
+    }
+
+    SDL_IOprintf(trace_io,
+                 "# frame %u: %d run, %d merged, %" SDL_PRIu64 " us\n",
+                 frame,
+                 queue_count,
+                 merged_count,
+                 elapsed_ns / SDL_NS_PER_US);
+}
+
+void SEQueue_Flush() {
+    if (queue_count == 0) {
+        return;
+    }
+
+    const Uint64 start = SDL_GetTicksNS();
+    SDL_LockMutex(soundLock);
+
+    for (int i = 0; i < queue_count; i++) {
+        mlTsbRequest(queue[i].bank, queue[i].code, queue[i].rtpc);
+    }
+
+    SDL_UnlockMutex(soundLock);
+
+    if (trace_io != NULL) {
+        const Uint32 frame = StateHash_GetFrame();
+
+        if ((frame >= trace_first) && (frame <= trace_last)) {
+            trace(frame, SDL_GetTicksNS() - start);
+        } else if (frame > trace_last) {
+            SEQueue_Quit();
+        }
+    }
+
+    queue_count = 0;
+    merged_count = 0;
+}
+
+void SEQueue_Clear() {
+    queue_count = 0;
+    merged_count = 0;
+}
+
+void SEQueue_Quit() {
+    if (trace_io != NULL) {
+        SDL_CloseIO(trace_io);
+        trace_io = NULL;
+    }
+}
@@ -55,18 +55,41 @@ struct SPU_Voice {
 
     s16 decodeBuf[0x40];
     u32 decRPos, decWPos, decLeft;
+
+    struct SPU_Sample* cached;
+    u32 pos, decoded;
+};
+
+// PCM of one sample, decoded from its start address up to where it stops or starts to repeat
+struct SPU_Sample {
+    u32 first_block, last_block; // SPU RAM blocks the decoder read
+    u32 length;                  // Samples before playback stops or jumps to `loop_pos`
+    u32 loop_pos;                // SAMPLE_NO_LOOP for one-shot samples
+    u32 refs;                    // Voices playing it
+    bool is_stale;               // RAM under it was overwritten, free when no voice uses it
+    s16 pcm[];                   // `length` samples plus the taps interpolation reads past the end
 };
 
 SDL_Mutex* soundLock;
 
 static void (*timer_cb)();
-static SDL_AudioStream* stream;
 static struct SPU_Voice voices[VOICE_COUNT];
 static u16 ram[(2 * 1024 * 1024) >> 1];
 static s16 adpcm_coefs[5][2] = {
     { 0, 0 }, { 60, 0 }, { 115, -52 }, { 98, -55 }, { 122, -60 },
 };
 
+#define RAM_BLOCK_COUNT (sizeof(ram) / 16)
+#define BLOCK_SAMPLES 28
+#define INTERP_TAPS 4
+#define SAMPLE_NO_LOOP UINT32_MAX
+#define SAMPLE_LOOP_PASSES_MAX 8
+
+// Indexed by start block. Start addresses that can't be cached point at `undecodable`, which
+// covers all of RAM so that any upload gives them another try.
+static struct SPU_Sample* samples[RAM_BLOCK_COUNT];
+static struct SPU_Sample undecodable = { .first_block = 0, .last_block = RAM_BLOCK_COUNT - 1 };
+
 static s16 SPU_ApplyVolume(s16 sample, s32 volume) {
     return (sample * volume) >> 15;
 }
@@ -156,40 +179,46 @@ static void SPU_VoiceRunADSR(struct SPU_Voice* v) {
     }
 }
 
-static void SPU_VoiceDecode(struct SPU_Voice* v) {
-    u32 data;
-    u16 header, filter, shift;
-
-    if (v->decLeft >= 16) {
-        return;
-    }
-
-    data = ram[v->nax];
-    header = ram[v->nax & ~0x7];
-    shift = header & 0xf;
-    filter = (header >> 4) & 7;
+static void SPU_DecodeWord(u32 data, u16 header, s16* hist, s16* out) {
+    u16 shift = header & 0xf;
+    u16 filter = (header >> 4) & 7;
 
     for (int i = 0; i < 4; i++) {
         s32 sample = (s16)((data & 0xF) << 12);
         sample >>= shift;
 
         // TODO do the right thing for invalid shift/filter values
-        sample += (adpcm_coefs[filter][0] * v->decodeHist[0]) >> 6;
-        sample += (adpcm_coefs[filter][1] * v->decodeHist[1]) >> 6;
+        sample += (adpcm_coefs[filter][0] * hist[0]) >> 6;
+        sample += (adpcm_coefs[filter][1] * hist[1]) >> 6;
 
         // We do get overflow here otherwise, should we?
         sample = clamp(sample, INT16_MIN, INT16_MAX);
 
-        v->decodeHist[1] = v->decodeHist[0];
-        v->decodeHist[0] = (s16)sample;
+        hist[1] = hist[0];
+        hist[0] = (s16)sample;
+        out[i] = sample;
 
-        v->decodeBuf[v->decWPos] = sample;
-        v->decodeBuf[v->decWPos | 0x20] = sample;
+        data >>= 4;
+    }
+}
+
+static void SPU_VoiceDecode(struct SPU_Voice* v) {
+    u16 header;
+    s16 decoded[4];
+
+    if (v->decLeft >= 16) {
+        return;
+    }
+
+    header = ram[v->nax & ~0x7];
+    SPU_DecodeWord(ram[v->nax], header, v->decodeHist, decoded);
+
+    for (int i = 0; i < 4; i++) {
+        v->decodeBuf[v->decWPos] = decoded[i];
+        v->decodeBuf[v->decWPos | 0x20] = decoded[i];
 
         v->decWPos = (v->decWPos + 1) & 0x1f;
         v->decLeft++;
-
-        data >>= 4;
     }
 
     v->nax = (v->nax + 1) & 0xfffff;
@@ -217,19 +246,53 @@ static void SPU_VoiceDecode(struct SPU_Voice* v) {
     }
 }
 
+// Counterpart of SPU_VoiceDecode for voices playing a cached sample. Only the decoder's position
+// is tracked, so that the voice stops on the same tick as it would when decoding as it goes.
+static void SPU_VoiceStepCached(struct SPU_Voice* v) {
+    const struct SPU_Sample* s = v->cached;
+
+    if (v->decLeft >= 16) {
+        return;
+    }
+
+    v->decLeft += 4;
+    v->decoded += 4;
+
+    if (v->decoded < s->length) {
+        return;
+    }
+
+    v->endx = true;
+
+    if (s->loop_pos != SAMPLE_NO_LOOP) {
+        v->decoded = s->loop_pos;
+    } else if (!v->noise) {
+        v->envx = 0;
+        v->adsr_phase = ADSR_PHASE_STOPPED;
+        v->run = false;
+    }
+}
+
 static void SPU_VoiceTick(struct SPU_Voice* v, s32* output) {
     s32 sample, pitchStep, decInc;
     u32 index;
-
-    SPU_VoiceDecode(v);
+    const s16* window;
+
+    if (v->cached != NULL) {
+        SPU_VoiceStepCached(v);
+        window = &v->cached->pcm[v->pos];
+    } else {
+        SPU_VoiceDecode(v);
+        window = &v->decodeBuf[v->decRPos];
+    }
 
     index = (v->counter & 0x0ff0) >> 4;
 
     sample = 0;
-    sample += ((v->decodeBuf[v->decRPos + 0] * interp_table[index][0]) >> 15);
-    sample += ((v->decodeBuf[v->decRPos + 1] * interp_table[index][1]) >> 15);
-    sample += ((v->decodeBuf[v->decRPos + 2] * interp_table[index][2]) >> 15);
-    sample += ((v->decodeBuf[v->decRPos + 3] * interp_table[index][3]) >> 15);
+    sample += ((window[0] * interp_table[index][0]) >> 15);
+    sample += ((window[1] * interp_table[index][1]) >> 15);
+    sample += ((window[2] * interp_table[index][2]) >> 15);
+    sample += ((window[3] * interp_table[index][3]) >> 15);
 
     pitchStep = v->pitch;
     // TODO pitch mod?
@@ -238,9 +301,18 @@ static void SPU_VoiceTick(struct SPU_Voice* v, s32* output) {
 
     decInc = v->counter >> 12;
     v->counter &= 0xfff;
-    v->decRPos = (v->decRPos + decInc) & 0x1f;
     v->decLeft -= decInc;
 
+    if (v->cached != NULL) {
+        v->pos += decInc;
+
+        if ((v->pos >= v->cached->length) && (v->cached->loop_pos != SAMPLE_NO_LOOP)) {
+            v->pos -= v->cached->length - v->cached->loop_pos;
+        }
+    } else {
+        v->decRPos = (v->decRPos + decInc) & 0x1f;
+    }
+
     sample = SPU_ApplyVolume(sample, v->envx);
     output[0] = SPU_ApplyVolume(sample, v->voll);
     output[1] = SPU_ApplyVolume(sample, v->volr);
@@ -248,6 +320,199 @@ static void SPU_VoiceTick(struct SPU_Voice* v, s32* output) {
     SPU_VoiceRunADSR(v);
 }
 
+// Sample cache
+//
+// Decoding ADPCM as voices play means a sample triggered sixty times a match is decoded sixty
+// times, and the audio callback pays for it with every voice busy. Instead each sample is decoded
+// to PCM once, from its start address through to where the decoder stops or jumps back to a
+// state it has been in before, and voices interpolate straight from the PCM. Banks are decoded
+// when they are uploaded; start addresses that weren't found in a bank are decoded on first key
+// on. Uploads drop the entries whose blocks they overwrite, and a voice still playing a dropped
+// entry keeps it alive until the voice is started again.
+
+static struct SPU_Sample* SPU_SampleFinish(struct SPU_Sample* s, u32 length, u32 loop_pos) {
+    struct SPU_Sample* shrunk;
+
+    s->length = length;
+    s->loop_pos = loop_pos;
+    s->refs = 0;
+    s->is_stale = false;
+
+    for (int i = 0; i < INTERP_TAPS - 1; i++) {
+        s->pcm[length + i] = (loop_pos != SAMPLE_NO_LOOP) ? s->pcm[loop_pos + i] : 0;
+    }
+
+    shrunk = SDL_realloc(s, sizeof(*s) + (length + INTERP_TAPS - 1) * sizeof(s16));
+    return (shrunk != NULL) ? shrunk : s;
+}
+
+// Runs the same block walk as SPU_VoiceDecode, from the state a voice has right after key on.
+// A loop is followed until it comes back to its start with a decoder history it has seen before,
+// so that every pass after the cached ones would decode to the same samples.
+static struct SPU_Sample* SPU_SampleDecode(u32 ssa) {
+    struct {
+        u32 block;
+        s16 hist[2];
+        u32 pos;
+    } jumps[SAMPLE_LOOP_PASSES_MAX];
+    int jump_count = 0;
+    u32 capacity = BLOCK_SAMPLES * 64;
+    u32 length = 0;
+    u32 block = ssa >> 3;
+    u32 lsa = block;
+    s16 hist[2] = { 0, 0 };
+    struct SPU_Sample* s = SDL_malloc(sizeof(*s) + capacity * sizeof(s16));
+
+    if (s == NULL) {
+        return NULL;
+    }
+
+    s->first_block = block;
+    s->last_block = block;
+
+    for (u32 visited = 0; visited < RAM_BLOCK_COUNT; visited++) {
+        const u16* data = &ram[block << 3];
+        const u16 header = data[0];
+
+        if (length + BLOCK_SAMPLES + INTERP_TAPS > capacity) {
+            struct SPU_Sample* grown;
+
+            capacity *= 2;
+            grown = SDL_realloc(s, sizeof(*s) + capacity * sizeof(s16));
+
+            if (grown == NULL) {
+                break;
+            }
+
+            s = grown;
+        }
+
+        for (int i = 1; i < 8; i++) {
+            SPU_DecodeWord(data[i], header, hist, &s->pcm[length]);
+            length += 4;
+        }
+
+        s->first_block = min(s->first_block, block);
+        s->last_block = max(s->last_block, block);
+
+        if ((header & 0x100) == 0) {
+            block = (block + 1) % RAM_BLOCK_COUNT;
+        } else if ((header & 0x200) == 0) {
+            return SPU_SampleFinish(s, length, SAMPLE_NO_LOOP);
+        } else {
+            for (int i = 0; i < jump_count; i++) {
+                if ((jumps[i].block == lsa) && (jumps[i].hist[0] == hist[0]) && (jumps[i].hist[1] == hist[1])) {
+                    return SPU_SampleFinish(s, length, jumps[i].pos);
+                }
+            }
+
+            if (jump_count == SAMPLE_LOOP_PASSES_MAX) {
+                break;
+            }
+
+            jumps[jump_count].block = lsa;
+            jumps[jump_count].hist[0] = hist[0];
+            jumps[jump_count].hist[1] = hist[1];
+            jumps[jump_count].pos = length;
+            jump_count++;
+            block = lsa;
+        }
+
+        if (ram[block << 3] & 0x400) {
+            lsa = block;
+        }
+    }
+
+    SDL_free(s);
+    return NULL;
+}
+
+static struct SPU_Sample* SPU_SampleAcquire(u32 ssa) {
+    struct SPU_Sample** slot;
+
+    if ((ssa & 0x7) != 0) {
+        return NULL;
+    }
+
+    slot = &samples[ssa >> 3];
+
+    if (*slot == NULL) {
+        *slot = SPU_SampleDecode(ssa);
+
+        if (*slot == NULL) {
+            *slot = &undecodable;
+        }
+    }
+
+    if (*slot == &undecodable) {
+        return NULL;
+    }
+
+    (*slot)->refs++;
+    return *slot;
+}
+
+static void SPU_SampleRelease(struct SPU_Sample* s) {
+    if (s == NULL) {
+        return;
+    }
+
+    s->refs--;
+
+    if ((s->refs == 0) && s->is_stale) {
+        SDL_free(s);
+    }
+}
+
+static void SPU_SampleInvalidate(u32 first_block, u32 end_block) {
+    for (u32 i = 0; i < RAM_BLOCK_COUNT; i++) {
+        struct SPU_Sample* s = samples[i];
+
+        if ((s == NULL) || (s->last_block < first_block) || (s->first_block >= end_block)) {
+            continue;
+        }
+
+        samples[i] = NULL;
+
+        if (s == &undecodable) {
+            continue;
+        }
+
+        if (s->refs > 0) {
+            s->is_stale = true;
+        } else {
+            SDL_free(s);
+        }
+    }
+}
+
+// Samples in a bank follow each other, so one starts at the bank and after every end block
+static void SPU_SamplePrefetch(u32 first_block, u32 end_block) {
+    bool is_start = true;
+
+    for (u32 block = first_block; block < end_block; block++) {
+        const u16 header = ram[block << 3];
+
+        if (is_start) {
+            struct SPU_Sample* s = SPU_SampleDecode(block << 3);
+
+            if (s != NULL) {
+                SDL_LockMutex(soundLock);
+
+                if (samples[block] == NULL) {
+                    samples[block] = s;
+                    s = NULL;
+                }
+
+                SDL_UnlockMutex(soundLock);
+                SDL_free(s);
+            }
+        }
+
+        is_start = (header & 0x100) != 0;
+    }
+}
+
 int SPU_VoiceGetEnvLvl(int vnum) {
     return voices[vnum].envx;
 }
@@ -295,6 +560,19 @@ void SPU_VoiceStart(int vnum, u32 start_addr) {
     v->run = true;
     v->envx = 0;
 
+    // Key on restarts the decoder, as on the SPU2. Cached samples are decoded from this state.
+    v->decodeHist[0] = 0;
+    v->decodeHist[1] = 0;
+    v->counter = 0;
+    v->decRPos = 0;
+    v->decWPos = 0;
+    v->decLeft = 0;
+
+    SPU_SampleRelease(v->cached);
+    v->cached = SPU_SampleAcquire(start_addr);
+    v->pos = 0;
+    v->decoded = 0;
+
     v->adsr_counter = 0;
     v->adsr_phase = ADSR_PHASE_ATTACK;
     SPU_VoiceCacheADSR(v);
@@ -307,34 +585,29 @@ void SPU_VoiceStart(int vnum, u32 start_addr) {
     v->nax = (v->nax + 1) & 0xfffff;
 }
 
-void SPU_SDL_CB(void* user, SDL_AudioStream* stream, int additional_amount, int total_amount) {
-    u32 samples_per_channel = (additional_amount / sizeof(s16)) >> 1;
-    static s16 outbuf[4096] = {};
-
+void SPU_Render(s16* output, int frames) {
     // We need to run the eml callbaack at 250hz
     // 48000 / 250 = 192
     static int cb_timer = 192;
 
+    if (timer_cb == NULL) {
+        SDL_memset(output, 0, frames * 2 * sizeof(s16));
+        return;
+    }
+
     // TODO consider redesigning this whole system, emlshim and spu should probably run
     // on the same thread, no locks would be needed in the SDL audio callback path
     SDL_LockMutex(soundLock);
 
-    while (samples_per_channel) {
-        u32 batch_count = min(samples_per_channel, 4096);
-        s16* p = outbuf;
-        for (int i = 0; i < batch_count; i++) {
-            SPU_Tick(p);
-            p += 2;
-
-            cb_timer--;
-            if (!cb_timer) {
-                timer_cb();
-                cb_timer = 192;
-            }
-        }
+    for (int i = 0; i < frames; i++) {
+        SPU_Tick(output);
+        output += 2;
 
-        SDL_PutAudioStreamData(stream, outbuf, (batch_count * sizeof(s16)) << 1);
-        samples_per_channel -= batch_count;
+        cb_timer--;
+        if (!cb_timer) {
+            timer_cb();
+            cb_timer = 192;
+        }
     }
 
     SDL_UnlockMutex(soundLock);
@@ -343,34 +616,28 @@ void SPU_SDL_CB(void* user, SDL_AudioStream* stream, int additional_amount, int
 static void nullcb() {}
 
 void SPU_Init(void (*cb)()) {
-    SDL_AudioSpec spec;
+    memset(voices, 0, sizeof(voices));
+    soundLock = SDL_CreateMutex();
 
     timer_cb = cb;
     if (!cb) {
         timer_cb = nullcb;
     }
-
-    memset(voices, 0, sizeof(voices));
-    soundLock = SDL_CreateMutex();
-
-    spec.channels = 2;
-    spec.format = SDL_AUDIO_S16;
-    spec.freq = 48000;
-
-    stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, SPU_SDL_CB, NULL);
-    if (!stream) {
-        SDL_Log("Couldn't create SDL audio stream: %s", SDL_GetError());
-    }
-
-    SDL_ResumeAudioStreamDevice(stream);
 }
 
 void SPU_Upload(u32 dst, void* src, u32 size) {
+    u32 first_block = dst >> 4;
+    u32 end_block = min((dst + size + 15) >> 4, RAM_BLOCK_COUNT);
+
     SDL_LockMutex(soundLock);
 
     memcpy(&ram[dst >> 1], src, size);
+    SPU_SampleInvalidate(first_block, end_block);
 
     SDL_UnlockMutex(soundLock);
+
+    // Only this thread writes RAM, so the audio thread can keep mixing while the bank is decoded
+    SPU_SamplePrefetch(first_block, end_block);
 }
 
 void SPU_Tick(s16* output) {
@@ -0,0 +1,96 @@
+#include "port/startup.h"
+
+#include <SDL3/SDL.h>
+
+// Startup.
+//
+// game_init is mostly a sequence of writes to game globals and has to stay in its original order
+// on the main thread. What it can hand off is disk time: the AFS files it and the first frame load
+// are read ahead on a thread (see afs.c), which logs its own line once the first frame is done,
+// with how long the main thread waited for it.
+//
+// Each part of game_init is timed as a phase, with the bytes the main thread read from disk and
+// decoded during it. The report is logged once game_init is done.
+
+#define PHASES_MAX 16
+
+typedef struct Timing {
+    const char* name;
+    Uint64 start;
+    Uint64 end;
+    Uint64 bytes_read;
+    Uint64 bytes_decoded;
+} Timing;
+
+static Uint64 bytes_read = 0;
+static Uint64 bytes_decoded = 0;
+
+static Timing phases[PHASES_MAX] = { 0 };
+static int phase_count = 0;
+static Uint64 start_time = 0;
+
+static void begin_timing(Timing* timing, const char* name) {
+    timing->name = name;
+    timing->start = SDL_GetTicksNS();
+    timing->bytes_read = bytes_read;
+    timing->bytes_decoded = bytes_decoded;
+}
+
+static void end_timing(Timing* timing) {
+    timing->end = SDL_GetTicksNS();
+    timing->bytes_read = bytes_read - timing->bytes_read;
+    timing->bytes_decoded = bytes_decoded - timing->bytes_decoded;
+}
+
+void Startup_Begin() {
+    start_time = SDL_GetTicksNS();
+}
+
+// Phases
+
+void Startup_BeginPhase(const char* name) {
+    if (phase_count > 0) {
+        end_timing(&phases[phase_count - 1]);
+    }
+
+    if (phase_count < PHASES_MAX) {
+        begin_timing(&phases[phase_count], name);
+        phase_count += 1;
+    }
+}
+
+void Startup_CountRead(size_t size) {
+    bytes_read += size;
+}
+
+void Startup_CountDecoded(size_t size) {
+    bytes_decoded += size;
+}
+
+// Report
+
+static void log_timing(const Timing* timing) {
+    SDL_Log("  %-16s %8.1f %8.1f %10.1f %10.1f",
+            timing->name,
+            (double)(timing->start - start_time) / SDL_NS_PER_MS,
+            (double)(timing->end - timing->start) / SDL_NS_PER_MS,
+            (double)timing->bytes_read / 1024,
+            (double)timing->bytes_decoded / 1024);
+}
+
+void Startup_Finish() {
+    if (phase_count > 0) {
+        end_timing(&phases[phase_count - 1]);
+    }
+
+    const Uint64 end_time = SDL_GetTicksNS();
+
+    SDL_Log("Startup: game_init took %.1f ms (began %.1f ms after SDL init)",
+            (double)(end_time - start_time) / SDL_NS_PER_MS,
+            (double)start_time / SDL_NS_PER_MS);
+    SDL_Log("  %-16s %8s %8s %10s %10s", "part", "start ms", "ms", "read KB", "decoded KB");
+
+    for (int i = 0; i < phase_count; i++) {
+        log_timing(&phases[i]);
+    }
+}
@@ -0,0 +1,364 @@
+#include "port/state_hash.h"
+#include "common.h"
+#include "port/config.h"
+#include "port/netplay/game_state.h"
+#include "sf33rd/Source/Game/EFFECT.h"
+#include "sf33rd/Source/Game/HITCHECK.h"
+#include "sf33rd/Source/Game/PLCNT.h"
+#include "sf33rd/Source/Game/WORK_SYS.h"
+#include "sf33rd/Source/Game/bg.h"
+#include "sf33rd/Source/Game/cmd_data.h"
+#include "sf33rd/Source/Game/count.h"
+#include "sf33rd/Source/Game/spgauge.h"
+#include "sf33rd/Source/Game/workuser.h"
+#include "structs.h"
+
+#include <SDL3/SDL.h>
+
+#include <stddef.h>
+
+// Hash of the simulation state, for finding the first frame where two runs with the same inputs
+// stop agreeing.
+//
+// Each region is copied into a scratch buffer with its pointer fields zeroed, then hashed with
+// xxHash64 (four independent lanes over 32 byte stripes). Pointers are left out because they
+// differ between processes even when the game state is the same. Effect slots are only hashed
+// while they are in use, and only their common WORK_Other part: the effect specific tail is a
+// union that can hold pointers.
+//
+// The globals region hashes every snapshot region that holds no pointers (see game_state.c), so
+// state that the named regions miss still shows up as a divergence. The work region covers the
+// pointer free fields of the other structs the game logic reads back.
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+#define FIELD(type, field) { offsetof(type, field), sizeof(((type*)0)->field) }
+
+typedef struct Field {
+    size_t offset;
+    size_t size;
+} Field;
+
+static const Field work_pointers[] = {
+    FIELD(WORK, target_adrs),     FIELD(WORK, hit_adrs),         FIELD(WORK, dmg_adrs),
+    FIELD(WORK, suzi_offset),     FIELD(WORK, char_table),       FIELD(WORK, se_random_table),
+    FIELD(WORK, step_xy_table),   FIELD(WORK, move_xy_table),    FIELD(WORK, overlap_char_tbl),
+    FIELD(WORK, olc_ix_table),    FIELD(WORK, rival_catch_tbl),  FIELD(WORK, curr_rca),
+    FIELD(WORK, set_char_ad),     FIELD(WORK, hit_ix_table),     FIELD(WORK, body_adrs),
+    FIELD(WORK, h_bod),           FIELD(WORK, hand_adrs),        FIELD(WORK, h_han),
+    FIELD(WORK, dumm_adrs),       FIELD(WORK, h_dumm),           FIELD(WORK, catch_adrs),
+    FIELD(WORK, h_cat),           FIELD(WORK, caught_adrs),      FIELD(WORK, h_cau),
+    FIELD(WORK, attack_adrs),     FIELD(WORK, h_att),            FIELD(WORK, h_eat),
+    FIELD(WORK, hosei_adrs),      FIELD(WORK, h_hos),            FIELD(WORK, att_ix_table),
+    FIELD(WORK, my_effadrs),
+};
+
+static const Field plw_pointers[] = {
+    FIELD(PLW, cp), FIELD(PLW, dm_step_tbl),   FIELD(PLW, as), FIELD(PLW, sa),
+    FIELD(PLW, cb), FIELD(PLW, illusion_work), FIELD(PLW, py), FIELD(PLW, rp),
+};
+
+static const Field effect_pointers[] = { FIELD(WORK_Other, my_master) };
+
+static const Field hs_pointers[] = { FIELD(HS, ah), FIELD(HS, dh) };
+
+static const Field bgw_pointers[] = {
+    FIELD(BGW, bg_address), FIELD(BGW, suzi_adrs), FIELD(BGW, start_suzi), FIELD(BGW, suzi_adrs2),
+    FIELD(BGW, start_suzi2), FIELD(BGW, deff_rl),  FIELD(BGW, deff_plus),  FIELD(BGW, deff_minus),
+};
+
+static const Field task_pointers[] = { FIELD(struct _TASK, func_adrs), FIELD(struct _TASK, callback_adrs) };
+
+static const Field spg_pointers[] = { FIELD(SPG_DAT, spgtbl_ptr), FIELD(SPG_DAT, spgptbl_ptr) };
+
+static const Field rw_pointers[] = { FIELD(RW_DATA, rwd_ptr), FIELD(RW_DATA, brw_ptr) };
+
+static const Field waza_pointers[] = { FIELD(WAZA_WORK, w_ptr) };
+
+static const char* region_names[STATE_HASH_REGION_COUNT] = { "players", "effects", "random", "hit",
+                                                             "timers",  "bg",      "globals", "work" };
+
+static Uint8 scratch[EFFECT_MAX * (sizeof(WORK_Other) + sizeof(s16))];
+static size_t scratch_size = 0;
+static SDL_IOStream* log_io = NULL;
+static Uint32 frame = 0;
+
+// xxHash64
+
+static Uint64 read64(const Uint8* p) {
+    Uint64 value;
+    SDL_memcpy(&value, p, sizeof(value));
+    return SDL_Swap64LE(value);
+}
+
+static Uint32 read32(const Uint8* p) {
+    Uint32 value;
+    SDL_memcpy(&value, p, sizeof(value));
+    return SDL_Swap32LE(value);
+}
+
+static Uint64 rotl64(Uint64 x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static Uint64 xxh_round(Uint64 acc, Uint64 input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static Uint64 xxh_merge_round(Uint64 acc, Uint64 val) {
+    acc ^= xxh_round(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+static Uint64 xxh64(const Uint8* data, size_t len, Uint64 seed) {
+    const Uint8* p = data;
+    const Uint8* const end = data + len;
+    Uint64 h;
+
+    if (len >= 32) {
+        Uint64 v1 = seed + PRIME64_1 + PRIME64_2;
+        Uint64 v2 = seed + PRIME64_2;
+        Uint64 v3 = seed;
+        Uint64 v4 = seed - PRIME64_1;
+
+        do {
+            v1 = xxh_round(v1, read64(p));
+            v2 = xxh_round(v2, read64(p + 8));
+            v3 = xxh_round(v3, read64(p + 16));
+            v4 = xxh_round(v4, read64(p + 24));
+            p += 32;
+        } while (p + 32 <= end);
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh_merge_round(h, v1);
+        h = xxh_merge_round(h, v2);
+        h = xxh_merge_round(h, v3);
+        h = xxh_merge_round(h, v4);
+    } else {
+        h = seed + PRIME64_5;
+    }
+
+    h += (Uint64)len;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh_round(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+    }
+
+    if (p + 4 <= end) {
+        h ^= (Uint64)read32(p) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+
+    for (; p < end; p++) {
+        h ^= (*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// Scratch buffer
+
+static Uint8* append(const void* data, size_t size) {
+    Uint8* dst = &scratch[scratch_size];
+
+    SDL_assert(scratch_size + size <= sizeof(scratch));
+    SDL_memcpy(dst, data, size);
+    scratch_size += size;
+    return dst;
+}
+
+static void clear_fields(Uint8* base, const Field* fields, int count) {
+    for (int i = 0; i < count; i++) {
+        SDL_memset(base + fields[i].offset, 0, fields[i].size);
+    }
+}
+
+static Uint64 hash_scratch() {
+    const Uint64 hash = xxh64(scratch, scratch_size, 0);
+    scratch_size = 0;
+    return hash;
+}
+
+// Regions
+
+static Uint64 hash_players() {
+    for (int i = 0; i < SDL_arraysize(plw); i++) {
+        Uint8* copy = append(&plw[i], sizeof(PLW));
+        clear_fields(copy, work_pointers, SDL_arraysize(work_pointers));
+        clear_fields(copy, plw_pointers, SDL_arraysize(plw_pointers));
+    }
+
+    return hash_scratch();
+}
+
+static Uint64 hash_effects() {
+    for (s16 i = 0; i < EFFECT_MAX; i++) {
+        const WORK_Other* effect = (const WORK_Other*)frw[i];
+
+        if (effect->wu.be_flag == 0) {
+            continue;
+        }
+
+        append(&i, sizeof(i));
+        Uint8* copy = append(effect, sizeof(WORK_Other));
+        clear_fields(copy, work_pointers, SDL_arraysize(work_pointers));
+        clear_fields(copy, effect_pointers, SDL_arraysize(effect_pointers));
+    }
+
+    return hash_scratch();
+}
+
+static Uint64 hash_random() {
+    const s16 values[] = { Random_ix16,     Random_ix32,        Random_ix16_ex,     Random_ix32_ex,
+                           Random_ix16_com, Random_ix32_com,    Random_ix16_ex_com, Random_ix32_ex_com,
+                           Random_ix16_bg };
+
+    append(values, sizeof(values));
+    return hash_scratch();
+}
+
+static Uint64 hash_hit() {
+    for (int i = 0; i < SDL_arraysize(hs); i++) {
+        Uint8* copy = append(&hs[i], sizeof(HS));
+        clear_fields(copy, hs_pointers, SDL_arraysize(hs_pointers));
+    }
+
+    return hash_scratch();
+}
+
+static Uint64 hash_timers() {
+    append(&Game_timer, sizeof(Game_timer));
+    append(&players_timer, sizeof(players_timer));
+    append(&Timer_Freeze, sizeof(Timer_Freeze));
+    append(&Interrupt_Timer, sizeof(Interrupt_Timer));
+    append(&round_timer, sizeof(round_timer));
+    return hash_scratch();
+}
+
+static Uint64 hash_bg() {
+    Uint8* copy = append(&bg_w, sizeof(BG));
+
+    for (int i = 0; i < SDL_arraysize(bg_w.bgw); i++) {
+        clear_fields(copy + offsetof(BG, bgw) + i * sizeof(BGW), bgw_pointers, SDL_arraysize(bgw_pointers));
+    }
+
+    return hash_scratch();
+}
+
+static Uint64 hash_globals() {
+    return GameState_HashPlain();
+}
+
+static void append_array(const void* data, size_t count, size_t stride, const Field* fields, int field_count) {
+    const Uint8* src = data;
+
+    for (size_t i = 0; i < count; i++) {
+        Uint8* copy = append(src + i * stride, stride);
+        clear_fields(copy, fields, field_count);
+    }
+}
+
+static Uint64 hash_work() {
+    append_array(task, SDL_arraysize(task), sizeof(struct _TASK), task_pointers, SDL_arraysize(task_pointers));
+    append_array(spg_dat, SDL_arraysize(spg_dat), sizeof(SPG_DAT), spg_pointers, SDL_arraysize(spg_pointers));
+    append_array(rw_dat, SDL_arraysize(rw_dat), sizeof(RW_DATA), rw_pointers, SDL_arraysize(rw_pointers));
+    append_array(waza_work, sizeof(waza_work) / sizeof(WAZA_WORK), sizeof(WAZA_WORK), waza_pointers,
+                 SDL_arraysize(waza_pointers));
+    return hash_scratch();
+}
+
+// API
+
+void StateHash_Init() {
+    char* path = Config_GetPath("state_hash_log");
+
+    if (path == NULL) {
+        return;
+    }
+
+    log_io = SDL_IOFromFile(path, "w");
+
+    if (log_io == NULL) {
+        SDL_Log("Couldn't open state hash log %s: %s", path, SDL_GetError());
+    } else {
+        SDL_Log("Logging state hashes to %s", path);
+    }
+
+    SDL_free(path);
+}
+
+void StateHash_Quit() {
+    if (log_io != NULL) {
+        SDL_CloseIO(log_io);
+        log_io = NULL;
+    }
+}
+
+void StateHash_Compute(StateHash* hash) {
+    hash->regions[STATE_HASH_PLAYERS] = hash_players();
+    hash->regions[STATE_HASH_EFFECTS] = hash_effects();
+    hash->regions[STATE_HASH_RANDOM] = hash_random();
+    hash->regions[STATE_HASH_HIT] = hash_hit();
+    hash->regions[STATE_HASH_TIMERS] = hash_timers();
+    hash->regions[STATE_HASH_BG] = hash_bg();
+    hash->regions[STATE_HASH_GLOBALS] = hash_globals();
+    hash->regions[STATE_HASH_WORK] = hash_work();
+    hash->total = xxh64((const Uint8*)hash->regions, sizeof(hash->regions), 0);
+}
+
+Uint64 StateHash_Chain(Uint64 chain, const StateHash* hash) {
+    return xxh64((const Uint8*)&hash->total, sizeof(hash->total), chain);
+}
+
+void StateHash_EndFrame() {
+    StateHash hash;
+
+    if (log_io != NULL) {
+        StateHash_Compute(&hash);
+        SDL_IOprintf(log_io, "%u %016" SDL_PRIx64, frame, hash.total);
+
+        for (int i = 0; i < STATE_HASH_REGION_COUNT; i++) {
+            SDL_IOprintf(log_io, " %s=%016" SDL_PRIx64, region_names[i], hash.regions[i]);
+        }
+
+        SDL_IOprintf(log_io, "\n");
+    }
+
+    frame += 1;
+}
+
+Uint32 StateHash_GetFrame() {
+    return frame;
+}
+
+int StateHash_FindDivergence(const StateHash* a, const StateHash* b) {
+    for (int i = 0; i < STATE_HASH_REGION_COUNT; i++) {
+        if (a->regions[i] != b->regions[i]) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+const char* StateHash_GetRegionName(StateHashRegion region) {
+    return region_names[region];
+}
+
+Uint64 StateHash_HashBytes(const void* data, size_t size, Uint64 seed) {
+    return xxh64(data, size, seed);
+}
@@ -0,0 +1,524 @@
+// mmap needs a newer POSIX level than the rest of the port
+#undef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "port/texture_cache.h"
+#include "port/afs.h"
+#include "port/batch.h"
+#include "port/config.h"
+#include "port/resources.h"
+#include "port/state_hash.h"
+
+#include <SDL3/SDL.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Decoded texture cache.
+//
+// Texture, palette and sprite data in the AFS is LZ77 or zlib compressed, and every load
+// decompresses it and converts it into the layout flCreateTextureHandle takes. The result only
+// depends on the compressed bytes, so it's kept in `texture_cache.bin` in the resources folder,
+// keyed by a hash of those bytes and the parameters of the decode:
+//
+//     header   "3SXT", version, hash of the AFS table of contents     (16 bytes)
+//     entry    key (8 bytes), size (4 bytes), checksum (4 bytes)        (16 bytes)
+//              data, padded to 16 bytes
+//
+// The file is mapped on first use and hits point straight into the mapping, so textures are
+// created from it without decoding or copying. Misses are decoded as before and appended; they
+// are found from the next run on.
+//
+// Several instances can share the file. Opening and every append hold an exclusive lock on
+// `texture_cache.lock` next to it, and appends always go to the current end of the file, so
+// entries of different processes never overlap. A file of another version or made from another
+// archive is replaced by a new one written next to it and renamed over it, so a process that has
+// the old one mapped keeps reading intact data. A torn entry at the end, left by a process that
+// died while appending, is cut off on open. Each entry carries a checksum of its data that is
+// checked on every hit, and an entry that fails it is treated as a miss.
+//
+// The batch runner's workers are forked and share the lock's open file description, so the lock
+// doesn't keep them apart. The cache is read-only while the batch runner runs.
+
+#define CACHE_MAGIC "3SXT"
+#define CACHE_VERSION 2
+#define CACHE_ALIGNMENT 16
+#define CACHE_SIZE_MAX_MB 512
+
+typedef struct CacheHeader {
+    char magic[4];
+    Uint32 version;
+    Uint64 afs_hash;
+} CacheHeader;
+
+typedef struct EntryHeader {
+    Uint64 key;
+    Uint32 size;
+    Uint32 checksum;
+} EntryHeader;
+
+// A slot of size 0 failed its checksum
+typedef struct Slot {
+    Uint64 key;
+    Uint64 offset;
+    Uint32 size;
+    Uint32 checksum;
+} Slot;
+
+typedef enum CacheState {
+    CACHE_UNINITIALIZED,
+    CACHE_ENABLED,
+    CACHE_DISABLED,
+} CacheState;
+
+static CacheState state = CACHE_UNINITIALIZED;
+
+// Contents of the file as it was when the run started
+static const Uint8* contents = NULL;
+static size_t contents_size = 0;
+static bool is_mapped = false;
+
+static SDL_IOStream* append_io = NULL;
+static Uint64 size_limit = 0;
+
+#if defined(_WIN32)
+static HANDLE lock_handle = INVALID_HANDLE_VALUE;
+#else
+static int lock_fd = -1;
+#endif
+
+// Open addressing, key 0 marks a free slot
+static Slot* slots = NULL;
+static size_t slot_capacity = 0;
+static size_t slot_count = 0;
+
+static Uint32 hits = 0;
+static Uint32 misses = 0;
+static Uint64 stored_bytes = 0;
+
+static Uint64 align(Uint64 size) {
+    return (size + CACHE_ALIGNMENT - 1) & ~(Uint64)(CACHE_ALIGNMENT - 1);
+}
+
+// Index
+
+static Slot* find_slot(Uint64 key) {
+    if (slot_capacity == 0) {
+        return NULL;
+    }
+
+    size_t i = key & (slot_capacity - 1);
+
+    while (slots[i].key != 0) {
+        if (slots[i].key == key) {
+            return &slots[i];
+        }
+
+        i = (i + 1) & (slot_capacity - 1);
+    }
+
+    return NULL;
+}
+
+static void insert_slot(Uint64 key, Uint64 offset, Uint32 size, Uint32 checksum);
+
+static void grow_slots() {
+    Slot* old_slots = slots;
+    const size_t old_capacity = slot_capacity;
+
+    slot_capacity = (slot_capacity == 0) ? 1024 : slot_capacity * 2;
+    slots = SDL_calloc(slot_capacity, sizeof(Slot));
+    slot_count = 0;
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].key != 0) {
+            insert_slot(old_slots[i].key, old_slots[i].offset, old_slots[i].size, old_slots[i].checksum);
+        }
+    }
+
+    SDL_free(old_slots);
+}
+
+static void insert_slot(Uint64 key, Uint64 offset, Uint32 size, Uint32 checksum) {
+    if ((slot_count + 1) * 2 > slot_capacity) {
+        grow_slots();
+    }
+
+    size_t i = key & (slot_capacity - 1);
+
+    while ((slots[i].key != 0) && (slots[i].key != key)) {
+        i = (i + 1) & (slot_capacity - 1);
+    }
+
+    if (slots[i].key == 0) {
+        slot_count += 1;
+    }
+
+    slots[i].key = key;
+    slots[i].offset = offset;
+    slots[i].size = size;
+    slots[i].checksum = checksum;
+}
+
+static void clear_slots() {
+    SDL_free(slots);
+    slots = NULL;
+    slot_capacity = 0;
+    slot_count = 0;
+}
+
+static Uint32 compute_checksum(Uint64 key, const void* data, size_t size) {
+    return (Uint32)StateHash_HashBytes(data, size, key);
+}
+
+// Lock
+
+static bool open_lock(const char* path) {
+#if defined(_WIN32)
+    WCHAR* wide_path = (WCHAR*)SDL_iconv_string("UTF-16LE", "UTF-8", path, SDL_strlen(path) + 1);
+
+    if (wide_path != NULL) {
+        lock_handle = CreateFileW(wide_path,
+                                  GENERIC_READ | GENERIC_WRITE,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                  NULL,
+                                  OPEN_ALWAYS,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  NULL);
+        SDL_free(wide_path);
+    }
+
+    return lock_handle != INVALID_HANDLE_VALUE;
+#else
+    lock_fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    return lock_fd >= 0;
+#endif
+}
+
+static void close_lock() {
+#if defined(_WIN32)
+    if (lock_handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(lock_handle);
+        lock_handle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (lock_fd >= 0) {
+        close(lock_fd);
+        lock_fd = -1;
+    }
+#endif
+}
+
+/// @brief Take or release the exclusive lock. Blocks while another process holds it.
+static void set_locked(bool locked) {
+#if defined(_WIN32)
+    OVERLAPPED overlapped = { 0 };
+
+    if (locked) {
+        LockFileEx(lock_handle, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped);
+    } else {
+        UnlockFileEx(lock_handle, 0, 1, 0, &overlapped);
+    }
+#else
+    while ((flock(lock_fd, locked ? LOCK_EX : LOCK_UN) != 0) && (errno == EINTR)) {
+        // Interrupted by a signal, try again
+    }
+#endif
+}
+
+// File
+
+static void load_contents(const char* path) {
+#if defined(_WIN32)
+    contents = SDL_LoadFile(path, &contents_size);
+#else
+    const int fd = open(path, O_RDONLY);
+    struct stat info;
+
+    if (fd < 0) {
+        return;
+    }
+
+    if ((fstat(fd, &info) == 0) && (info.st_size > 0)) {
+        void* address = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+        if (address != MAP_FAILED) {
+            contents = address;
+            contents_size = info.st_size;
+            is_mapped = true;
+        }
+    }
+
+    close(fd);
+#endif
+}
+
+static void unload_contents() {
+#if !defined(_WIN32)
+    if (is_mapped) {
+        munmap((void*)contents, contents_size);
+    }
+#else
+    SDL_free((void*)contents);
+#endif
+
+    contents = NULL;
+    contents_size = 0;
+    is_mapped = false;
+}
+
+/// @return Offset after the last complete entry, or 0 if the file can't be used.
+static Uint64 index_contents(Uint64 afs_hash) {
+    CacheHeader header;
+
+    if (contents_size < sizeof(header)) {
+        return 0;
+    }
+
+    SDL_memcpy(&header, contents, sizeof(header));
+
+    if ((SDL_memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0) || (header.version != CACHE_VERSION) ||
+        (header.afs_hash != afs_hash)) {
+        return 0;
+    }
+
+    Uint64 offset = sizeof(header);
+
+    while (offset + sizeof(EntryHeader) <= contents_size) {
+        EntryHeader entry;
+        SDL_memcpy(&entry, contents + offset, sizeof(entry));
+        const Uint64 end = offset + sizeof(entry) + align(entry.size);
+
+        if ((entry.key == 0) || (end > contents_size)) {
+            break;
+        }
+
+        insert_slot(entry.key, offset + sizeof(entry), entry.size, entry.checksum);
+        offset = end;
+    }
+
+    return offset;
+}
+
+/// @brief Write a new file with only the header next to `path` and rename it over `path`.
+static bool create_file(const char* path, Uint64 afs_hash) {
+    char* temp_path = NULL;
+    SDL_asprintf(&temp_path, "%s.tmp", path);
+    SDL_IOStream* io = SDL_IOFromFile(temp_path, "wb");
+
+    if (io == NULL) {
+        SDL_Log("Couldn't create texture cache %s: %s", temp_path, SDL_GetError());
+        SDL_free(temp_path);
+        return false;
+    }
+
+    CacheHeader header = { .magic = CACHE_MAGIC, .version = CACHE_VERSION, .afs_hash = afs_hash };
+    bool is_created = SDL_WriteIO(io, &header, sizeof(header)) == sizeof(header);
+    is_created = SDL_CloseIO(io) && is_created;
+    is_created = is_created && SDL_RenamePath(temp_path, path);
+
+    if (!is_created) {
+        SDL_Log("Couldn't create texture cache %s: %s", path, SDL_GetError());
+        SDL_RemovePath(temp_path);
+    }
+
+    SDL_free(temp_path);
+    return is_created;
+}
+
+/// @brief Cut off a torn entry that a process left at the end of the file when it died.
+static bool truncate_file(const char* path, Uint64 size) {
+#if defined(_WIN32)
+    WCHAR* wide_path = (WCHAR*)SDL_iconv_string("UTF-16LE", "UTF-8", path, SDL_strlen(path) + 1);
+    HANDLE file = INVALID_HANDLE_VALUE;
+    LARGE_INTEGER position = { .QuadPart = (LONGLONG)size };
+    bool is_truncated = false;
+
+    if (wide_path != NULL) {
+        file = CreateFileW(wide_path,
+                           GENERIC_WRITE,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           NULL,
+                           OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL,
+                           NULL);
+        SDL_free(wide_path);
+    }
+
+    if (file != INVALID_HANDLE_VALUE) {
+        is_truncated = SetFilePointerEx(file, position, NULL, FILE_BEGIN) && SetEndOfFile(file);
+        CloseHandle(file);
+    }
+
+    return is_truncated;
+#else
+    return truncate(path, (off_t)size) == 0;
+#endif
+}
+
+static void open_cache() {
+    const Uint64 afs_hash = AFS_GetIndexHash();
+
+    // Without the table of contents there is no telling whether the file is from this archive
+    if (!Config_GetBool("texture_cache", true) || (afs_hash == 0)) {
+        state = CACHE_DISABLED;
+        return;
+    }
+
+    char* path = Resources_GetPath("texture_cache.bin");
+    char* lock_path = Resources_GetPath("texture_cache.lock");
+
+    // Without the lock another instance could write at the same time, so don't write at all
+    bool can_write = !Batch_IsRunning() && open_lock(lock_path);
+
+    if (can_write) {
+        set_locked(true);
+    }
+
+    load_contents(path);
+    Uint64 file_end = index_contents(afs_hash);
+
+    if (file_end == 0) {
+        unload_contents();
+        clear_slots();
+
+        if (can_write && create_file(path, afs_hash)) {
+            file_end = sizeof(CacheHeader);
+        }
+    } else if (can_write && (file_end < contents_size)) {
+        SDL_Log("Texture cache %s has a torn entry at the end, cutting it off", path);
+        can_write = truncate_file(path, file_end);
+    }
+
+    if (can_write && (file_end > 0)) {
+        append_io = SDL_IOFromFile(path, "r+b");
+    }
+
+    if (can_write) {
+        set_locked(false);
+    }
+
+    if (append_io == NULL) {
+        close_lock();
+    }
+
+    size_limit = (Uint64)Config_GetInt("texture_cache_max_mb", CACHE_SIZE_MAX_MB) * 1024 * 1024;
+    SDL_Log("Texture cache %s: %zu entries, %.1f MB", path, slot_count, (double)contents_size / (1024 * 1024));
+    SDL_free(path);
+    SDL_free(lock_path);
+    state = CACHE_ENABLED;
+}
+
+static bool is_enabled() {
+    TextureCache_Open();
+    return state == CACHE_ENABLED;
+}
+
+// API
+
+void TextureCache_Open() {
+    if (state == CACHE_UNINITIALIZED) {
+        open_cache();
+    }
+}
+
+uint64_t TextureCache_MakeKey(const void* src, size_t src_size, size_t dst_size, uint32_t variant) {
+    const Uint64 key = StateHash_HashBytes(src, src_size, ((Uint64)variant << 32) | (Uint32)dst_size);
+
+    // 0 marks free slots
+    return (key != 0) ? key : 1;
+}
+
+const void* TextureCache_Find(uint64_t key, size_t size) {
+    if (!is_enabled()) {
+        return NULL;
+    }
+
+    Slot* slot = find_slot(key);
+
+    // Entries added during this run are past the end of what's mapped
+    if ((slot == NULL) || (slot->size != size) || (slot->offset + size > contents_size)) {
+        misses += 1;
+        return NULL;
+    }
+
+    if (compute_checksum(key, contents + slot->offset, size) != slot->checksum) {
+        SDL_Log("Texture cache entry %016" SDL_PRIx64 " is corrupt, decoding it again", key);
+        slot->size = 0;
+        misses += 1;
+        return NULL;
+    }
+
+    hits += 1;
+    return contents + slot->offset;
+}
+
+void TextureCache_Store(uint64_t key, const void* data, size_t size) {
+    static const Uint8 padding[CACHE_ALIGNMENT] = { 0 };
+
+    if (!is_enabled() || (append_io == NULL)) {
+        return;
+    }
+
+    const Slot* slot = find_slot(key);
+
+    if ((slot != NULL) && (slot->size != 0)) {
+        return;
+    }
+
+    const EntryHeader entry = { .key = key, .size = (Uint32)size, .checksum = compute_checksum(key, data, size) };
+    const Uint64 entry_size = sizeof(EntryHeader) + align(size);
+    const size_t padding_size = align(size) - size;
+
+    // Other instances append too, so the end of the file is only known while holding the lock
+    set_locked(true);
+    const Sint64 offset = SDL_SeekIO(append_io, 0, SDL_IO_SEEK_END);
+
+    if ((offset < 0) || ((Uint64)offset + entry_size > size_limit)) {
+        set_locked(false);
+        return;
+    }
+
+    const bool is_written = (SDL_WriteIO(append_io, &entry, sizeof(entry)) == sizeof(entry)) &&
+                            (SDL_WriteIO(append_io, data, size) == size) &&
+                            (SDL_WriteIO(append_io, padding, padding_size) == padding_size) && SDL_FlushIO(append_io);
+    set_locked(false);
+
+    if (!is_written) {
+        SDL_Log("Couldn't write texture cache: %s", SDL_GetError());
+        SDL_CloseIO(append_io);
+        append_io = NULL;
+        return;
+    }
+
+    insert_slot(key, offset + sizeof(entry), (Uint32)size, entry.checksum);
+    stored_bytes += size;
+}
+
+void TextureCache_Quit() {
+    if (state == CACHE_ENABLED) {
+        SDL_Log("Texture cache: %u hits, %u misses, %.1f MB added",
+                hits,
+                misses,
+                (double)stored_bytes / (1024 * 1024));
+    }
+
+    if (append_io != NULL) {
+        SDL_CloseIO(append_io);
+        append_io = NULL;
+    }
+
+    close_lock();
+    unload_contents();
+    clear_slots();
+    state = CACHE_UNINITIALIZED;
+}
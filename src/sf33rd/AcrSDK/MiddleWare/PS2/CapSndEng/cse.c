@@ -1,5 +1,6 @@
 #include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/cse.h"
 #include "common.h"
+#include "port/sound/se_queue.h"
 #include "port/sound/spu.h"
 #include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/eflSifRpc.h"
 #include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/emlMemMap.h"
@@ -29,6 +30,7 @@ s32 cseInitSndDrv() {
 
 s32 cseExecServer() {
     if (cseSysWork.InitializeFlag == 1) {
+        SEQueue_Flush();
         mlTsbExecServer();
         cseSysWork.Counter++;
         return 0;
@@ -59,7 +61,8 @@ s32 cseTsbRequest(u16 bank, u16 code, s32 NumArgSets, ...) {
         }
     }
 
-    return mlTsbRequest(bank, code, rtpc);
+    SEQueue_Push(bank, code, rtpc);
+    return 0;
 }
 
 s32 cseSendBd2SpuWithId(void* ee_addr, u32 size, u32 bank, u32 id) {
@@ -67,6 +70,9 @@ s32 cseSendBd2SpuWithId(void* ee_addr, u32 size, u32 bank, u32 id) {
     bank &= 0xF;
 
     if (cseSysWork.SpuBankId[bank] != id) {
+        // Queued requests still refer to the bank that is about to be replaced
+        SEQueue_Flush();
+
         cseSysWork.SpuBankId[bank] = id;
         param.cmd = 0x30000000;
         param.e_addr = (uintptr_t)ee_addr;
@@ -92,15 +98,18 @@ s32 cseTsbSetBankAddr(u32 bank, SoundEvent* addr) {
 }
 
 s32 cseSeStopAll() {
+    SEQueue_Clear();
     mlTsbStopAll();
     mlSeStopAll();
     return 0;
 }
 
 s32 cseSysSetMasterVolume(s32 vol) {
+    SEQueue_Flush();
     return mlSysSetMasterVolume(vol);
 }
 
 s32 cseSysSetMono(u32 mono_sw) {
+    SEQueue_Flush();
     return mlSysSetMono(mono_sw);
 }
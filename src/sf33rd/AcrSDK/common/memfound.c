@@ -8,6 +8,9 @@ MEM_BLOCK sysmemblock[4096];
 // sbss
 MEM_MGR sysmemmgr;
 
+// Largest mflTemporaryUse request, for the footprint profile
+s32 mflTemporaryUseMax;
+
 void mflInit(void* mem_ptr, s32 memsize, s32 memalign) {
     plmemInit(&sysmemmgr, sysmemblock, 0x1000, mem_ptr, memsize, memalign, 1);
 }
@@ -29,6 +32,10 @@ u32 mflRegister(s32 len) {
 }
 
 void* mflTemporaryUse(s32 len) {
+    if (len > mflTemporaryUseMax) {
+        mflTemporaryUseMax = len;
+    }
+
     return plmemTemporaryUse(&sysmemmgr, len);
 }
 
@@ -43,3 +50,7 @@ s32 mflRelease(u32 handle) {
 void* mflCompact() {
     return plmemCompact(&sysmemmgr);
 }
+
+u32 mflCompactStep() {
+    return plmemCompactStep(&sysmemmgr);
+}
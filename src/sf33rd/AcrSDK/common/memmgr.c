@@ -273,6 +273,65 @@ void* plmemCompact(MEM_MGR* memmgr) {
     return memmgr->memnow;
 }
 
+/// @brief Move the first block that isn't packed yet into place, like one step of `plmemCompact`.
+/// @return Size of the block moved, or 0 once the whole arena is packed.
+u32 plmemCompactStep(MEM_MGR* memmgr) {
+    MEM_BLOCK* now_block;
+    MEM_BLOCK* next_block;
+    u8* data_ptr;
+
+    if (memmgr->blocklist == MEM_NULL_HANDLE) {
+        memmgr->memnow = memmgr->memptr;
+        return 0;
+    }
+
+    now_block = memmgr->block + memmgr->blocklist;
+
+    if (memmgr->direction != 0) {
+        data_ptr = (u8*)ALIGN(memmgr->memptr, 0, memmgr->memalign);
+
+        while (data_ptr == now_block->ptr) {
+            data_ptr = (u8*)ALIGN(now_block->ptr, now_block->len, memmgr->memalign);
+
+            if (now_block->next == MEM_NULL_HANDLE) {
+                memmgr->memnow = data_ptr;
+                return 0;
+            }
+
+            now_block = memmgr->block + now_block->next;
+        }
+
+        plMemmove(data_ptr, now_block->ptr, now_block->len);
+        now_block->ptr = data_ptr;
+
+        if (now_block->next == MEM_NULL_HANDLE) {
+            memmgr->memnow = (u8*)ALIGN(now_block->ptr, now_block->len, memmgr->memalign);
+        }
+    } else {
+        data_ptr = (u8*)ALIGN_DOWN(memmgr->memptr, now_block->len, memmgr->memalign);
+
+        while (data_ptr == now_block->ptr) {
+            if (now_block->next == MEM_NULL_HANDLE) {
+                memmgr->memnow = now_block->ptr;
+                return 0;
+            }
+
+            next_block = memmgr->block + now_block->next;
+            data_ptr = (u8*)ALIGN_DOWN(now_block->ptr, next_block->len, memmgr->memalign);
+            now_block = next_block;
+        }
+
+        plMemmove(data_ptr, now_block->ptr, now_block->len);
+        now_block->ptr = data_ptr;
+
+        if (now_block->next == MEM_NULL_HANDLE) {
+            memmgr->memnow = now_block->ptr;
+        }
+    }
+
+    return now_block->len;
+}
+
 u32 plmemGetSpace(MEM_MGR* memmgr) {
     return memmgr->memsize - memmgr->used_size;
 }
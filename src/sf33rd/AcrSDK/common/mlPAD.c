@@ -4,6 +4,12 @@
 #include "sf33rd/AcrSDK/ps2/ps2PAD.h"
 #include "structs.h"
 
+#if !defined(TARGET_PS2)
+#include "port/input_log.h"
+#include "port/netplay/netplay.h"
+#include "port/run_ahead.h"
+#endif
+
 const u8 fllever_flip_data[4][16] = {
     { 0x00, 0x01, 0x02, 0x00, 0x04, 0x05, 0x06, 0x00, 0x08, 0x09, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00 },
     { 0x00, 0x01, 0x02, 0x00, 0x08, 0x09, 0x0A, 0x00, 0x04, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00 },
@@ -82,6 +88,13 @@ void flPADGetALL() {
     s16 i;
 
     tarPADRead();
+
+#if !defined(TARGET_PS2)
+    InputLog_Process(tarpad_root);
+    Netplay_ProcessPads(tarpad_root);
+    RunAhead_ProcessPads(tarpad_root);
+#endif
+
     NumOfValidPads = 0;
 
     for (i = 0; i < 2; i++) {
@@ -21,6 +21,10 @@
 #include <stdio.h>
 #include <string.h>
 
+// We can't include sdl_game_renderer.h because SDL types conflict
+// with cri_mw.h
+void SDLGameRenderer_RelocateTextures();
+
 #if !defined(TARGET_PS2) && !defined(_WIN32)
 #include <ctype.h>
 
@@ -276,6 +280,7 @@ void flCompact() {
     flPS2DmaTerminate();
     mflCompact();
     flPS2ClayRetouchMaterialTag();
+    SDLGameRenderer_RelocateTextures();
 }
 
 void flPS2SystemTmpBuffInit() {
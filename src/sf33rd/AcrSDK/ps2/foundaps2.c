@@ -15,6 +15,8 @@
 #include "sf33rd/AcrSDK/ps2/ps2PAD.h"
 #include "structs.h"
 
+#include "port/arena.h"
+#include "port/heap_monitor.h"
 #include "port/sdk_threads.h"
 
 #include <eekernel.h>
@@ -177,14 +179,14 @@ s32 system_work_init() {
 
     flMemset(&flPs2State, 0, sizeof(FLPS2State));
     flPS2VramInit();
-    temp = malloc(0x01800000);
+    temp = malloc(Arena_GetSize(ARENA_HEAP));
 
     if (temp == NULL) {
         return 0;
     }
 
-    fmsInitialize(&flFMS, temp, 0x01800000, 0x40);
-    flPs2State.system_memory_size = 0xA00000;
+    fmsInitialize(&flFMS, temp, Arena_GetSize(ARENA_HEAP), 0x40);
+    flPs2State.system_memory_size = Arena_GetSize(ARENA_SYSMEM);
     temp = flAllocMemoryS(flPs2State.system_memory_size);
     flPs2State.system_memory_start = (uintptr_t)temp;
     mflInit(temp, flPs2State.system_memory_size, 0x40);
@@ -289,6 +291,7 @@ s32 flFlip(u32 flag) {
     flPs2State.Irq_count = 0;
     flFrame += 1;
     flPS2DmaSend();
+    HeapMonitor_EndFrame();
     flPS2SystemTmpBuffFlush();
     flPS2DrawPreparation();
     flPs2State.NowVu1Code = -1;
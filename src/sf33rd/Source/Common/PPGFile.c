@@ -11,6 +11,11 @@
 #include "sf33rd/Source/PS2/ps2Quad.h"
 #include "structs.h"
 
+#if !defined(TARGET_PS2)
+#include "port/startup.h"
+#include "port/texture_cache.h"
+#endif
+
 #define MAGIC_TO_INT(str) ((str[0] << 0x18) | (str[1] << 0x10) | (str[2] << 0x8) | (str[3]))
 #define REVERT_U32(val)                                                                                                \
     (((val & 0xFF) << 0x18) | ((val & 0xFF00) << 8) | ((val >> 8) & 0xFF00) | ((val >> 0x18) & 0xFF))
@@ -53,6 +58,10 @@ void ppg_Initialize(void* lcmAdrs, s32 lcmSize) {
     mmHeapInitialize(&ppg_w.mm, lcmAdrs, lcmSize, ALIGN_UP(sizeof(_MEMMAN_CELL), 16), "- for PPG -");
 }
 
+_MEMMAN_OBJ* ppg_GetHeap() {
+    return &ppg_w.mm;
+}
+
 void* ppgMallocF(s32 size) {
     return mmAlloc(&ppg_w.mm, size, 0);
 }
@@ -440,6 +449,43 @@ ssize_t ppgDecompress(s32 koCmpr, void* srcAdrs, s32 srcSize, void* dstAdrs, s32
     return rnum;
 }
 
+/// @brief Decompress texture or palette data into `mltAdrs` and convert it for the renderer.
+/// @return The converted data, or `NULL` if it couldn't be decompressed. On the port this can
+/// also be data decoded by an earlier run, kept by the texture cache.
+static const void* ppgDecodeChunk(s32 koCmpr, void* cmpAdrs, s32 cmpSize, void* mltAdrs, s32 mltSize, s32 dendL,
+                                  s32 col4, s32 depth) {
+#if !defined(TARGET_PS2)
+    const void* cached = NULL;
+    u64 cacheKey = 0;
+
+    // Uncompressed data is converted in place and costs less to convert than to look up
+    if (koCmpr != 0) {
+        cacheKey = TextureCache_MakeKey(
+            cmpAdrs, cmpSize, mltSize, koCmpr | ((dendL != 0) << 2) | ((col4 != 0) << 3) | (depth << 4));
+        cached = TextureCache_Find(cacheKey, mltSize);
+
+        if (cached != NULL) {
+            return cached;
+        }
+    }
+#endif
+
+    if (mltSize != ppgDecompress(koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize)) {
+        return NULL;
+    }
+
+    ppgChangeDataEndian(mltAdrs, mltSize, dendL, col4, depth, 0);
+
+#if !defined(TARGET_PS2)
+    if (koCmpr != 0) {
+        Startup_CountDecoded(mltSize);
+        TextureCache_Store(cacheKey, mltAdrs, mltSize);
+    }
+#endif
+
+    return mltAdrs;
+}
+
 s32 ppgSetupCmpChunk(u8* srcAdrs, s32 num, u8* dstAdrs) {
     PPXFileHeader* ppx;
     void* cmpAdrs;
@@ -494,6 +540,7 @@ s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s3
     s32 mltSize;
     void* cmpAdrs;
     void* mltAdrs;
+    const void* decAdrs;
     u32 ofs = 0;
 
     if (pch == NULL) {
@@ -561,19 +608,20 @@ s32 ppgSetupPalChunk(Palette* pch, u8* adrs, s32 size, s32 ixNum1st, s32 num, s3
             goto error_handler;
         }
 
-        if (mltSize != ppgDecompress(koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize)) {
+        decAdrs = ppgDecodeChunk(
+            koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize, ppl->c_mode & 4, ppl->formARGB == 0x8888, bits.bitdepth);
+
+        if (decAdrs == NULL) {
             flLogOut("パレットデータの解凍に失敗しました。\n"); // Failed to decompress the palette data.
             ppgPushDecBuff(mltAdrs);
             goto error_handler;
         }
 
-        ppgChangeDataEndian(mltAdrs, mltSize, ppl->c_mode & 4, ppl->formARGB == 0x8888, bits.bitdepth, 0);
-
         if (koCmpr == 0) {
             ppl->c_mode |= 4;
         }
 
-        bits.ptr = mltAdrs;
+        bits.ptr = (void*)decAdrs;
 
         for (i = 0; i < pch->total; i++) {
             pch->handle[i] = flCreatePaletteHandle(&bits, 0);
@@ -1114,8 +1162,7 @@ s32 ppgSetupTexChunk_3rd(Texture* tch, s32 ixNum, u32 attribute) {
     s32 mltSize;
     void* cmpAdrs;
     void* mltAdrs;
-
-    s32 unused_s5;
+    const void* decAdrs;
 
     if (tch == NULL) {
         tch = ppg_w.cur->tex;
@@ -1152,16 +1199,17 @@ s32 ppgSetupTexChunk_3rd(Texture* tch, s32 ixNum, u32 attribute) {
         while (1) {}
     }
 
-    if (mltSize != ppgDecompress(koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize)) {
+    decAdrs = ppgDecodeChunk(
+        koCmpr, cmpAdrs, cmpSize, mltAdrs, mltSize, ppg->pixel & 4, ppg->formARGB == 0x8888, bits.bitdepth);
+
+    if (decAdrs == NULL) {
         // Failed to acquire sprite texture handle.
         flLogOut("テクスチャデータの解凍に失敗しました。\n");
         ppgPushDecBuff(mltAdrs);
         while (1) {}
     }
 
-    unused_s5 = 0;
-    ppgChangeDataEndian(mltAdrs, mltSize, ppg->pixel & 4, ppg->formARGB == 0x8888, bits.bitdepth, unused_s5);
-    bits.ptr = mltAdrs;
+    bits.ptr = (void*)decAdrs;
     hnof->b16[0] = flCreateTextureHandle(&bits, attribute);
     ppgPushDecBuff(mltAdrs);
 
@@ -32,6 +32,10 @@ void zlib_Initialize(void* tempAdrs, s32 tempSize) {
     zlib.info.opaque = NULL;
 }
 
+_MEMMAN_OBJ* zlib_GetHeap() {
+    return &zlib.mobj;
+}
+
 void* zlib_Malloc(void* opaque, u32 items, u32 size) {
     return mmAlloc(&zlib.mobj, size * items, 0);
 }
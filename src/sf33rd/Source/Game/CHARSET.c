@@ -14,6 +14,10 @@
 #include "sf33rd/Source/Game/cmd_data.h"
 #include "sf33rd/Source/Game/workuser.h"
 
+#if !defined(TARGET_PS2)
+#include "port/charset_cache.h"
+#endif
+
 #define LO_2_BYTES(_val) (((s16*)&_val)[0])
 #define HI_2_BYTES(_val) (((s16*)&_val)[1])
 #define WK_AS_PLW ((PLW*)wk)
@@ -332,6 +336,13 @@ void check_cm_extended_code(WORK* wk) {
         wk->cg_ix += wk->cgd_type;
     }
 
+#if !defined(TARGET_PS2)
+    if (CharsetCache_IsEnabled()) {
+        CharsetCache_Run(wk);
+        return;
+    }
+#endif
+
     while (1) {
         cpc = (UNK11*)(wk->set_char_ad + wk->cg_ix);
 
@@ -2762,10 +2773,11 @@ void check_cgd_patdat2(WORK* wk) {
     }
 }
 
+u16 att_req;
+
 void set_new_attnum(WORK* wk) {
     s16 aag_sw;
     uintptr_t dspadrs;
-    static u16 att_req;
 
     wk->renew_attack = wk->cg_att_ix;
 
@@ -12,6 +12,14 @@
 
 #if !defined(TARGET_PS2)
 #include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NJ_SIMD_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NJ_SIMD_NEON
+#endif
 #endif
 
 #define NTH_BYTE(value, n) ((((value >> n * 8) & 0xFF) << n * 8))
@@ -215,6 +223,64 @@ void njCalcPoints(MTX* mtx, Vec3* ps, Vec3* pd, s32 num) {
     }
 }
 
+#if !defined(TARGET_PS2)
+void njCalcPointsXY(MTX* mtx, const f32* xs, const f32* ys, f32* xd, f32* yd, s32 num) {
+    s32 i = 0;
+
+    if (mtx == NULL) {
+        mtx = &cmtx;
+    }
+
+    // Same operation order as njCalcPoint with z = 0, so results match it exactly. Both are built
+    // with -ffp-contract=off, see CMakeLists.txt.
+#if defined(NJ_SIMD_SSE2)
+    const __m128 m00 = _mm_set1_ps(mtx->a[0][0]);
+    const __m128 m01 = _mm_set1_ps(mtx->a[0][1]);
+    const __m128 m10 = _mm_set1_ps(mtx->a[1][0]);
+    const __m128 m11 = _mm_set1_ps(mtx->a[1][1]);
+    const __m128 zx = _mm_set1_ps(0.0f * mtx->a[2][0]);
+    const __m128 zy = _mm_set1_ps(0.0f * mtx->a[2][1]);
+    const __m128 m30 = _mm_set1_ps(mtx->a[3][0]);
+    const __m128 m31 = _mm_set1_ps(mtx->a[3][1]);
+
+    for (; i + 4 <= num; i += 4) {
+        const __m128 x = _mm_loadu_ps(&xs[i]);
+        const __m128 y = _mm_loadu_ps(&ys[i]);
+        const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)), zx), m30);
+        const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)), zy), m31);
+        _mm_storeu_ps(&xd[i], rx);
+        _mm_storeu_ps(&yd[i], ry);
+    }
+#elif defined(NJ_SIMD_NEON)
+    const float32x4_t m00 = vdupq_n_f32(mtx->a[0][0]);
+    const float32x4_t m01 = vdupq_n_f32(mtx->a[0][1]);
+    const float32x4_t m10 = vdupq_n_f32(mtx->a[1][0]);
+    const float32x4_t m11 = vdupq_n_f32(mtx->a[1][1]);
+    const float32x4_t zx = vdupq_n_f32(0.0f * mtx->a[2][0]);
+    const float32x4_t zy = vdupq_n_f32(0.0f * mtx->a[2][1]);
+    const float32x4_t m30 = vdupq_n_f32(mtx->a[3][0]);
+    const float32x4_t m31 = vdupq_n_f32(mtx->a[3][1]);
+
+    for (; i + 4 <= num; i += 4) {
+        const float32x4_t x = vld1q_f32(&xs[i]);
+        const float32x4_t y = vld1q_f32(&ys[i]);
+        const float32x4_t rx = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(x, m00), vmulq_f32(y, m10)), zx), m30);
+        const float32x4_t ry = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_f32(x, m01), vmulq_f32(y, m11)), zy), m31);
+        vst1q_f32(&xd[i], rx);
+        vst1q_f32(&yd[i], ry);
+    }
+#endif
+
+    for (; i < num; i++) {
+        const f32 x = xs[i];
+        const f32 y = ys[i];
+
+        xd[i] = x * mtx->a[0][0] + y * mtx->a[1][0] + 0.0f * mtx->a[2][0] + mtx->a[3][0];
+        yd[i] = x * mtx->a[0][1] + y * mtx->a[1][1] + 0.0f * mtx->a[2][1] + mtx->a[3][1];
+    }
+}
+#endif
+
 void njRotateZ(s32 /* unused */, s32 /* unused */) {
     // Do nothing
 }
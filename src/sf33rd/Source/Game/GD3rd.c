@@ -12,6 +12,8 @@
 #include "sf33rd/Source/Game/workuser.h"
 #include "structs.h"
 
+#include "port/afs.h"
+#include "port/netplay/game_state.h"
 #include "port/sdk_threads.h"
 
 #include <cri_mw.h>
@@ -42,7 +44,17 @@ u16 DskDrvErrRetry;
 PS2CDReadMode ps2CdReadMode;
 s16 plt_req[2]; // size: 0x4, address: 0x579084
 u8 ldreq_break;
+u8 ldreq_pushed; // A request was made since the queue last ran
+
+#if defined(TARGET_PS2)
 struct _adx_fs* adxf = NULL;
+#else
+// Files are read straight from SF33RD.AFS by its table of contents, see port/afs.c. Reads
+// finish before fsRequestFileRead returns, so there is never a command in flight.
+static s32 open_fnum = -1;
+static u32 read_position = 0;
+static bool read_failed = false;
+#endif
 
 #if defined(TARGET_PS2)
 u8 sf3ptinfo[3352];
@@ -75,6 +87,7 @@ s32 Setup_Directory_Record_Data() {
     DskDrvErrType = 0xFFFF;
     DskDrvErrRetry = 0;
 
+#if defined(TARGET_PS2)
     ADXF_LoadPartitionNw(0, "SF33RD.AFS", NULL, sf3ptinfo);
 
     while (1) {
@@ -82,20 +95,14 @@ s32 Setup_Directory_Record_Data() {
             break;
         }
 
-#if defined(TARGET_PS2)
         sceGsSyncV(0);
-#else
-        // CRI relies on VSync interrupts to execute its file system server.
-        // On modern platforms we don't call the VSync interrupt handler until
-        // we get to the main loop. That's why we have to emulate the interrupt
-        // manually like this.
-        begin_interrupt();
-        ADXPS2_ExecVint(0);
-        end_interrupt();
-#endif
-
         ADXM_ExecMain();
     }
+#else
+    if (!AFS_LoadIndex()) {
+        fatal_error("Couldn't read the table of contents of SF33RD.AFS");
+    }
+#endif
 
     ps2CdReadMode.trycount = 64;
     ps2CdReadMode.spindlctrl = 1;
@@ -162,6 +169,7 @@ s32 fsOpen(REQ* req) {
         return 0;
     }
 
+#if defined(TARGET_PS2)
     if (adxf != NULL) {
         ADXF_Close(adxf);
     }
@@ -171,6 +179,11 @@ s32 fsOpen(REQ* req) {
     if (adxf == NULL) {
         return 0;
     }
+#else
+    open_fnum = req->fnum;
+    read_position = 0;
+    read_failed = false;
+#endif
 
     req->info.number = 1;
     req->info.size = appFileSizes[req->fnum];
@@ -178,8 +191,12 @@ s32 fsOpen(REQ* req) {
 }
 
 void fsClose(REQ* /* unused */) {
+#if defined(TARGET_PS2)
     ADXF_Close(adxf);
     adxf = NULL;
+#else
+    open_fnum = -1;
+#endif
 }
 
 u32 fsGetFileSize(u16 fnum) {
@@ -195,14 +212,17 @@ u32 fsCalSectorSize(u32 size) {
 }
 
 s32 fsCansel(REQ* /* unused */) {
+#if defined(TARGET_PS2)
     if (adxf != NULL && ADXF_GetStat(adxf) == ADXF_STAT_READING) {
         ADXF_StopNw(adxf);
     }
+#endif
 
     return 1;
 }
 
 s32 fsCheckCommandExecuting() {
+#if defined(TARGET_PS2)
     if (adxf == NULL) {
         return 0;
     }
@@ -210,16 +230,33 @@ s32 fsCheckCommandExecuting() {
     if (ADXF_GetStat(adxf) == ADXF_STAT_READING || ADXF_GetStat(adxf) == ADXF_STAT_ERROR) {
         return 1;
     }
+#endif
 
     return 0;
 }
 
 s32 fsRequestFileRead(REQ* /* unused */, u32 sec, void* buff) {
+#if defined(TARGET_PS2)
     ADXF_ReadNw(adxf, sec, buff);
+#else
+    if (open_fnum < 0) {
+        return 0;
+    }
+
+    // Only the file itself is read, not the rest of its last sector
+    const u32 remaining = AFS_GetFileSize(open_fnum) - read_position;
+    const u32 expected = (sec * 2048 < remaining) ? sec * 2048 : remaining;
+    const u32 read = AFS_ReadFile(open_fnum, read_position, buff, expected);
+
+    read_position += read;
+    read_failed = (read != expected);
+#endif
+
     return 1;
 }
 
 s32 fsCheckFileReaded(REQ* /* unused */) {
+#if defined(TARGET_PS2)
     s32 rnum = ADXF_GetStat(adxf);
     fsUpdateDiskDriveError();
 
@@ -231,6 +268,12 @@ s32 fsCheckFileReaded(REQ* /* unused */) {
     if (rnum == ADXF_STAT_READING) {
         return 0;
     }
+#else
+    if (read_failed) {
+        DskDrvErrBe = 1;
+        return 2;
+    }
+#endif
 
     return 1;
 }
@@ -461,6 +504,7 @@ s32 Push_LDREQ_Queue(REQ* ldreq) {
     }
 
     if (i != 0x10) {
+        ldreq_pushed = 1;
         q_ldreq[i] = ldreq[0];
         q_ldreq[i].be = 2;
         q_ldreq[i].rno = 0;
@@ -490,8 +534,15 @@ s32 Push_LDREQ_Queue(REQ* ldreq) {
 
 void Check_LDREQ_Queue() {
     s16 i;
+    const bool is_held = GameState_IsLoadQueueHeld(ldreq_pushed);
 
     disp_ldreq_status();
+    ldreq_pushed = 0;
+
+    // Loading can't be undone, so it doesn't move on frames that may be
+    if (is_held) {
+        return;
+    }
 
     if (!ldreq_break) {
         if (q_ldreq->be != 0) {
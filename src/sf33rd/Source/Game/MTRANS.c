@@ -15,16 +15,49 @@
 #include "sf33rd/Source/PS2/ps2Quad.h"
 #include "structs.h"
 
+#if !defined(TARGET_PS2)
+#include "port/arena.h"
+#endif
+
 #define PRIO_BASE_SIZE 128
 
 // sbss
 s32 curr_bright;
 SpriteChipSet seqs_w;
+static u16 seqs_chip_max;
 
 // bss
 f32 PrioBase[PRIO_BASE_SIZE];
 f32 PrioBaseOriginal[PRIO_BASE_SIZE];
 
+#if !defined(TARGET_PS2)
+#define CHIP_BATCH_MAX 256
+
+typedef struct {
+    s32 w;
+    s32 h;
+    s32 gix;
+    s32 code;
+    s32 attr;
+    u32 color;
+    s32 id;
+} PendingChip;
+
+// Chips are queued here and transformed and culled in one pass when the object is done.
+// Corners are stored as separate x and y arrays, top left and bottom right of each chip in turn.
+typedef struct {
+    s32 count;
+    f32 xs[CHIP_BATCH_MAX * 2];
+    f32 ys[CHIP_BATCH_MAX * 2];
+    f32 sxs[CHIP_BATCH_MAX * 2];
+    f32 sys[CHIP_BATCH_MAX * 2];
+    u8 visible[CHIP_BATCH_MAX];
+    PendingChip chips[CHIP_BATCH_MAX];
+} ChipBatch;
+
+static ChipBatch chip_batch;
+#endif
+
 // rodata
 static const u16 flptbl[4] = { 0x0000, 0x8000, 0x4000, 0xC000 };
 
@@ -95,6 +128,13 @@ static const u32 bright_type[4][16] = { { 0x00FFFFFF,
 
 // forward decls
 static void DebugLine(f32 x, f32 y, f32 w, f32 h);
+
+#if !defined(TARGET_PS2)
+static void flush_chip_batch();
+static s32 can_cull_chips();
+static s32 is_object_on_screen(const TileMapEntry* trsptr, u32* textbl, s32 count, s32 flip);
+static s32 is_chip_on_screen(f32 x, f32 y, s32 w, s32 h, s32 flip);
+#endif
 s32 seqsStoreChip(f32 x, f32 y, s32 w, s32 h, s32 gix, s32 code, s32 attr, s32 alpha, s32 id);
 void appRenewTempPriority(s32 z);
 static s16 check_patcash_ex_trans(PatternCollection* padr, u32 cg);
@@ -378,6 +418,9 @@ s16 getObjectHeight(u16 cgnum) {
 }
 
 void mlt_obj_trans_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
+#if !defined(TARGET_PS2)
+    s32 cull_chips = 0;
+#endif
     u32* textbl;
     u16* trsbas;
     TileMapEntry* trsptr;
@@ -543,6 +586,16 @@ void mlt_obj_trans_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
         cp->curr_disp = 1;
         cp->time = mt->mltcshtime16;
 
+#if !defined(TARGET_PS2)
+        cull_chips = can_cull_chips();
+
+        if (cull_chips && !is_object_on_screen(trsptr, textbl, count, attr)) {
+            seqs_w.up[mt->id] = 1;
+            appRenewTempPriority(wk->position_z);
+            return;
+        }
+#endif
+
         makeup_tpu_free(mt->mltnum16 / 256, mt->mltnum32 / 64, &cp->map);
         cc.parts.group = i;
 
@@ -566,6 +619,13 @@ void mlt_obj_trans_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
             size = (wh * wh) << 6;
             cc.parts.offset = trsptr->code;
 
+#if !defined(TARGET_PS2)
+            if (cull_chips && !is_chip_on_screen(x, y, dw, dh, attr)) {
+                trsptr++;
+                continue;
+            }
+#endif
+
             switch (wh) {
             case 1:
             case 2:
@@ -618,6 +678,9 @@ void mlt_obj_trans_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
 }
 
 void mlt_obj_trans(MultiTexture* mt, WORK* wk, s32 base_y) {
+#if !defined(TARGET_PS2)
+    s32 cull_chips = 0;
+#endif
     u32* textbl;
     u16* trsbas;
     TileMapEntry* trsptr;
@@ -674,6 +737,16 @@ void mlt_obj_trans(MultiTexture* mt, WORK* wk, s32 base_y) {
     }
 
     mlt_obj_matrix(wk, base_y);
+
+#if !defined(TARGET_PS2)
+    cull_chips = can_cull_chips();
+
+    if (cull_chips && !is_object_on_screen(trsptr, textbl, count, attr)) {
+        seqs_w.up[mt->id] = 1;
+        appRenewTempPriority(wk->position_z);
+        return;
+    }
+#endif
     cc.parts.group = i;
 
     while (count--) {
@@ -696,6 +769,13 @@ void mlt_obj_trans(MultiTexture* mt, WORK* wk, s32 base_y) {
         size = (wh * wh) << 6;
         cc.parts.offset = trsptr->code;
 
+#if !defined(TARGET_PS2)
+        if (cull_chips && !is_chip_on_screen(x, y, dw, dh, attr)) {
+            trsptr++;
+            continue;
+        }
+#endif
+
         switch (wh) {
         case 1:
         case 2:
@@ -753,6 +833,9 @@ void mlt_obj_trans(MultiTexture* mt, WORK* wk, s32 base_y) {
 }
 
 void mlt_obj_trans_cp3_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
+#if !defined(TARGET_PS2)
+    s32 cull_chips = 0;
+#endif
     u32* textbl;
     u16* trsbas;
     TileMapEntry* trsptr;
@@ -925,6 +1008,16 @@ void mlt_obj_trans_cp3_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
         cp = mt->cpat->adr[ix];
         cp->curr_disp = 1;
         cp->time = mt->mltcshtime16;
+#if !defined(TARGET_PS2)
+        cull_chips = can_cull_chips();
+
+        if (cull_chips && !is_object_on_screen(trsptr, textbl, count, flip)) {
+            seqs_w.up[mt->id] = 1;
+            appRenewTempPriority(wk->position_z);
+            return;
+        }
+#endif
+
         makeup_tpu_free(mt->mltnum16 / 256, mt->mltnum32 / 64, &cp->map);
         cc.parts.group = i;
 
@@ -951,6 +1044,13 @@ void mlt_obj_trans_cp3_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
             attr = (attr ^ flip) & 0xC000;
             cc.parts.offset = trsptr->code;
 
+#if !defined(TARGET_PS2)
+            if (cull_chips && !is_chip_on_screen(x, y, dw, dh, flip)) {
+                trsptr++;
+                continue;
+            }
+#endif
+
             switch (wh) {
             case 1:
             case 2:
@@ -1003,6 +1103,9 @@ void mlt_obj_trans_cp3_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
 }
 
 void mlt_obj_trans_cp3(MultiTexture* mt, WORK* wk, s32 base_y) {
+#if !defined(TARGET_PS2)
+    s32 cull_chips = 0;
+#endif
     u32* textbl;
     u16* trsbas;
     TileMapEntry* trsptr;
@@ -1061,6 +1164,16 @@ void mlt_obj_trans_cp3(MultiTexture* mt, WORK* wk, s32 base_y) {
     }
 
     mlt_obj_matrix(wk, base_y);
+
+#if !defined(TARGET_PS2)
+    cull_chips = can_cull_chips();
+
+    if (cull_chips && !is_object_on_screen(trsptr, textbl, count, flip)) {
+        seqs_w.up[mt->id] = 1;
+        appRenewTempPriority(wk->position_z);
+        return;
+    }
+#endif
     cc.parts.group = i;
 
     while (count--) {
@@ -1086,6 +1199,13 @@ void mlt_obj_trans_cp3(MultiTexture* mt, WORK* wk, s32 base_y) {
         attr = (attr ^ flip) & 0xC000;
         cc.parts.offset = trsptr->code;
 
+#if !defined(TARGET_PS2)
+        if (cull_chips && !is_chip_on_screen(x, y, dw, dh, flip)) {
+            trsptr++;
+            continue;
+        }
+#endif
+
         switch (wh) {
         case 1:
         case 2:
@@ -1146,6 +1266,9 @@ void mlt_obj_trans_cp3(MultiTexture* mt, WORK* wk, s32 base_y) {
 INCLUDE_ASM("asm/anniversary/nonmatchings/sf33rd/Source/Game/MTRANS", mlt_obj_trans_rgb_ext);
 #else
 void mlt_obj_trans_rgb_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
+#if !defined(TARGET_PS2)
+    s32 cull_chips = 0;
+#endif
     u32* textbl;
     u16* trsbas;
     TileMapEntry* trsptr;
@@ -1306,6 +1429,16 @@ void mlt_obj_trans_rgb_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
         cp = mt->cpat->adr[ix];
         cp->curr_disp = 1;
         cp->time = mt->mltcshtime16;
+#if !defined(TARGET_PS2)
+        cull_chips = can_cull_chips();
+
+        if (cull_chips && !is_object_on_screen(trsptr, textbl, count, flip)) {
+            seqs_w.up[mt->id] = 1;
+            appRenewTempPriority(wk->position_z);
+            return;
+        }
+#endif
+
         makeup_tpu_free(mt->mltnum16 / 256, mt->mltnum32 / 64, &cp->map);
         cc.parts.group = i;
 
@@ -1332,6 +1465,13 @@ void mlt_obj_trans_rgb_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
             attr = (attr ^ flip) & 0xC000;
             cc.parts.offset = trsptr->code;
 
+#if !defined(TARGET_PS2)
+            if (cull_chips && !is_chip_on_screen(x, y, dw, dh, flip)) {
+                trsptr++;
+                continue;
+            }
+#endif
+
             switch (wh) {
             case 1:
             case 2:
@@ -1377,6 +1517,9 @@ void mlt_obj_trans_rgb_ext(MultiTexture* mt, WORK* wk, s32 base_y) {
 #endif
 
 void mlt_obj_trans_rgb(MultiTexture* mt, WORK* wk, s32 base_y) {
+#if !defined(TARGET_PS2)
+    s32 cull_chips = 0;
+#endif
     u32* textbl;
     u16* trsbas;
     TileMapEntry* trsptr;
@@ -1435,6 +1578,16 @@ void mlt_obj_trans_rgb(MultiTexture* mt, WORK* wk, s32 base_y) {
     }
 
     mlt_obj_matrix(wk, base_y);
+
+#if !defined(TARGET_PS2)
+    cull_chips = can_cull_chips();
+
+    if (cull_chips && !is_object_on_screen(trsptr, textbl, count, flip)) {
+        seqs_w.up[mt->id] = 1;
+        appRenewTempPriority(wk->position_z);
+        return;
+    }
+#endif
     cc.parts.group = i;
 
     while (count--) {
@@ -1460,6 +1613,13 @@ void mlt_obj_trans_rgb(MultiTexture* mt, WORK* wk, s32 base_y) {
         attr = (attr ^ flip) & 0xC000;
         cc.parts.offset = trsptr->code;
 
+#if !defined(TARGET_PS2)
+        if (cull_chips && !is_chip_on_screen(x, y, dw, dh, flip)) {
+            trsptr++;
+            continue;
+        }
+#endif
+
         switch (wh) {
         case 1:
         case 2:
@@ -1509,6 +1669,10 @@ void mlt_obj_trans_rgb(MultiTexture* mt, WORK* wk, s32 base_y) {
 }
 
 void mlt_obj_matrix(WORK* wk, s32 base_y) {
+#if !defined(TARGET_PS2)
+    flush_chip_batch();
+#endif
+
     njSetMatrix(NULL, &BgMATRIX[wk->my_family]);
     njTranslate(NULL, wk->position_x, wk->position_y + base_y, PrioBase[wk->position_z]);
 
@@ -1551,11 +1715,18 @@ void appRenewTempPriority_1_Chip() {
 
 void appRenewTempPriority(s32 z) {
     MTX mtx;
+
+#if !defined(TARGET_PS2)
+    flush_chip_batch();
+#endif
+
     njGetMatrix(&mtx);
     PrioBase[z] = mtx.a[3][2];
 }
 
 void seqsInitialize(void* adrs) {
+    const u32 chip_count = seqsGetUseMemorySize() / sizeof(Sprite2);
+
     if (adrs == NULL) {
         while (1) {
             // Do nothing
@@ -1564,6 +1735,7 @@ void seqsInitialize(void* adrs) {
 
     seqs_w.chip = (Sprite2*)adrs;
     seqs_w.sprMax = 0;
+    seqs_chip_max = (chip_count < 0xFFFF) ? chip_count : 0xFFFF;
 }
 
 u16 seqsGetSprMax() {
@@ -1571,7 +1743,11 @@ u16 seqsGetSprMax() {
 }
 
 u32 seqsGetUseMemorySize() {
+#if defined(TARGET_PS2)
     return 0xD000;
+#else
+    return Arena_GetSize(ARENA_SEQS);
+#endif
 }
 
 void seqsBeforeProcess() {
@@ -1590,6 +1766,10 @@ void seqsAfterProcess() {
     u32 keep = 0;
     u32 val = 0;
 
+#if !defined(TARGET_PS2)
+    flush_chip_batch();
+#endif
+
     if ((Debug_w[0x27] != 3) && (seqs_w.sprTotal != 0)) {
         for (i = 0; i < 24; i++) {
             if (seqs_w.up[i]) {
@@ -1626,8 +1806,7 @@ void seqsAfterProcess() {
     }
 }
 
-s32 seqsStoreChip(f32 x, f32 y, s32 w, s32 h, s32 gix, s32 code, s32 attr, s32 alpha, s32 id) {
-    Sprite2* chip;
+static void setup_chip(Sprite2* chip, s32 w, s32 h, s32 gix, s32 code, s32 attr, u32 color, s32 id) {
     s32 u;
     s32 v;
 
@@ -1639,19 +1818,6 @@ s32 seqsStoreChip(f32 x, f32 y, s32 w, s32 h, s32 gix, s32 code, s32 attr, s32 a
     const f32 dy = 0;
 #endif
 
-    chip = &seqs_w.chip[seqs_w.sprTotal];
-    chip->v[0].x = x;
-    chip->v[0].y = y;
-    chip->v[1].x = x + w;
-    chip->v[1].y = y - h;
-    chip->v[0].z = chip->v[1].z = 0.0f;
-    njCalcPoint(NULL, &chip->v[0], &chip->v[0]);
-    njCalcPoint(NULL, &chip->v[1], &chip->v[1]);
-
-    if ((chip->v[0].x >= 384.0f) || (chip->v[1].x < 0.0f) || (chip->v[0].y >= 224.0f) || (chip->v[1].y < 0.0f)) {
-        return 1;
-    }
-
     if (!(attr & 0x2000)) {
         u = (code & 0xF) * 16;
         v = code & 0xF0;
@@ -1693,19 +1859,261 @@ s32 seqsStoreChip(f32 x, f32 y, s32 w, s32 h, s32 gix, s32 code, s32 attr, s32 a
     }
 
     chip->texCode |= ppgGetUsingPaletteHandle(NULL, attr & 0x1FF) << 16;
-    chip->vtxColor = curr_bright | ((0xFF - alpha) << 24);
+    chip->vtxColor = color;
     chip->id = id;
     seqs_w.sprTotal += 1;
 
-    if (seqs_w.sprTotal > 0x400) {
+    if (seqs_w.sprTotal > seqs_chip_max) {
         // The number of OBJ fragments has exceeded the planned number
         flLogOut("ＯＢＪの破片が予定数を越えてしまいました");
         while (1) {}
     }
+}
+
+static s32 is_chip_visible(const Sprite2* chip) {
+    return !((chip->v[0].x >= 384.0f) || (chip->v[1].x < 0.0f) || (chip->v[0].y >= 224.0f) || (chip->v[1].y < 0.0f));
+}
+
+#if defined(TARGET_PS2)
+s32 seqsStoreChip(f32 x, f32 y, s32 w, s32 h, s32 gix, s32 code, s32 attr, s32 alpha, s32 id) {
+    Sprite2* chip;
+
+    chip = &seqs_w.chip[seqs_w.sprTotal];
+    chip->v[0].x = x;
+    chip->v[0].y = y;
+    chip->v[1].x = x + w;
+    chip->v[1].y = y - h;
+    chip->v[0].z = chip->v[1].z = 0.0f;
+    njCalcPoint(NULL, &chip->v[0], &chip->v[0]);
+    njCalcPoint(NULL, &chip->v[1], &chip->v[1]);
+
+    if (!is_chip_visible(chip)) {
+        return 1;
+    }
+
+    setup_chip(chip, w, h, gix, code, attr, curr_bright | ((0xFF - alpha) << 24), id);
+    return 1;
+}
+#else
+s32 seqsStoreChip(f32 x, f32 y, s32 w, s32 h, s32 gix, s32 code, s32 attr, s32 alpha, s32 id) {
+    const s32 i = chip_batch.count;
+    PendingChip* pending = &chip_batch.chips[i];
+
+    chip_batch.xs[i * 2] = x;
+    chip_batch.ys[i * 2] = y;
+    chip_batch.xs[i * 2 + 1] = x + w;
+    chip_batch.ys[i * 2 + 1] = y - h;
+
+    pending->w = w;
+    pending->h = h;
+    pending->gix = gix;
+    pending->code = code;
+    pending->attr = attr;
+    pending->color = curr_bright | ((0xFF - alpha) << 24);
+    pending->id = id;
+    chip_batch.count += 1;
+
+    if (chip_batch.count >= CHIP_BATCH_MAX) {
+        flush_chip_batch();
+    }
+
+    return 1;
+}
+
+static s32 is_batch_transform_exact(const MTX* mtx) {
+    MTX probe = *mtx;
+    s32 i;
+    s32 j;
+
+    // Every stored chip moves the matrix forward in z. Corners can only be transformed up front
+    // if that step leaves everything but the z translation alone.
+    njTranslate(&probe, 0, 0, 1.0f / 65536.0f);
+
+    for (i = 0; i < 4; i++) {
+        for (j = 0; j < 4; j++) {
+            if ((i == 3) && (j == 2)) {
+                continue;
+            }
+
+            if (probe.a[i][j] != mtx->a[i][j]) {
+                return 0;
+            }
+        }
+    }
 
     return 1;
 }
 
+static s32 can_cull_chips() {
+    MTX mtx;
+
+    njGetMatrix(&mtx);
+    return is_batch_transform_exact(&mtx);
+}
+
+static s32 is_rect_on_screen(f32 x0, f32 y0, f32 x1, f32 y1) {
+    Vec3 v[2];
+
+    v[0].x = x0;
+    v[0].y = y0;
+    v[1].x = x1;
+    v[1].y = y1;
+    v[0].z = v[1].z = 0.0f;
+    njCalcPoints(NULL, v, v, 2);
+    return !((v[0].x >= 384.0f) || (v[1].x < 0.0f) || (v[0].y >= 224.0f) || (v[1].y < 0.0f));
+}
+
+// Same rect and test as seqsStoreChip, so a chip that fails here would have been dropped there.
+// Only valid while can_cull_chips holds for the object.
+static s32 is_chip_on_screen(f32 x, f32 y, s32 w, s32 h, s32 flip) {
+    const f32 x0 = x - (w * BOOL(flip & 0x8000));
+    const f32 y0 = y + (h * BOOL(flip & 0x4000));
+
+    return is_rect_on_screen(x0, y0, x0 + w, y0 - h);
+}
+
+// Conservative test for a whole pattern, from chip offsets and sizes only. Nothing is decoded.
+static s32 is_object_on_screen(const TileMapEntry* trsptr, u32* textbl, s32 count, s32 flip) {
+    const TEX* texptr;
+    f32 x = 0.0f;
+    f32 y = 0.0f;
+    f32 x_min = 0.0f;
+    f32 x_max = 0.0f;
+    f32 y_min = 0.0f;
+    f32 y_max = 0.0f;
+    f32 corner_x[4];
+    f32 corner_y[4];
+    s32 dw;
+    s32 dh;
+    s32 i;
+
+    if (count <= 0) {
+        return 0;
+    }
+
+    for (i = 0; i < count; i++, trsptr++) {
+        if (flip & 0x8000) {
+            x += trsptr->x;
+        } else {
+            x -= trsptr->x;
+        }
+
+        if (flip & 0x4000) {
+            y -= trsptr->y;
+        } else {
+            y += trsptr->y;
+        }
+
+        texptr = (const TEX*)((uintptr_t)textbl + textbl[trsptr->code]);
+        dw = (texptr->wh & 0xE0) >> 2;
+        dh = (texptr->wh & 0x1C) * 2;
+
+        const f32 x0 = x - (dw * BOOL(flip & 0x8000));
+        const f32 y0 = y + (dh * BOOL(flip & 0x4000));
+
+        if ((i == 0) || (x0 < x_min)) {
+            x_min = x0;
+        }
+
+        if ((i == 0) || (x0 + dw > x_max)) {
+            x_max = x0 + dw;
+        }
+
+        if ((i == 0) || (y0 - dh < y_min)) {
+            y_min = y0 - dh;
+        }
+
+        if ((i == 0) || (y0 > y_max)) {
+            y_max = y0;
+        }
+    }
+
+    // The matrix may scale or mirror, so test the screen bounds of all four corners
+    corner_x[0] = corner_x[2] = x_min;
+    corner_x[1] = corner_x[3] = x_max;
+    corner_y[0] = corner_y[1] = y_min;
+    corner_y[2] = corner_y[3] = y_max;
+    njCalcPointsXY(NULL, corner_x, corner_y, corner_x, corner_y, 4);
+
+    x_min = x_max = corner_x[0];
+    y_min = y_max = corner_y[0];
+
+    for (i = 1; i < 4; i++) {
+        x_min = (corner_x[i] < x_min) ? corner_x[i] : x_min;
+        x_max = (corner_x[i] > x_max) ? corner_x[i] : x_max;
+        y_min = (corner_y[i] < y_min) ? corner_y[i] : y_min;
+        y_max = (corner_y[i] > y_max) ? corner_y[i] : y_max;
+    }
+
+    // One pixel of slack on every side
+    return (x_min < 385.0f) && (x_max >= -1.0f) && (y_min < 225.0f) && (y_max >= -1.0f);
+}
+
+static void flush_chip_batch() {
+    MTX mtx;
+    s32 exact;
+    s32 i;
+
+    if (chip_batch.count == 0) {
+        return;
+    }
+
+    njGetMatrix(&mtx);
+    exact = is_batch_transform_exact(&mtx);
+
+    if (exact) {
+        njCalcPointsXY(&mtx, chip_batch.xs, chip_batch.ys, chip_batch.sxs, chip_batch.sys, chip_batch.count * 2);
+
+        // Cull the whole batch before touching any chip
+        for (i = 0; i < chip_batch.count; i++) {
+            const f32* sx = &chip_batch.sxs[i * 2];
+            const f32* sy = &chip_batch.sys[i * 2];
+
+            chip_batch.visible[i] = !(sx[0] >= 384.0f) & !(sx[1] < 0.0f) & !(sy[0] >= 224.0f) & !(sy[1] < 0.0f);
+        }
+    }
+
+    for (i = 0; i < chip_batch.count; i++) {
+        const PendingChip* pending = &chip_batch.chips[i];
+        Sprite2* chip = &seqs_w.chip[seqs_w.sprTotal];
+        const f32* xs = &chip_batch.xs[i * 2];
+        const f32* ys = &chip_batch.ys[i * 2];
+
+        if (exact) {
+            if (!chip_batch.visible[i]) {
+                continue;
+            }
+
+            // z is the only part that changes from chip to chip
+            njGetMatrix(&mtx);
+            chip->v[0].x = chip_batch.sxs[i * 2];
+            chip->v[0].y = chip_batch.sys[i * 2];
+            chip->v[1].x = chip_batch.sxs[i * 2 + 1];
+            chip->v[1].y = chip_batch.sys[i * 2 + 1];
+            chip->v[0].z = xs[0] * mtx.a[0][2] + ys[0] * mtx.a[1][2] + 0.0f * mtx.a[2][2] + mtx.a[3][2];
+            chip->v[1].z = xs[1] * mtx.a[0][2] + ys[1] * mtx.a[1][2] + 0.0f * mtx.a[2][2] + mtx.a[3][2];
+        } else {
+            chip->v[0].x = xs[0];
+            chip->v[0].y = ys[0];
+            chip->v[1].x = xs[1];
+            chip->v[1].y = ys[1];
+            chip->v[0].z = chip->v[1].z = 0.0f;
+            njCalcPoint(NULL, &chip->v[0], &chip->v[0]);
+            njCalcPoint(NULL, &chip->v[1], &chip->v[1]);
+
+            if (!is_chip_visible(chip)) {
+                continue;
+            }
+        }
+
+        setup_chip(
+            chip, pending->w, pending->h, pending->gix, pending->code, pending->attr, pending->color, pending->id);
+    }
+
+    chip_batch.count = 0;
+}
+#endif
+
 static s32 get_mltbuf16(MultiTexture* mt, u32 code, u32 palt, s32* ret) {
     s32 i;
     s32 b = -1;
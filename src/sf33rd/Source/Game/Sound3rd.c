@@ -1,5 +1,6 @@
 #include "sf33rd/Source/Game/Sound3rd.h"
 #include "common.h"
+#include "port/netplay/game_state.h"
 #include "port/sdl/sdl_adx_sound.h"
 #include "sf33rd/AcrSDK/MiddleWare/PS2/ADX/flADX.h"
 #include "sf33rd/AcrSDK/MiddleWare/PS2/CapSndEng/cse.h"
@@ -245,6 +246,11 @@ void setupSoundMode() {
 }
 
 void sound_request_for_dc(SoundPatchConfig* rmc, s16 pan) {
+    // Speculative frames are rolled back, their sounds play when the frame runs for real
+    if (GameState_IsSpeculative()) {
+        return;
+    }
+
     if (rmc->ptix != 0x7F) {
         if (pan < -0x20) {
             pan = -0x20;
@@ -19,6 +19,10 @@
 #include "sf33rd/Source/Game/workuser.h"
 #include "structs.h"
 
+#if !defined(TARGET_PS2)
+#include "port/sdl/sdl_game_renderer.h"
+#endif
+
 // sbss
 Vertex scrDrawPos[4];
 Polygon bgpoly[4];
@@ -52,6 +56,10 @@ static void bgDrawOneChip(s32 x, s32 y, s32 xs, s32 ys, s32 gbix, u32 vtxCol, s3
 static void bgAkebonoDraw();
 static void ppgCalScrPosition(s32 x, s32 y, s32 xs, s32 ys);
 
+#if !defined(TARGET_PS2)
+static void bgDrawOneScreenCached(s32 bgnum, s32 gixbase, s32* xx, s32* yy, s32 ofsPal, PPGDataList* curDataList);
+#endif
+
 void Bg_TexInit() {
     s32 i;
 
@@ -1110,6 +1118,13 @@ void bgRWWorkUpdate() {
 void bgDrawOneScreen(s32 bgnum, s32 gixbase, s32* xx, s32* yy, s32 /* unused */, s32 ofsPal, PPGDataList* curDataList) {
     s32 i, x, y, gbix;
 
+#if !defined(TARGET_PS2)
+    if ((No_Trans == 0) && (bgnum < SDL_GAME_RENDERER_LAYER_COUNT) && SDLGameRenderer_IsLayerCacheEnabled()) {
+        bgDrawOneScreenCached(bgnum, gixbase, xx, yy, ofsPal, curDataList);
+        return;
+    }
+#endif
+
     for (y = yy[0]; y < yy[1]; y += 128) {
         for (x = xx[0]; x < xx[1]; x += 128) {
             gbix = ((y >> 7) << 3) + (x >> 7) + gixbase;
@@ -1132,6 +1147,80 @@ void bgDrawOneScreen(s32 bgnum, s32 gixbase, s32* xx, s32* yy, s32 /* unused */,
     }
 }
 
+#if !defined(TARGET_PS2)
+// Same as bgDrawOneScreen, but chips are drawn once into a cached layer and the visible part of
+// the layer is drawn as a single quad. Only chips whose texture, palette or rewrite frame changed
+// are redrawn.
+static void bgDrawOneScreenCached(s32 bgnum, s32 gixbase, s32* xx, s32* yy, s32 ofsPal, PPGDataList* curDataList) {
+    SDLGameRenderer_Sprite sprite;
+    MTX screen_matrix;
+    Vec3 point[2];
+    s32 i, x, y, gbix;
+    s32 x_end, y_end;
+    s32 use_rw_list;
+    u64 key;
+
+    njGetMatrix(&screen_matrix);
+    x_end = (xx[1] + 0x7F) & ~0x7F;
+    y_end = (yy[1] + 0x7F) & ~0x7F;
+
+    for (y = yy[0]; y < yy[1]; y += 128) {
+        for (x = xx[0]; x < xx[1]; x += 128) {
+            gbix = ((y >> 7) << 3) + (x >> 7) + gixbase;
+            use_rw_list = 0;
+
+            if (rw_bg_flag[bgnum] && rw_num) {
+                for (i = 0; i < rw_num; i++) {
+                    if (bgnum == rw_dat[i].bg_num && gbix == rw_dat[i].rwgbix) {
+                        gbix = rw_dat[i].gbix;
+                        if (!(ppgCheckTextureNumber(0, gbix))) {
+                            ppgSetupCurrentDataList(&ppgRwBgList);
+                            use_rw_list = 1;
+                        }
+                        break;
+                    }
+                }
+            }
+
+            key = (u32)gbix | ((u64)use_rw_list << 32) | ((u64)(ppgCheckTextureNumber(0, gbix) != 0) << 33) |
+                  ((u64)(u32)ofsPal << 34);
+
+            if (SDLGameRenderer_BeginLayerCell(bgnum, x >> 7, y >> 7, key)) {
+                // Draw the chip at the top left corner, the renderer moves it into its cell
+                njUnitMatrix(0);
+                njTranslate(0, -x, -y, 0.0f);
+                bgDrawOneChip(x, y, 128, 128, gbix, -1, ofsPal);
+                njSetMatrix(0, &screen_matrix);
+                SDLGameRenderer_EndLayerCell();
+            }
+
+            ppgSetupCurrentDataList(curDataList);
+        }
+    }
+
+    point[0].x = xx[0];
+    point[0].y = yy[0];
+    point[1].x = x_end;
+    point[1].y = y_end;
+    point[0].z = point[1].z = 0.0f;
+    njCalcPoints(0, point, point, 2);
+
+    sprite.v[0].x = sprite.v[2].x = point[0].x;
+    sprite.v[0].y = sprite.v[1].y = point[0].y;
+    sprite.v[1].x = sprite.v[3].x = point[1].x;
+    sprite.v[2].y = sprite.v[3].y = point[1].y;
+    sprite.v[0].z = sprite.v[1].z = sprite.v[2].z = sprite.v[3].z = point[0].z;
+
+    sprite.t[0].s = sprite.t[2].s = xx[0] / 1024.0f;
+    sprite.t[0].t = sprite.t[1].t = yy[0] / 1024.0f;
+    sprite.t[1].s = sprite.t[3].s = x_end / 1024.0f;
+    sprite.t[2].t = sprite.t[3].t = y_end / 1024.0f;
+    sprite.tex_code = 0;
+
+    SDLGameRenderer_DrawLayer(bgnum, &sprite);
+}
+#endif
+
 void bgDrawOneChip(s32 x, s32 y, s32 xs, s32 ys, s32 gbix, u32 vtxCol, s32 ofsPal) {
     s32 i;
 
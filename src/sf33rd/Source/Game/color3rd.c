@@ -182,6 +182,11 @@ void load_any_color(u16 ix, u8 kokey) {
     }
 }
 
+/// @brief AFS file that `load_any_color` reads for `ix`.
+u16 get_color_file_apfn(u16 ix) {
+    return color_file[ix].apfn;
+}
+
 void set_hitmark_color() {
     u16* hmcol = (u16*)&hitmark_color;
     s16 i;
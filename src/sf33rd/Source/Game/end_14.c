@@ -37,9 +37,7 @@ s16 end_e00_0000_col_sub();
 s16 end_e00_0000_col_sub2();
 void end_e00_1000_col_sub();
 
-struct {
-    XY xy[2];
-} gxy;
+END14_XY gxy;
 
 const s16 timer_e_tbl[9] = { 1320, 240, 900, 1200, 360, 360, 300, 420, 600 };
 
@@ -1,4 +1,5 @@
 #include "sf33rd/Source/Game/init3rd.h"
+#include "port/memcard.h"
 #include "sf33rd/Source/Game/DEMO00.h"
 #include "sf33rd/Source/Game/DIR_DATA.h"
 #include "sf33rd/Source/Game/EFFECT.h"
@@ -45,9 +46,10 @@ void Setup_Difficult_V();
 void Init_Task(struct _TASK* task_ptr) {
     void (*Main_Jmp_Tbl[])() = { Init_Task_1st, Init_Task_Aload, Init_Task_2nd, Init_Task_End };
 
-    #if defined(MEMCARD_DISABLED)
-    Main_Jmp_Tbl[1] = Init_Task_Wait;
-    #endif
+    // Without a card there is no system file to load
+    if (!Memcard_IsInserted()) {
+        Main_Jmp_Tbl[1] = Init_Task_Wait;
+    }
 
     Main_Jmp_Tbl[task_ptr->r_no[0]](task_ptr);
 }
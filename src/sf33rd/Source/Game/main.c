@@ -23,17 +23,29 @@
 #include "sf33rd/Source/Game/Sound3rd.h"
 #include "sf33rd/Source/Game/WORK_SYS.h"
 #include "sf33rd/Source/Game/bg.h"
+#include "sf33rd/Source/Game/chren3rd.h"
 #include "sf33rd/Source/Game/color3rd.h"
 #include "sf33rd/Source/Game/debug/Debug.h"
 #include "sf33rd/Source/Game/init3rd.h"
 #include "sf33rd/Source/Game/texcash.h"
+#include "sf33rd/Source/Game/texgroup.h"
 #include "sf33rd/Source/Game/workuser.h"
 #include "sf33rd/Source/PS2/mc/knjsub.h"
 #include "sf33rd/Source/PS2/mc/mcsub.h"
 #include "sf33rd/Source/PS2/ps2Quad.h"
 #include "structs.h"
 
+#include "port/afs.h"
+#include "port/arena.h"
+#include "port/batch.h"
+#include "port/bench.h"
+#include "port/gym.h"
+#include "port/netplay/netplay.h"
 #include "port/resources.h"
+#include "port/run_ahead.h"
+#include "port/startup.h"
+#include "port/state_hash.h"
+#include "port/texture_cache.h"
 
 #if defined(_WIN32)
 #include <windef.h> // including windows.h causes conflicts with the Polygon struct, so I just included the header where AllocConsole is and the Windows-specific typedefs that it requires.
@@ -57,6 +69,7 @@ static bool is_running_resource_flow = false;
 static void game_init();
 static void game_step_0();
 static void game_step_1();
+static void resimulate_frame();
 static void init_windows_console();
 
 void distributeScratchPadAddress();
@@ -105,10 +118,14 @@ static void step_0() {
     if (!is_game_initialized) {
         game_init();
         is_game_initialized = true;
+        Batch_RunWorkers();
     }
 
     if (is_game_initialized) {
         game_step_0();
+
+        // The first frame has made the loads the prefetch was for, see game_init
+        AFS_FinishPrefetch();
     }
 }
 
@@ -118,26 +135,72 @@ static void step_1() {
     }
 
     game_step_1();
+    StateHash_EndFrame();
+}
+
+#if defined(SF3SX_GYM)
+
+void main_run_gym_frame() {
+    // Events are drained only so the OS sees the hidden window respond
+    SDLApp_PollEvents();
+    step_0();
+    SDLApp_EndUndrawnFrame();
+    step_1();
 }
 
-int main() {
+#else
+
+int main(int argc, char* argv[]) {
     bool is_running = true;
+    int exit_code = 0;
 
     init_windows_console();
+
+#if defined(SF3SX_BENCH)
+    if (!Bench_Init(argc, argv)) {
+        return 1;
+    }
+#elif defined(SF3SX_BATCH)
+    if (!Batch_Init(argc, argv)) {
+        return 1;
+    }
+#endif
+
     SDLApp_Init();
 
     while (is_running) {
+        Bench_BeginFrame();
         is_running = SDLApp_PollEvents();
+
+        if (!Netplay_BeginFrame(resimulate_frame)) {
+            continue;
+        }
+
         SDLApp_BeginFrame();
+        Bench_Mark(BENCH_PHASE_EVENTS);
+        RunAhead_BeginFrame();
         step_0();
+        RunAhead_EndFrame(game_step_1, game_step_0);
+        Bench_Mark(BENCH_PHASE_AHEAD);
         SDLApp_EndFrame();
+        Bench_Mark(BENCH_PHASE_PRESENT);
         step_1();
+        Bench_Mark(BENCH_PHASE_VBLANK);
+        is_running = Bench_EndFrame() && is_running;
     }
 
+#if defined(SF3SX_BENCH)
+    exit_code = Bench_Quit();
+#elif defined(SF3SX_BATCH)
+    Batch_Quit();
+#endif
+
     SDLApp_Quit();
-    return 0;
+    return exit_code;
 }
 
+#endif
+
 bool get_game_initialized() {
     return is_game_initialized;
 }
@@ -155,7 +218,25 @@ static void init_windows_console() {
 #endif
 }
 
+/// @brief Start reading what njUserInit and the first frame of Init_Task load, so the reads overlap
+/// the renderer setup, the tables and the memory card init.
+static void start_prefetch() {
+    const int files[] = {
+        get_color_file_apfn(109), // Sound bank, sndInitialLoad
+        get_color_file_apfn(0x9C), // Init_load_on_memory_data
+        get_color_file_apfn(0x9D),
+        get_color_file_apfn(0x14),
+        texgrpdat[obj_group_table[0x72A0]].apfn,
+        texgrpdat[obj_group_table[0x7F30]].apfn,
+    };
+
+    AFS_StartPrefetch(files, sizeof(files) / sizeof(files[0]));
+}
+
 static void game_init() {
+    Startup_Begin();
+    start_prefetch();
+    Startup_BeginPhase("renderer");
     flInitialize(flPs2State.DispWidth, flPs2State.DispHeight);
     flSetRenderState(FLRENDER_BACKCOLOR, 0);
     flSetDebugMode(0);
@@ -164,10 +245,13 @@ static void game_init() {
     distributeScratchPadAddress();
     njdp2d_init();
     njUserInit();
+    Startup_BeginPhase("tables");
     palCreateGhost();
     ppgMakeConvTableTexDC();
     appSetupBasePriority();
+    Startup_BeginPhase("memory card");
     MemcardInit();
+    Startup_Finish();
 }
 
 static void game_step_0() {
@@ -196,6 +280,10 @@ static void game_step_0() {
 
     flPADGetALL();
     keyConvert();
+#if defined(SF3SX_GYM)
+    Gym_ProcessSwitches();
+#endif
+    Bench_Mark(BENCH_PHASE_INPUT);
 
     if (((Usage == 7) || (Usage == 2)) && !test_flag) {
         if (mpp_w.sysStop) {
@@ -273,6 +361,7 @@ static void game_step_0() {
     mpp_w.inGame = 0;
 
     njUserMain();
+    Bench_Mark(BENCH_PHASE_GAME);
     MaskScreenEdge();
     seqsBeforeProcess();
     njdp2d_draw();
@@ -308,6 +397,13 @@ static void game_step_0() {
     flSetDebugMode(sysinfodisp);
     disp_effect_work();
     flFlip(0);
+    Bench_Mark(BENCH_PHASE_DRAW);
+}
+
+/// @brief Run a frame again after a netplay rollback, without presenting it.
+static void resimulate_frame() {
+    game_step_0();
+    game_step_1();
 }
 
 static void game_step_1() {
@@ -405,11 +501,12 @@ void njUserInit() {
     mpp_w.vprm.fa = 1.0f;
     appViewSetItems(&mpp_w.vprm);
     appViewMatrix();
+    Startup_BeginPhase("memory");
     mmSystemInitialize();
     flGetFrame(&mpp_w.fmsFrame);
     seqsInitialize(mppMalloc(seqsGetUseMemorySize()));
-    ppg_Initialize(mppMalloc(0x60000), 0x60000);
-    zlib_Initialize(mppMalloc(0x10000), 0x10000);
+    ppg_Initialize(mppMalloc(Arena_GetSize(ARENA_PPG)), Arena_GetSize(ARENA_PPG));
+    zlib_Initialize(mppMalloc(Arena_GetSize(ARENA_ZLIB)), Arena_GetSize(ARENA_ZLIB));
     size = flGetSpace();
     mpp_w.ramcntBuff = mppMalloc(size);
     Init_ram_control_work(mpp_w.ramcntBuff, size);
@@ -449,10 +546,16 @@ void njUserInit() {
     sys_w.pause = 0;
     sys_w.reset = 0;
 
+    Startup_BeginPhase("sound system");
     Init_sound_system();
     Init_bgm_work();
+    Startup_BeginPhase("afs index");
     Setup_Directory_Record_Data();
+    Startup_BeginPhase("texture cache");
+    TextureCache_Open();
+    Startup_BeginPhase("sound banks");
     sndInitialLoad();
+    Startup_BeginPhase("tasks");
     cpInitTask();
     cpReadyTask(INIT_TASK_NUM, Init_Task);
 }
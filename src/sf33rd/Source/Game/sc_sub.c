@@ -28,13 +28,6 @@
 #define TO_UV_128(val) ((val) / 128.0f)
 #endif
 
-typedef struct {
-    // total size: 0x6
-    s16 fade;      // offset 0x0, size 0x2
-    s16 fade_kind; // offset 0x2, size 0x2
-    u8 fade_prio;  // offset 0x4, size 0x1
-} FadeData;
-
 typedef struct {
     // total size: 0x4
     u8 atr;  // offset 0x0, size 0x1
@@ -13,8 +13,8 @@ s16 roll_rate2;
 s16 roll_rate_t2;
 s16 roll_stop;
 s16 name_timer;
-static s32 staffroll_end;
-static s16 name_ptr;
+s32 staffroll_end;
+s16 staff_name_ptr;
 
 static const struct {
     s16 next;
@@ -335,7 +335,7 @@ s32 staff_credits(u32 /* unused */) {
         Family_Set_R(6, x, y);
         roll_rate2 = 1;
         roll_stop = 0;
-        name_ptr = 0;
+        staff_name_ptr = 0;
         end_w.timer = 0;
         name_timer = 0;
         break;
@@ -351,47 +351,47 @@ s32 staff_credits(u32 /* unused */) {
         if (end_w.timer >= 0) {
             end_w.timer = end_w.timer - roll_rate_t2;
         } else {
-            if (sf3_staff[name_ptr].name == NULL) {
+            if (sf3_staff[staff_name_ptr].name == NULL) {
                 staff_r_no = 3;
-                end_w.timer = sf3_staff[name_ptr].next;
+                end_w.timer = sf3_staff[staff_name_ptr].next;
                 SsBgmFadeOut(0x88);
                 break;
             }
 
-            if (*sf3_staff[name_ptr].name == 0x3F) {
+            if (*sf3_staff[staff_name_ptr].name == 0x3F) {
                 SsBgmFadeOut(0x4E);
             }
 
-            if (*sf3_staff[name_ptr].name == 0x60) {
+            if (*sf3_staff[staff_name_ptr].name == 0x60) {
                 BGM_Request(0x40);
             }
 
             name_timer = 0x7FFF;
             t = 240;
-            x = sf3_staff[name_ptr].x;
-            y = sf3_staff[name_ptr].y;
-            a = sf3_staff[name_ptr].atr;
-            set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-            end_w.timer = sf3_staff[name_ptr].next;
-            name_ptr++;
+            x = sf3_staff[staff_name_ptr].x;
+            y = sf3_staff[staff_name_ptr].y;
+            a = sf3_staff[staff_name_ptr].atr;
+            set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+            end_w.timer = sf3_staff[staff_name_ptr].next;
+            staff_name_ptr++;
 
             if (0 >= end_w.timer) {
                 t = 240;
-                x = sf3_staff[name_ptr].x;
-                y = sf3_staff[name_ptr].y;
-                a = sf3_staff[name_ptr].atr;
-                set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-                end_w.timer = sf3_staff[name_ptr].next;
-                name_ptr++;
+                x = sf3_staff[staff_name_ptr].x;
+                y = sf3_staff[staff_name_ptr].y;
+                a = sf3_staff[staff_name_ptr].atr;
+                set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+                end_w.timer = sf3_staff[staff_name_ptr].next;
+                staff_name_ptr++;
 
                 if (0 >= end_w.timer) {
                     t = 240;
-                    x = sf3_staff[name_ptr].x;
-                    y = sf3_staff[name_ptr].y;
-                    a = sf3_staff[name_ptr].atr;
-                    set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
+                    x = sf3_staff[staff_name_ptr].x;
+                    y = sf3_staff[staff_name_ptr].y;
+                    a = sf3_staff[staff_name_ptr].atr;
+                    set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
                     end_w.timer = 0xF0;
-                    name_ptr++;
+                    staff_name_ptr++;
                 }
             }
         }
@@ -401,75 +401,75 @@ s32 staff_credits(u32 /* unused */) {
             break;
         }
 
-        name_timer = sf3_staff[name_ptr].next;
+        name_timer = sf3_staff[staff_name_ptr].next;
         t = 20;
-        x = sf3_staff[name_ptr].x;
-        y = sf3_staff[name_ptr].y;
-        a = sf3_staff[name_ptr].atr;
-        set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-        name_ptr++;
+        x = sf3_staff[staff_name_ptr].x;
+        y = sf3_staff[staff_name_ptr].y;
+        a = sf3_staff[staff_name_ptr].atr;
+        set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+        staff_name_ptr++;
         t = 20;
-        x = sf3_staff[name_ptr].x;
-        y = sf3_staff[name_ptr].y;
-        a = sf3_staff[name_ptr].atr;
-        set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-        name_ptr++;
+        x = sf3_staff[staff_name_ptr].x;
+        y = sf3_staff[staff_name_ptr].y;
+        a = sf3_staff[staff_name_ptr].atr;
+        set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+        staff_name_ptr++;
 
-        if (sf3_staff[name_ptr].next == 0) {
+        if (sf3_staff[staff_name_ptr].next == 0) {
             t = 20;
-            x = sf3_staff[name_ptr].x;
-            y = sf3_staff[name_ptr].y;
-            a = sf3_staff[name_ptr].atr;
-            set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-            name_ptr++;
+            x = sf3_staff[staff_name_ptr].x;
+            y = sf3_staff[staff_name_ptr].y;
+            a = sf3_staff[staff_name_ptr].atr;
+            set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+            staff_name_ptr++;
             t = 20;
-            x = sf3_staff[name_ptr].x;
-            y = sf3_staff[name_ptr].y;
-            a = sf3_staff[name_ptr].atr;
-            set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-            name_ptr++;
+            x = sf3_staff[staff_name_ptr].x;
+            y = sf3_staff[staff_name_ptr].y;
+            a = sf3_staff[staff_name_ptr].atr;
+            set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+            staff_name_ptr++;
 
-            if (sf3_staff[name_ptr].next == 0) {
+            if (sf3_staff[staff_name_ptr].next == 0) {
                 t = 20;
-                x = sf3_staff[name_ptr].x;
-                y = sf3_staff[name_ptr].y;
-                a = sf3_staff[name_ptr].atr;
-                set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-                name_ptr++;
+                x = sf3_staff[staff_name_ptr].x;
+                y = sf3_staff[staff_name_ptr].y;
+                a = sf3_staff[staff_name_ptr].atr;
+                set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+                staff_name_ptr++;
                 t = 20;
-                x = sf3_staff[name_ptr].x;
-                y = sf3_staff[name_ptr].y;
-                a = sf3_staff[name_ptr].atr;
-                set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-                name_ptr++;
+                x = sf3_staff[staff_name_ptr].x;
+                y = sf3_staff[staff_name_ptr].y;
+                a = sf3_staff[staff_name_ptr].atr;
+                set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+                staff_name_ptr++;
 
-                if (sf3_staff[name_ptr].next == 0) {
+                if (sf3_staff[staff_name_ptr].next == 0) {
                     t = 20;
-                    x = sf3_staff[name_ptr].x;
-                    y = sf3_staff[name_ptr].y;
-                    a = sf3_staff[name_ptr].atr;
-                    set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-                    name_ptr++;
+                    x = sf3_staff[staff_name_ptr].x;
+                    y = sf3_staff[staff_name_ptr].y;
+                    a = sf3_staff[staff_name_ptr].atr;
+                    set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+                    staff_name_ptr++;
                     t = 20;
-                    x = sf3_staff[name_ptr].x;
-                    y = sf3_staff[name_ptr].y;
-                    a = sf3_staff[name_ptr].atr;
-                    set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-                    name_ptr++;
+                    x = sf3_staff[staff_name_ptr].x;
+                    y = sf3_staff[staff_name_ptr].y;
+                    a = sf3_staff[staff_name_ptr].atr;
+                    set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+                    staff_name_ptr++;
 
-                    if (sf3_staff[name_ptr].next == 0) {
+                    if (sf3_staff[staff_name_ptr].next == 0) {
                         t = 20;
-                        x = sf3_staff[name_ptr].x;
-                        y = sf3_staff[name_ptr].y;
-                        a = sf3_staff[name_ptr].atr;
-                        set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-                        name_ptr++;
+                        x = sf3_staff[staff_name_ptr].x;
+                        y = sf3_staff[staff_name_ptr].y;
+                        a = sf3_staff[staff_name_ptr].atr;
+                        set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+                        staff_name_ptr++;
                         t = 20;
-                        x = sf3_staff[name_ptr].x;
-                        y = sf3_staff[name_ptr].y;
-                        a = sf3_staff[name_ptr].atr;
-                        set_credit_string(t, x, y, a, sf3_staff[name_ptr].name);
-                        name_ptr++;
+                        x = sf3_staff[staff_name_ptr].x;
+                        y = sf3_staff[staff_name_ptr].y;
+                        a = sf3_staff[staff_name_ptr].atr;
+                        set_credit_string(t, x, y, a, sf3_staff[staff_name_ptr].name);
+                        staff_name_ptr++;
                     }
                 }
             }
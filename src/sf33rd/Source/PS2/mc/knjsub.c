@@ -397,6 +397,10 @@ void KnjInit(u32 type, uintptr_t adrs, u32 disp_max, u32 top_dbp) {
     kw->bg_mode = 1;
     kw->bg_color = 0x80000000;
     knj_use_flag = 1;
+
+#if !defined(TARGET_PS2)
+    SDLMessageRenderer_ResetGlyphs();
+#endif
 }
 
 void KnjFinish() {
@@ -513,6 +517,9 @@ void KnjPuts(const s8* str) {
 
         if (index < kw->fmax) {
             if (kw->dcur < kw->dmax) {
+#if !defined(TARGET_PS2)
+                SDLMessageRenderer_SetGlyph(index);
+#endif
                 img = get_img_adrs(kw, index);
                 pp = make_fnt_pkt(kw, pp, img, han_f);
                 kw->dcur += 1;
@@ -946,12 +953,18 @@ static void unicode_puts(_kanji_w* kw, const s8* str) {
             if (kw->uni_ascii == 0) {
                 if (code < 0x10) {
                     han_f = 0;
+#if !defined(TARGET_PS2)
+                    SDLMessageRenderer_SetGlyph(code | 0x80000000);
+#endif
                     img = get_uni_adrs2(kw, code);
                     goto block_14;
                 }
 
                 if (code < 0x80) {
                     han_f = 1;
+#if !defined(TARGET_PS2)
+                    SDLMessageRenderer_SetGlyph(code | 0x80000000);
+#endif
                     img = get_uni_adrs2(kw, code);
                     goto block_14;
                 }
@@ -962,6 +975,9 @@ static void unicode_puts(_kanji_w* kw, const s8* str) {
 
             if (index < kw->fmax) {
                 if (kw->dcur < kw->dmax) {
+#if !defined(TARGET_PS2)
+                    SDLMessageRenderer_SetGlyph(index);
+#endif
                     img = get_uni_adrs(kw, index);
                 block_14:
                     pp = make_fnt_pkt(kw, pp, img, han_f);
@@ -1119,7 +1135,10 @@ static u32* make_img_pkt(u32* p, u32* img, u32 dbp, u32 dbw, u32 dbsm, u32 dsax,
     }
 
 #if !defined(TARGET_PS2)
-    SDLMessageRenderer_CreateTexture(rrw, rrh, img, dbsm);
+    // Palette uploads are not needed, the message renderer has its own palette
+    if (dbsm == SCE_GS_PSMT4) {
+        SDLMessageRenderer_UploadGlyph(rrw, rrh, img);
+    }
 #else
     nw = rrw * rrh * pw / 32;
 
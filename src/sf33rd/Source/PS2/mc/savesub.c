@@ -5,6 +5,7 @@
 #include "sf33rd/Source/Game/RAMCNT.h"
 
 #if !defined(TARGET_PS2)
+#include "port/afs.h"
 #include "sf33rd/Source/Game/SYS_sub.h"
 #include "sf33rd/Source/Game/SYS_sub2.h"
 #endif
@@ -88,6 +89,7 @@ static s32 info_data_check(_save_work* save);
 static s32 yes_no_check(_save_work* save);
 
 static void load_data(s32 fnum, void* adrs) {
+#if defined(TARGET_PS2)
     s32 nsct;
     _save_work* save = &SaveWork;
 
@@ -104,6 +106,14 @@ static void load_data(s32 fnum, void* adrs) {
     nsct = ADXF_GetFsizeSct(save->adxf);
     printf("load_data: fnum=%d adrs=0x%" PRIXPTR " size=0x%X\n", fnum, (uintptr_t)adrs, nsct << 11);
     ADXF_ReadNw(save->adxf, nsct, adrs);
+#else
+    // Read straight from the archive. The load is over before load_busy_ck is asked about it
+    const size_t size = AFS_GetFileSize(fnum);
+
+    if ((size == 0) || (AFS_ReadFile(fnum, 0, adrs, size) != size)) {
+        fatal_error("Couldn't load file %d from SF33RD.AFS", fnum);
+    }
+#endif
 }
 
 static s32 load_busy_ck() {
@@ -189,6 +199,11 @@ s32 SaveMove() {
     return save->return_code;
 }
 
+/// @brief Whether a save screen was started with `SaveInit` and `SaveMove` hasn't finished it yet.
+s32 SaveIsOpen() {
+    return SaveWork.return_code > 0;
+}
+
 static void save_sw_get(_save_work* save) {
     u16 i;
     u16 sw;
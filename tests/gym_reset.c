@@ -0,0 +1,94 @@
+#include "port/gym.h"
+#include "port/resources.h"
+
+#include <stdio.h>
+
+// Gym reset test.
+//
+// Starts a round, lets the CPU beat a player 2 that stands still until the round is over and starts
+// another round from there, the way a training loop goes from one episode to the next. Needs the
+// game resources and is skipped without them.
+//
+// The KO has to come before the round timer runs out, so a round that ends on time, or a timer that
+// never starts, fails instead of passing as a win. The frame count of the KO is printed so a change
+// in how fast the CPU wins shows up in the test log.
+
+#define SKIP_CODE 77
+#define CHAR_P1 11 // Ken
+#define CHAR_P2 2  // Ryu
+#define STAGE 5
+#define TIMER_FRAMES 60                          // Frames per count of the round timer, see count.c
+#define ROUND_FRAMES_MAX (99 * TIMER_FRAMES * 2) // Twice the longest timer, it stops during freezes
+
+static bool check_new_round(const GymObservation* obs) {
+    if (obs->done || (obs->frame != 0) || (obs->winner != -1)) {
+        printf("Reset didn't start a new round: frame %u, done %d, winner %d\n", obs->frame, obs->done, obs->winner);
+        return false;
+    }
+
+    if (obs->timer <= 0) {
+        printf("The round starts with timer %d\n", obs->timer);
+        return false;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        if (obs->players[i].vitality <= 0) {
+            printf("Player %d starts the round with vitality %d\n", i + 1, obs->players[i].vitality);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool play_to_ko(GymObservation* obs) {
+    const int16_t start_timer = obs->timer;
+
+    while (!obs->done) {
+        if (obs->frame == ROUND_FRAMES_MAX) {
+            printf("The round didn't end in %d frames\n", ROUND_FRAMES_MAX);
+            return false;
+        }
+
+        if (!Gym_Step(GYM_INPUT_CPU, 0, obs)) {
+            return false;
+        }
+    }
+
+    if ((obs->winner != 0) || (obs->players[1].vitality > 0)) {
+        printf("Expected player 1 to win by KO: winner %d, player 2 vitality %d\n",
+               obs->winner,
+               obs->players[1].vitality);
+        return false;
+    }
+
+    if (obs->timer <= 0) {
+        printf("The round ended on time after %u frames, not by KO\n", obs->frame);
+        return false;
+    }
+
+    if (obs->timer == start_timer) {
+        printf("The round timer didn't run: %d after %u frames\n", obs->timer, obs->frame);
+        return false;
+    }
+
+    printf("KO after %u frames, %d of %d left on the timer\n", obs->frame, obs->timer, start_timer);
+    return true;
+}
+
+int main() {
+    GymObservation obs;
+    bool is_passed = false;
+
+    if (!Resources_CheckIfPresent()) {
+        printf("Game resources are missing, skipping\n");
+        return SKIP_CODE;
+    }
+
+    is_passed = Gym_Reset(CHAR_P1, CHAR_P2, STAGE, 1, &obs) && check_new_round(&obs) && play_to_ko(&obs) &&
+                Gym_Reset(CHAR_P1, CHAR_P2, STAGE, 2, &obs) && check_new_round(&obs);
+
+    Gym_Close();
+    printf("%s\n", is_passed ? "PASS" : "FAIL");
+    return is_passed ? 0 : 1;
+}